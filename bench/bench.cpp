@@ -0,0 +1,280 @@
+#include "bench.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+namespace kt::bench {
+namespace {
+using clock = std::chrono::steady_clock;
+
+auto elapsed_ns(clock::time_point _since) -> double
+  {
+    return std::chrono::duration<double, std::nano>(clock::now() - _since).count();
+  }
+auto time_batch(const body& _body, std::size_t _n) -> double
+  {
+    auto start = clock::now();
+    for(std::size_t i = 0; i < _n; ++i)
+    {
+      _body();
+    }
+    return elapsed_ns(start);
+  }
+// nearest rank, on sorted samples
+auto percentile(const std::vector<double>& _sorted, double _p) -> double
+  {
+    auto rank = std::size_t(std::ceil(_p * double(_sorted.size())));
+    return _sorted[std::clamp<std::size_t>(rank, 1, _sorted.size()) - 1];
+  }
+auto median(const std::vector<double>& _sorted) -> double
+  {
+    auto n = _sorted.size();
+    return n % 2? _sorted[n / 2] : (_sorted[n / 2 - 1] + _sorted[n / 2]) / 2.0;
+  }
+auto quoted(const std::string& _s) -> std::string
+  {
+    std::string result = "\"";
+    for(auto ch : _s)
+    {
+      if(ch == '"' || ch == '\\')
+      {
+        result += '\\';
+        result += ch;
+      }
+      else if(static_cast<unsigned char>(ch) < 0x20)
+      {
+        char code[8];
+        std::snprintf(code, sizeof(code), "\\u%04x", ch);
+        result += code;
+      }
+      else
+      {
+        result += ch;
+      }
+    }
+    return result + '"';
+  }
+auto pretty_ns(double _ns) -> std::string
+  {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1);
+    if(_ns < 1e3)       out << _ns << " ns";
+    else if(_ns < 1e6)  out << _ns / 1e3 << " us";
+    else                out << _ns / 1e6 << " ms";
+    return out.str();
+  }
+} /* namespace */
+auto key(const std::string& _name, std::size_t _size) -> std::string
+  {
+    return _name + '/' + std::to_string(_size);
+  }
+auto suite::add(std::string _name, std::size_t _size, fixture _fixture) -> void
+  {
+    entries_.push_back(entry { std::move(_name), _size, std::move(_fixture) });
+  }
+auto suite::list(std::ostream& _out) const -> void
+  {
+    for(const auto& e : entries_)
+    {
+      _out << key(e.name, e.size) << "\n";
+    }
+  }
+auto suite::run(const settings& _s, std::ostream& _progress) const -> std::vector<result>
+  {
+    std::vector<result> results;
+    auto flags        = _progress.flags();
+    auto min_batch_ns = _s.min_batch_ms * 1e6;
+    auto repetitions  = std::max<std::size_t>(1, _s.repetitions);
+    for(const auto& e : entries_)
+    {
+      auto name = key(e.name, e.size);
+      if(!_s.filter.empty() && name.find(_s.filter) == std::string::npos)
+      {
+        continue;
+      }
+      auto fn = e.setup();
+      // double the batch until it is long enough to time reliably
+      std::size_t batch = 1;
+      auto took = time_batch(fn, batch);
+      while(took < min_batch_ns && batch < (std::size_t(1) << 30))
+      {
+        batch = took <= 0.0? batch * 2 : std::max(batch * 2, std::min(batch * 10, std::size_t(double(batch) * min_batch_ns / took) + 1));
+        took  = time_batch(fn, batch);
+      }
+      for(std::size_t i = 0; i < _s.warmup; ++i)
+      {
+        time_batch(fn, batch);
+      }
+      std::vector<double> samples;
+      samples.reserve(repetitions);
+      for(std::size_t i = 0; i < repetitions; ++i)
+      {
+        samples.push_back(time_batch(fn, batch) / double(batch));
+      }
+      std::sort(samples.begin(), samples.end());
+      result r;
+      r.name      = e.name;
+      r.size      = e.size;
+      r.batch     = batch;
+      r.median_ns = median(samples);
+      r.p99_ns    = percentile(samples, 0.99);
+      r.min_ns    = samples.front();
+      for(auto t : samples)
+      {
+        r.mean_ns += t / double(samples.size());
+      }
+      _progress << std::left << std::setw(32) << name
+                << " median " << std::setw(12) << pretty_ns(r.median_ns)
+                << " p99 " << std::setw(12) << pretty_ns(r.p99_ns)
+                << " (" << batch << " calls x " << repetitions << ")\n" << std::flush;
+      results.push_back(std::move(r));
+    }
+    _progress.flags(flags);
+    return results;
+  }
+auto write_json(std::ostream& _out, const std::vector<result>& _results, const std::map<std::string, std::string>& _context) -> void
+  {
+    _out << "{\n  \"context\": {";
+    auto first = true;
+    for(const auto& [name, value] : _context)
+    {
+      _out << (first? "\n" : ",\n") << "    " << quoted(name) << ": " << quoted(value);
+      first = false;
+    }
+    _out << (first? "},\n" : "\n  },\n") << "  \"benchmarks\": [";
+    first = true;
+    auto precision = _out.precision(6);
+    for(const auto& r : _results)
+    {
+      _out << (first? "\n" : ",\n")
+           << "    { \"name\": "    << quoted(r.name)
+           << ", \"size\": "        << r.size
+           << ", \"batch\": "       << r.batch
+           << ", \"median_ns\": "   << r.median_ns
+           << ", \"p99_ns\": "      << r.p99_ns
+           << ", \"min_ns\": "      << r.min_ns
+           << ", \"mean_ns\": "     << r.mean_ns
+           << " }";
+      first = false;
+    }
+    _out << (first? "]\n}\n" : "\n  ]\n}\n");
+    _out.precision(precision);
+  }
+auto read_baseline(const std::string& _path) -> baseline
+  {
+    auto file = std::ifstream(_path);
+    if(!file)
+    {
+      throw std::runtime_error("could not open baseline \"" + _path + "\"");
+    }
+    auto text = std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    // only the flat objects in "benchmarks" matter: remember the last name,
+    // size and median seen, and file them when their object closes
+    baseline results;
+    std::string last_key, name;
+    std::size_t size    = 0;
+    double      median  = -1.0;
+    auto        pos     = text.find("\"benchmarks\"");
+    if(pos == std::string::npos)
+    {
+      throw std::runtime_error("\"" + _path + "\" is not a benchmark report");
+    }
+    auto read_string = [&]
+      {
+        std::string s;
+        for(++pos; pos < text.size() && text[pos] != '"'; ++pos)
+        {
+          if(text[pos] == '\\' && pos + 1 < text.size())
+          {
+            ++pos;
+          }
+          s += text[pos];
+        }
+        ++pos;
+        return s;
+      };
+    for(pos += 12; pos < text.size(); )
+    {
+      auto ch = text[pos];
+      if(ch == '"')
+      {
+        auto s = read_string();
+        auto colon = text.find_first_not_of(" \t\r\n", pos);
+        if(colon != std::string::npos && text[colon] == ':')
+        {
+          last_key = s;
+          pos = colon + 1;
+        }
+        else if(last_key == "name")
+        {
+          name = s;
+        }
+      }
+      else if(ch == '-' || (ch >= '0' && ch <= '9'))
+      {
+        std::size_t used = 0;
+        auto value = std::stod(text.substr(pos, 32), &used);
+        if(last_key == "size")
+        {
+          size = std::size_t(value);
+        }
+        else if(last_key == "median_ns")
+        {
+          median = value;
+        }
+        pos += std::max<std::size_t>(used, 1);
+      }
+      else if(ch == '}')
+      {
+        if(!name.empty() && median >= 0.0)
+        {
+          results[key(name, size)] = median;
+        }
+        name.clear();
+        size   = 0;
+        median = -1.0;
+        ++pos;
+      }
+      else
+      {
+        ++pos;
+      }
+    }
+    return results;
+  }
+auto compare(std::ostream& _out, const std::vector<result>& _results, const baseline& _base, double _threshold) -> std::size_t
+  {
+    std::size_t regressions = 0;
+    auto flags      = _out.flags();
+    auto precision  = _out.precision();
+    for(const auto& r : _results)
+    {
+      auto name = key(r.name, r.size);
+      auto it   = _base.find(name);
+      _out << std::left << std::setw(32) << name << " ";
+      if(it == _base.end() || it->second <= 0.0)
+      {
+        _out << "new\n";
+        continue;
+      }
+      auto change = r.median_ns / it->second - 1.0;
+      _out << std::setw(12) << pretty_ns(it->second) << " -> " << std::setw(12) << pretty_ns(r.median_ns)
+           << std::showpos << std::fixed << std::setprecision(1) << change * 100.0 << "%" << std::noshowpos;
+      if(change > _threshold)
+      {
+        _out << "  REGRESSION";
+        ++regressions;
+      }
+      _out << "\n";
+    }
+    _out.flags(flags);
+    _out.precision(precision);
+    return regressions;
+  }
+} /* namespace kt::bench */
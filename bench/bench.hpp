@@ -0,0 +1,90 @@
+#ifndef bench_hpp_20211110_091244_PDT
+#define bench_hpp_20211110_091244_PDT
+#include <cstddef>
+#include <functional>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+/*****************************************************************************
+ * microbenchmark harness
+ *
+ * A fixture is set up once per run and hands back the body to time.  Each
+ * body is run in batches sized so one batch takes at least `min_batch_ms`;
+ * after `warmup` untimed batches, `repetitions` timed batches give the
+ * per-call samples the median and 99th percentile are taken from.
+ * Reports are JSON, and a report saved earlier can be read back as the
+ * baseline later runs are compared against.
+ ****************************************************************************/
+namespace kt::bench {
+
+/*! \brief  Keep the compiler from optimising away a value nothing reads. */
+template<typename T>
+  inline auto keep(const T& _value) -> void
+  {
+    asm volatile("" : : "r"(&_value) : "memory");
+  }
+
+using body    = std::function<void()>;
+using fixture = std::function<body()>;    //!< Sets up, returns what to time.
+
+struct settings
+{
+  std::size_t   warmup        = 3;
+  std::size_t   repetitions   = 30;
+  double        min_batch_ms  = 2.0;
+  std::string   filter;                   //!< Run only names containing this.
+};
+struct result
+{
+  std::string   name;
+  std::size_t   size        = 0;          //!< Input size the fixture was given.
+  std::size_t   batch       = 0;          //!< Calls per sample.
+  double        median_ns   = 0.0;        //!< Per call.
+  double        p99_ns      = 0.0;
+  double        min_ns      = 0.0;
+  double        mean_ns     = 0.0;
+};
+/*! \brief  Medians from an earlier report, by `key(name, size)`. */
+using baseline = std::map<std::string, double>;
+
+auto key(const std::string& _name, std::size_t _size) -> std::string;
+
+class suite final
+{
+public:
+  /*! \brief  Register `_fixture` as `_name` at input size `_size`.  Fixtures
+   *          run in the order they're added.
+   */
+  auto add(std::string _name, std::size_t _size, fixture _fixture) -> void;
+  auto list(std::ostream& _out) const -> void;
+  /*! \brief  Run every fixture `_s.filter` selects, printing a line for each
+   *          to `_progress` as it finishes.
+   */
+  auto run(const settings& _s, std::ostream& _progress) const -> std::vector<result>;
+private:
+  struct entry
+  {
+    std::string   name;
+    std::size_t   size;
+    fixture       setup;
+  };
+  std::vector<entry>  entries_;
+};
+
+/*! \brief  Write `_results` as a JSON report; `_context` becomes the report's
+ *          `context` object, for whatever the numbers depend on.
+ */
+auto write_json(std::ostream& _out, const std::vector<result>& _results, const std::map<std::string, std::string>& _context) -> void;
+/*! \brief  Read the medians back from a report `write_json` wrote.
+ *  \throw  std::runtime_error if it can't be opened or isn't one.
+ */
+auto read_baseline(const std::string& _path) -> baseline;
+/*! \brief  Print each result against its baseline median, marking those more
+ *          than `_threshold` (a fraction: 0.1 is 10%) slower.
+ *  \return The number of regressions.
+ */
+auto compare(std::ostream& _out, const std::vector<result>& _results, const baseline& _base, double _threshold) -> std::size_t;
+
+} /* namespace kt::bench */
+#endif//bench_hpp_20211110_091244_PDT
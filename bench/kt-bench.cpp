@@ -0,0 +1,256 @@
+#include "bench.hpp"
+#include <kt/options.hpp>
+#include <kt/string/concat.hpp>
+#include <kt/string/pad.hpp>
+#include <kt/string/wrap.hpp>
+#include <kt/terminal.hpp>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+namespace po = kt::program_option;
+namespace kb = kt::bench;
+
+namespace {
+#if defined(NDEBUG)
+constexpr auto assertions = "off";
+#else
+constexpr auto assertions = "on";
+#endif
+// a command line of `_n` arguments after the program name, mixing every
+// form `parse` handles
+auto make_command_line(std::size_t _n) -> std::vector<std::string>
+  {
+    std::vector<std::string> args { "kt-bench" };
+    for(std::size_t i = 0; i < _n; ++i)
+    {
+      switch(i % 4)
+      {
+        case 0:   args.push_back("--option-" + std::to_string(i) + "=value-" + std::to_string(i)); break;
+        case 1:   args.push_back("-abc");                                                           break;
+        case 2:   args.push_back("--flag-" + std::to_string(i));                                    break;
+        default:  args.push_back("positional-" + std::to_string(i));                                break;
+      }
+    }
+    return args;
+  }
+// `_n` options, each taking an int, with help text long enough to wrap
+auto make_table(std::size_t _n, std::shared_ptr<std::vector<std::string>> _keys) -> po::table
+  {
+    _keys->clear();
+    _keys->reserve(_n);
+    po::table opts { po::heading("Options:") };
+    for(std::size_t i = 0; i < _n; ++i)
+    {
+      _keys->push_back("option-" + std::to_string(i));
+      opts.push_back(po::option(_keys->back(), 0, "Sets the value of this option, which is used for nothing at all "
+                                                   "but is described at some length so help output has to wrap it.",
+                                po::for_type<int>([](const auto&) {})));
+    }
+    return opts;
+  }
+// words of one to nine letters, separated by spaces
+auto make_text(std::size_t _n) -> std::string
+  {
+    std::string text;
+    text.reserve(_n);
+    for(std::size_t word = 0; text.size() < _n; ++word)
+    {
+      text.append(1 + (word * 7) % 9, char('a' + word % 26));
+      text += ' ';
+    }
+    text.resize(_n);
+    return text;
+  }
+auto add_options_fixtures(kb::suite& _s) -> void
+  {
+    for(std::size_t n : { 4, 32, 256 })
+    {
+      _s.add("parse", n, [n]
+        {
+          auto args = std::make_shared<std::vector<std::string>>(make_command_line(n));
+          auto argv = std::make_shared<std::vector<char*>>();
+          for(auto& a : *args)
+          {
+            argv->push_back(a.data());
+          }
+          return [args, argv]
+            {
+              kb::keep(po::parse(int(argv->size()), argv->data()));
+            };
+        });
+    }
+    // sixteen arguments matched against ever bigger tables, spread so the
+    // search goes deeper each time
+    for(std::size_t n : { 8, 64, 512 })
+    {
+      _s.add("scan", n, [n]
+        {
+          auto keys = std::make_shared<std::vector<std::string>>();
+          auto opts = std::make_shared<po::table>(make_table(n, keys));
+          auto args = std::make_shared<po::arg_store>();
+          args->emplace_back(po::key_t {}, "kt-bench");
+          for(std::size_t i = 0; i < 16; ++i)
+          {
+            args->emplace_back((*keys)[(i * n / 16 + n - 1) % n], "42");
+          }
+          return [keys, opts, args]
+            {
+              kb::keep(po::scan(*args, *opts));
+            };
+        });
+    }
+    // the fixture adds `n` variables to whatever the process inherited
+    for(std::size_t n : { 0, 64, 512 })
+    {
+      _s.add("environ", n, [n]
+        {
+          for(std::size_t i = 0; i < n; ++i)
+          {
+            auto name = "KT_BENCH_" + std::to_string(i);
+            setenv(name.c_str(), "some value of moderate length", 1);
+          }
+          return []
+            {
+              kb::keep(po::environ());
+            };
+        });
+    }
+    for(std::size_t n : { 8, 64, 256 })
+    {
+      _s.add("help", n, [n]
+        {
+          auto keys = std::make_shared<std::vector<std::string>>();
+          auto opts = std::make_shared<po::table>(make_table(n, keys));
+          return [keys, opts]
+            {
+              std::ostringstream out;
+              out << *opts;
+              kb::keep(out.str());
+            };
+        });
+    }
+  }
+auto add_string_fixtures(kb::suite& _s) -> void
+  {
+    for(std::size_t n : { 16, 256, 4096 })
+    {
+      _s.add("concat", n, [n]
+        {
+          auto head = std::make_shared<std::string>(n, 'h');
+          auto tail = std::make_shared<std::string>(n, 't');
+          return [head, tail]
+            {
+              kb::keep(kt::concat(*head, 42, ' ', *tail, 3.25));
+            };
+        });
+    }
+    for(std::size_t n : { 256, 4096, 16384 })
+    {
+      _s.add("word_wrap", n, [n]
+        {
+          auto text = std::make_shared<std::string>(make_text(n));
+          return [text]
+            {
+              kb::keep(kt::word_wrap(*text, 40));
+            };
+        });
+    }
+    for(std::size_t n : { 16, 256, 4096 })
+    {
+      _s.add("pad_copy", n, [n]
+        {
+          auto text = std::make_shared<std::string>(n / 2, 'p');
+          return [text, n]
+            {
+              kb::keep(kt::pad_copy(*text, n));
+            };
+        });
+    }
+  }
+} /* namespace */
+
+int main(int argc, char* argv[]) try
+{
+  using namespace std;
+  kb::settings  s;
+  string        json_path, baseline_path;
+  double        threshold = 10.0;
+  auto args = po::parse(argc, argv);
+  auto opts = po::table
+    { po::heading("kt-bench: time the options and string hot paths")
+    , po::option("help",        'h', "Show help.")
+    , po::option("list",        'l', "List the benchmarks and exit.")
+    , po::option("filter",      'f', "Run only benchmarks whose name/size contains this.",     po::value(s.filter))
+    , po::option("repetitions", 'r', "Timed samples per benchmark (default 30).",             po::value(s.repetitions))
+    , po::option("warmup",      'w', "Untimed batches before sampling (default 3).",          po::value(s.warmup))
+    , po::option("min-time",    't', "Shortest batch to time, in milliseconds (default 2).",  po::value(s.min_batch_ms))
+    , po::option("json",        'j', "Write the results as JSON to this file.",               po::value(json_path))
+    , po::option("baseline",    'b', "Compare against a JSON report from an earlier run.",    po::value(baseline_path))
+    , po::option("threshold",   'p', "Percent slower than the baseline that counts as a regression (default 10).", po::value(threshold))
+    };
+  kb::suite suite;
+  add_options_fixtures(suite);
+  add_string_fixtures(suite);
+
+  auto show_help = false;
+  auto show_list = false;
+  po::scan(args, opts, [&]
+      (const auto& jobs)
+      {
+        show_help = po::count(jobs, "help") > 0;
+        show_list = po::count(jobs, "list") > 0;
+        return show_help? 1 : 0;
+      }
+    );
+  if(show_help)
+  {
+    cout << opts << endl;
+    return 0;
+  }
+  if(show_list)
+  {
+    suite.list(cout);
+    return 0;
+  }
+  // a bad baseline or threshold should fail now, not after every timing
+  if(threshold < 0.0)
+  {
+    throw runtime_error(kt::concat("threshold must not be negative, got ", threshold));
+  }
+  auto base    = baseline_path.empty()? kb::baseline {} : kb::read_baseline(baseline_path);
+  auto results = suite.run(s, cout);
+  if(!json_path.empty())
+  {
+    auto file = ofstream(json_path);
+    kb::write_json(file, results,
+      { { "compiler",     __VERSION__ }
+      , { "assertions",   assertions }
+      , { "help_columns", kt::concat(kt::terminal::get_columns()) }
+      , { "repetitions",  kt::concat(s.repetitions) }
+      });
+    if(!file)
+    {
+      throw runtime_error(kt::concat("could not write \"", json_path, "\""));
+    }
+  }
+  if(!baseline_path.empty())
+  {
+    cout << "\n";
+    auto regressions = kb::compare(cout, results, base, threshold / 100.0);
+    if(regressions > 0)
+    {
+      cout << regressions << " regression" << (regressions == 1? "" : "s") << " over " << threshold << "%\n";
+      return 1;
+    }
+  }
+  return 0;
+}
+catch(const std::exception& e)
+{
+  using namespace std;
+  cerr << "Error: " << e.what() << endl;
+  return 2;
+}
@@ -0,0 +1,104 @@
+// Build an asset pack from BMP files, for kt::gfx::AssetPack.
+//
+//   kt-pack [--qoi] [--page=N] [--separate] -o out.ktpk [name=]file.bmp...
+//
+// Each file becomes a region named after the file (without directory or
+// extension) unless a name is given.  Files go onto shared atlas pages of
+// N by N pixels, largest first, unless --separate is given.
+#include <kt/gfx/asset_pack.hpp>
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace gfx = kt::gfx;
+
+auto usage() -> int
+  {
+    std::cerr << "usage: kt-pack [--qoi] [--page=N] [--separate] -o out.ktpk [name=]file.bmp...\n";
+    return 2;
+  }
+
+int main(int argc, char* argv[]) try
+{
+  using namespace std;
+  auto codec    = gfx::AssetPack::codec::raw;
+  auto page     = gfx::AssetPackWriter::default_page_size;
+  auto separate = false;
+  string output;
+  vector<pair<string, string>> inputs;
+  for(int i = 1; i < argc; ++i)
+  {
+    string arg = argv[i];
+    if(arg == "--qoi")
+    {
+      codec = gfx::AssetPack::codec::qoi;
+    }
+    else if(arg.rfind("--page=", 0) == 0)
+    {
+      page = stoi(arg.substr(7));
+    }
+    else if(arg == "--separate")
+    {
+      separate = true;
+    }
+    else if(arg == "-o" && i + 1 < argc)
+    {
+      output = argv[++i];
+    }
+    else if(!arg.empty() && arg[0] == '-')
+    {
+      return usage();
+    }
+    else
+    {
+      auto eq = arg.find('=');
+      if(eq != string::npos)
+      {
+        inputs.emplace_back(arg.substr(0, eq), arg.substr(eq + 1));
+      }
+      else
+      {
+        auto base = arg.substr(arg.find_last_of('/') + 1);
+        inputs.emplace_back(base.substr(0, base.find_last_of('.')), arg);
+      }
+    }
+  }
+  if(output.empty() || inputs.empty())
+  {
+    return usage();
+  }
+
+  vector<pair<string, gfx::Surface>> images;
+  for(const auto& [name, path] : inputs)
+  {
+    images.emplace_back(name, gfx::Surface::load_bmp(path));
+  }
+  // largest first packs tighter
+  stable_sort(images.begin(), images.end(), [](const auto& _a, const auto& _b)
+    {
+      return _a.second.width() * _a.second.height() > _b.second.width() * _b.second.height();
+    });
+  gfx::AssetPackWriter writer(codec, page);
+  for(auto& [name, image] : images)
+  {
+    if(separate)
+    {
+      writer.add(name, std::move(image));
+    }
+    else
+    {
+      writer.add_to_atlas(name, image);
+    }
+  }
+  writer.write(output);
+
+  gfx::AssetPack check(output);
+  cout << output << ": " << check.images().size() << " images, " << check.regions().size() << " regions\n";
+  return 0;
+}
+catch(const std::exception& e)
+{
+  std::cerr << "Error: " << e.what() << std::endl;
+  return 1;
+}
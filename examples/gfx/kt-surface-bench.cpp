@@ -0,0 +1,94 @@
+// Pixel throughput of kt::gfx::Surface against SDL's software renderer.
+#include <kt/gfx/surface.hpp>
+#include <chrono>
+#include <iostream>
+#include <string>
+
+namespace gfx = kt::gfx;
+
+constexpr int width   = 1920;
+constexpr int height  = 1080;
+constexpr int frames  = 50;
+
+template<typename FnT>
+auto measure(const std::string& _name, double _pixels_per_frame, FnT&& _fn)
+  {
+    using namespace std::chrono;
+    auto start = steady_clock::now();
+    for(int i = 0; i < frames; ++i)
+    {
+      _fn();
+    }
+    auto seconds = duration<double>(steady_clock::now() - start).count();
+    std::cout << _name << ": " << (_pixels_per_frame * frames / seconds / 1e6) << " Mpixel/s\n";
+  }
+
+int main() try
+{
+  using namespace std;
+  gfx::sdl_assert(SDL_Init(0));
+  auto target   = gfx::sdl_assert(SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, gfx::default_pixel_format));
+  auto software = gfx::sdl_assert(SDL_CreateSoftwareRenderer(target));
+  // both sprites get the same translucent colour, so both paths blend
+  constexpr gfx::Color sprite_color { 200, 40, 90, 128 };
+  auto sprite_surface = gfx::sdl_assert(SDL_CreateRGBSurfaceWithFormat(0, 256, 256, 32, gfx::default_pixel_format));
+  gfx::sdl_assert(SDL_FillRect(sprite_surface, NULL, sprite_color.pixel()));
+  auto sprite_texture = gfx::sdl_assert(SDL_CreateTextureFromSurface(software, sprite_surface));
+  gfx::sdl_assert(SDL_SetTextureBlendMode(sprite_texture, SDL_BLENDMODE_BLEND));
+
+  gfx::Surface surface(width, height);
+  gfx::Surface sprite(256, 256, sprite_color);
+  constexpr double full = double(width) * height;
+  constexpr int    blits = 64;
+
+  measure("SDL software clear   ", full, [&]
+    {
+      SDL_SetRenderDrawColor(software, 20, 30, 40, 255);
+      SDL_RenderClear(software);
+    });
+  measure("kt Surface clear     ", full, [&]
+    {
+      surface.color(20, 30, 40);
+      surface.clear();
+    });
+  measure("SDL software blend fill", full, [&]
+    {
+      SDL_SetRenderDrawBlendMode(software, SDL_BLENDMODE_BLEND);
+      SDL_SetRenderDrawColor(software, 200, 100, 50, 100);
+      SDL_RenderFillRect(software, NULL);
+    });
+  measure("kt Surface blend fill  ", full, [&]
+    {
+      surface.set_draw_blend(SDL_BLENDMODE_BLEND);
+      surface.color(200, 100, 50, 100);
+      surface.fill_rect(SDL_Rect { 0, 0, width, height });
+    });
+  measure("SDL software blend blit", blits * 256.0 * 256.0, [&]
+    {
+      for(int i = 0; i < blits; ++i)
+      {
+        SDL_Rect dest { (i * 97) % (width - 256), (i * 53) % (height - 256), 256, 256 };
+        SDL_RenderCopy(software, sprite_texture, NULL, &dest);
+      }
+    });
+  measure("kt Surface blend blit  ", blits * 256.0 * 256.0, [&]
+    {
+      for(int i = 0; i < blits; ++i)
+      {
+        surface.copy(sprite, (i * 97) % (width - 256), (i * 53) % (height - 256));
+      }
+    });
+
+  SDL_DestroyTexture(sprite_texture);
+  SDL_FreeSurface(sprite_surface);
+  SDL_DestroyRenderer(software);
+  SDL_FreeSurface(target);
+  SDL_Quit();
+  return 0;
+}
+catch(const std::exception& e)
+{
+  using namespace std;
+  cout << "Error: " << e.what() << endl;
+  return 1;
+}
@@ -0,0 +1,113 @@
+#ifndef noise_hpp_20211104_212230_PDT
+#define noise_hpp_20211104_212230_PDT
+#include <kt/gfx/surface.hpp>
+#include <kt/thread_pool.hpp>
+#include <array>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+namespace kt {
+namespace gen {
+/*! \brief  Lattice noise underlying each octave. */
+enum class basis
+{
+  value     //!< Interpolated random values; blocky, cheapest.
+, perlin    //!< Gradient noise on a square grid.
+, simplex   //!< Gradient noise on a triangular grid; fewer axis artefacts.
+};
+
+struct noise_params
+{
+  basis     kind        = basis::simplex;
+  uint32_t  seed        = 0;
+  float     frequency   = 1.0f / 256.0f;  //!< Lattice cells per sample of the first octave.
+  int       octaves     = 5;              //!< Fractal Brownian motion octaves.
+  float     lacunarity  = 2.0f;           //!< Frequency multiplier between octaves.
+  float     gain        = 0.5f;           //!< Amplitude multiplier between octaves.
+  float     warp        = 0.0f;           //!< Domain warp distance in samples; zero turns warping off.
+};
+
+/*! \brief    Maps noise values in [-1, 1] to colours through a lookup table
+ *            interpolated between stops.
+ */
+class ColorRamp final
+{
+public:
+  static constexpr std::size_t resolution = 1024;
+
+  ColorRamp();
+  ColorRamp(std::initializer_list<std::pair<float, gfx::Color>> _stops);
+
+  /*! \brief  Add a stop at `_t`, from 0 for -1 up to 1 for +1; `_t` is
+   *          clamped to that range, here and in the constructor alike.
+   */
+  auto add(float _t, gfx::Color _c) -> ColorRamp&;
+  /*! \brief  `_v` in [-1, 1] as one `default_pixel_format` pixel. */
+  auto map(float _v) const -> uint32_t
+    {
+      auto t = (_v + 1.0f) * (0.5f * float(resolution - 1)) + 0.5f;
+      auto i = t > 0.0f? std::size_t(t) : std::size_t(0);
+      return lut_[i < resolution? i : resolution - 1];
+    }
+private:
+  std::vector<std::pair<float, gfx::Color>> stops_;
+  std::array<uint32_t, resolution>          lut_;
+
+  auto rebuild() -> void;
+};
+
+/*! \brief    Fractal noise field.  Rows are evaluated eight samples per
+ *            instruction with AVX2 where the CPU has it and four otherwise,
+ *            and images are split into bands of rows across a thread pool.
+ *            Results depend only on the parameters and coordinates, not on
+ *            the instruction set or the thread count.
+ */
+class Noise final
+{
+public:
+  explicit Noise(const noise_params& _params = noise_params {});
+
+  auto params() const -> const noise_params&;
+  /*! \brief  One sample, in [-1, 1]. */
+  auto sample(float _x, float _y) const -> float;
+  /*! \brief  Fill `_h` rows of `_w` samples, `_stride` floats apart, with the
+   *          field starting at `_x0`, `_y0`.
+   */
+  auto fill
+      ( float*        _out
+      , int           _w
+      , int           _h
+      , std::size_t   _stride
+      , float         _x0   = 0.0f
+      , float         _y0   = 0.0f
+      , thread_pool&  _pool = thread_pool::shared()
+      ) const -> void;
+  /*! \brief  Render straight into 32 bit pixels `_pitch` bytes apart, such
+   *          as a `Surface` or a locked streaming texture.
+   */
+  auto render
+      ( uint32_t*         _pixels
+      , int               _w
+      , int               _h
+      , int               _pitch
+      , const ColorRamp&  _ramp
+      , float             _x0   = 0.0f
+      , float             _y0   = 0.0f
+      , thread_pool&      _pool = thread_pool::shared()
+      ) const -> void;
+  auto render
+      ( gfx::Surface&     _s
+      , const ColorRamp&  _ramp
+      , float             _x0   = 0.0f
+      , float             _y0   = 0.0f
+      , thread_pool&      _pool = thread_pool::shared()
+      ) const -> void;
+
+  /*! \brief  Samples evaluated per instruction on this machine. */
+  static auto lanes() -> int;
+private:
+  noise_params params_;
+};
+} /* namespace gen */
+} /* namespace kt */
+#endif//noise_hpp_20211104_212230_PDT
@@ -0,0 +1,142 @@
+#ifndef asset_pack_hpp_20211105_171840_PDT
+#define asset_pack_hpp_20211105_171840_PDT
+#include <kt/gfx/atlas.hpp>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+namespace kt {
+namespace gfx {
+/*! \brief    Read-only pack of images, built ahead of time by `AssetPackWriter`
+ *            (see the kt-pack tool) and memory-mapped whole.  Images are
+ *            stored already in `default_pixel_format`, either raw and
+ *            aligned so textures upload straight from the mapping, or QOI
+ *            compressed.  Each packed file is a named region: a whole image,
+ *            or a rectangle of an atlas page the packer built.
+ *
+ *            File layout, all integers little-endian: a 32 byte header
+ *            ("KTPK", version, image count, region count, string bytes,
+ *            data alignment), 40 byte image records, 28 byte region
+ *            records, the names, then each image's data at a multiple of
+ *            the alignment.
+ */
+class AssetPack final
+{
+public:
+  enum class codec : uint32_t
+  {
+    raw   = 0,  //!< Rows of pixels, 4 * width bytes each.
+    qoi   = 1,  //!< "Quite OK Image" stream.
+  };
+  struct image
+  {
+    std::string_view  name;
+    int               w;
+    int               h;
+    codec             encoding;
+    const uint8_t*    data;   //!< Within the mapping.
+    std::size_t       size;
+  };
+  struct region
+  {
+    std::string_view  name;
+    std::size_t       image;  //!< Index into `images()`.
+    SDL_Rect          rect;
+  };
+  static constexpr uint32_t version = 1;
+
+  AssetPack(const AssetPack&) = delete;
+  AssetPack(AssetPack&&);
+  auto operator=(AssetPack&&) -> AssetPack&;
+  /*! \brief  Map `_path` and read its index; throws if it isn't a pack. */
+  explicit AssetPack(const std::string& _path);
+  ~AssetPack();
+
+  auto images()  const -> const std::vector<image>&;
+  auto regions() const -> const std::vector<region>&;
+  auto find_image(std::string_view _name) const -> const image*;
+  /*! \brief  Region packed under `_name`, or null. */
+  auto find(std::string_view _name) const -> const region*;
+
+  /*! \brief  CPU copy of `_i`. */
+  auto decode(const image& _i) const -> Surface;
+  /*! \brief  Static texture of `_i`; raw images upload from the mapping
+   *          without an intermediate copy.
+   */
+  auto upload(Renderer& _r, const image& _i) const -> Texture;
+  /*! \brief  As above, decoding QOI images into `_scratch`, which grows as
+   *          needed and is left to the caller to reuse or free.
+   */
+  auto upload(Renderer& _r, const image& _i, std::vector<uint32_t>& _scratch) const -> Texture;
+  /*! \brief  Every image, in the order of `images()`.  One decode buffer
+   *          serves them all and is freed on return.
+   */
+  auto upload_all(Renderer& _r) const -> std::vector<Texture>;
+private:
+  const uint8_t*                                    map_   = nullptr;
+  std::size_t                                       size_  = 0;
+  std::vector<image>                                images_;
+  std::vector<region>                               regions_;
+  std::unordered_map<std::string_view, std::size_t> image_index_;
+  std::unordered_map<std::string_view, std::size_t> region_index_;
+
+  auto release() -> void;
+};
+
+/*! \brief    Builds `AssetPack` files.  Images added to the atlas share
+ *            pages packed with `SkylinePacker`; anything too large for a
+ *            page is stored on its own.
+ */
+class AssetPackWriter final
+{
+public:
+  static constexpr int          default_page_size = Atlas::default_page_size;
+  static constexpr std::size_t  default_alignment = 4096;
+
+  explicit AssetPackWriter
+      ( AssetPack::codec  _codec      = AssetPack::codec::raw
+      , int               _page_size  = default_page_size
+      , std::size_t       _alignment  = default_alignment
+      );
+
+  /*! \brief  Store `_image` as an image of its own. */
+  auto add(const std::string& _name, Surface _image) -> void;
+  /*! \brief  Store `_image` on an atlas page, as a region named `_name`. */
+  auto add_to_atlas(const std::string& _name, const Surface& _image) -> void;
+  /*! \brief  Write everything added so far to `_path`. */
+  auto write(const std::string& _path) const -> void;
+private:
+  struct entry
+  {
+    std::string name;
+    Surface     pixels;
+  };
+  struct page
+  {
+    std::size_t   image;
+    SkylinePacker packer;
+  };
+  struct named_rect
+  {
+    std::string name;
+    std::size_t image;
+    SDL_Rect    rect;
+  };
+
+  AssetPack::codec        codec_;
+  int                     page_size_;
+  std::size_t             alignment_;
+  std::vector<entry>      images_;
+  std::vector<page>       pages_;
+  std::vector<named_rect> regions_;
+};
+
+/*! \brief  QOI codec for `default_pixel_format` pixels. */
+auto qoi_encode(const uint32_t* _pixels, int _w, int _h, std::vector<uint8_t>& _out) -> void;
+/*! \brief  Decode a QOI stream of a `_w` by `_h` image into `_pixels`;
+ *          throws if the stream is malformed or has another size.
+ */
+auto qoi_decode(const uint8_t* _data, std::size_t _size, int _w, int _h, uint32_t* _pixels) -> void;
+} /* namespace gfx */
+} /* namespace kt */
+#endif//asset_pack_hpp_20211105_171840_PDT
@@ -0,0 +1,78 @@
+#ifndef assets_hpp_20211018_210427_PDT
+#define assets_hpp_20211018_210427_PDT
+#include <kt/gfx/surface.hpp>
+#include <kt/thread_pool.hpp>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+namespace kt {
+namespace gfx {
+/*! \brief    Loads images off the render thread.  Files are decoded on worker
+ *            threads straight into `default_pixel_format`, and the GPU
+ *            uploads are handed back to the render thread, which runs as many
+ *            as fit in its per-frame budget from `pump()`.  Textures are
+ *            cached by path, so loading the same file again is free.
+ */
+class AssetManager final
+{
+  struct entry;
+public:
+  /*! \brief  Shared reference to a cached texture.  It is usable once
+   *          `ready()`; if decoding failed, `texture()` throws the error.
+   */
+  class handle final
+  {
+  public:
+    handle() noexcept = default;
+
+    auto ready()  const -> bool;
+    auto failed() const -> bool;
+    auto texture() const -> const Texture&;
+    auto path() const -> const std::string&;
+    explicit operator bool() const { return entry_ != nullptr; }
+  private:
+    friend class AssetManager;
+    explicit handle(std::shared_ptr<entry> _e) : entry_(std::move(_e)) {}
+    std::shared_ptr<entry> entry_;
+  };
+  using budget_t = std::chrono::microseconds;
+  static constexpr budget_t default_budget = std::chrono::milliseconds(2);
+
+  AssetManager(const AssetManager&) = delete;
+  /*! \brief  `_decoders` worker threads; zero means one per hardware thread. */
+  explicit AssetManager(Renderer& _r, std::size_t _decoders = 0);
+  ~AssetManager();
+
+  /*! \brief  Start loading `_path` unless it is already cached. */
+  auto load(const std::string& _path) -> handle;
+  /*! \brief  Upload decoded images until `_budget` is spent; call once per
+   *          frame on the render thread.  At least one upload always runs,
+   *          so progress is made under any budget.
+   *  \return Number of textures uploaded.
+   */
+  auto pump(budget_t _budget = default_budget) -> std::size_t;
+  /*! \brief  Block until everything requested so far is uploaded. */
+  auto finish() -> void;
+  /*! \brief  Loads not yet uploaded. */
+  auto pending() const -> std::size_t;
+  /*! \brief  Drop cache entries nobody else holds a handle to. */
+  auto purge_unused() -> std::size_t;
+  auto cached() const -> std::size_t;
+private:
+  Renderer&                                               renderer_;
+  std::unordered_map<std::string, std::shared_ptr<entry>> cache_;
+  std::deque<std::shared_ptr<entry>>                      uploads_;
+  mutable std::mutex                                      uploads_mutex_;
+  std::condition_variable                                 decoded_;
+  std::size_t                                             pending_ = 0;
+  // last, so it drains and joins before the queues above are destroyed
+  thread_pool                                             decoders_;
+
+  auto decode(std::shared_ptr<entry> _e) -> void;
+  auto upload(entry& _e) -> void;
+};
+} /* namespace gfx */
+} /* namespace kt */
+#endif//assets_hpp_20211018_210427_PDT
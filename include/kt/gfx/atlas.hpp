@@ -0,0 +1,90 @@
+#ifndef atlas_hpp_20211016_143320_PDT
+#define atlas_hpp_20211016_143320_PDT
+#include <kt/gfx/surface.hpp>
+#include <deque>
+#include <optional>
+#include <vector>
+namespace kt {
+namespace gfx {
+/*! \brief    Bottom-left skyline rectangle packer. */
+class SkylinePacker final
+{
+public:
+  SkylinePacker(int _w, int _h, int _padding = 1);
+
+  /*! \brief  Reserve a `_w` by `_h` rectangle, or nothing if it won't fit. */
+  auto pack(int _w, int _h) -> std::optional<SDL_Rect>;
+  auto reset() -> void;
+  auto width()  const -> int;
+  auto height() const -> int;
+  /*! \brief  Fraction of the area handed out so far. */
+  auto occupancy() const -> double;
+private:
+  struct segment { int x; int y; int w; };
+
+  int                   width_;
+  int                   height_;
+  int                   padding_;
+  std::size_t           used_area_ = 0;
+  std::vector<segment>  skyline_;
+
+  auto fit(std::size_t _index, int _w, int _h) const -> std::optional<int>;
+};
+
+/*! \brief    Packs many small images into a few large page textures.  Images
+ *            are staged on CPU surfaces and only the part of each page that
+ *            changed is uploaded, so the atlas can keep growing while in use.
+ */
+class Atlas final
+{
+public:
+  /*! \brief  Where an image ended up. */
+  struct region
+  {
+    std::size_t page;   //!< Index of the page texture.
+    SDL_Rect    rect;   //!< Pixel rectangle within the page.
+  };
+  static constexpr int default_page_size = 2048;
+
+  Atlas(const Atlas&) = delete;
+  Atlas(Atlas&&)      = default;
+  explicit Atlas(int _page_w = default_page_size, int _page_h = default_page_size, int _padding = 1);
+
+  /*! \brief  Place `_image` on the first page with room, opening a new page
+   *          if none has any.  Throws if the image, padding included, is
+   *          larger than a page.
+   */
+  auto add(const Surface& _image) -> region;
+  /*! \brief  Add several images, largest first for a tighter packing; the
+   *          regions are returned in the order of `_images`.
+   */
+  auto add(const std::vector<const Surface*>& _images) -> std::vector<region>;
+  /*! \brief  Create or refresh the textures of pages changed since the last
+   *          upload.
+   */
+  auto upload(Renderer&) -> void;
+
+  auto pages() const -> std::size_t;
+  /*! \brief  Texture of page `_index`.  The reference stays valid for the
+   *          life of the atlas, however many pages are added after it, so
+   *          batches may hold on to it.
+   */
+  auto page(std::size_t _index) const -> const Texture&;
+  auto page_size() const -> Texture::size;
+private:
+  struct page_store
+  {
+    SkylinePacker           packer;
+    Surface                 pixels;
+    Texture                 texture;
+    std::optional<SDL_Rect> dirty;    //!< Bounds of the pixels not yet uploaded.
+  };
+
+  int                     page_w_;
+  int                     page_h_;
+  int                     padding_;
+  std::deque<page_store>  pages_;     //!< A deque, so adding pages moves none.
+};
+} /* namespace gfx */
+} /* namespace kt */
+#endif//atlas_hpp_20211016_143320_PDT
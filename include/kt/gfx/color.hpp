@@ -16,30 +16,53 @@ public:
     , a_(_a)
   {}
 
-  auto r() const -> uint8_t { return r_; }
-  auto g() const -> uint8_t { return g_; }
-  auto b() const -> uint8_t { return b_; }
-  auto a() const -> uint8_t { return a_; }
+  constexpr auto r() const -> uint8_t { return r_; }
+  constexpr auto g() const -> uint8_t { return g_; }
+  constexpr auto b() const -> uint8_t { return b_; }
+  constexpr auto a() const -> uint8_t { return a_; }
 
-  auto set_r(uint8_t _v)    { r_ = _v; }
-  auto set_g(uint8_t _v)    { g_ = _v; }
-  auto set_b(uint8_t _v)    { b_ = _v; }
-  auto set_a(uint8_t _v)    { a_ = _v; }
+  constexpr auto set_r(uint8_t _v)    { r_ = _v; }
+  constexpr auto set_g(uint8_t _v)    { g_ = _v; }
+  constexpr auto set_b(uint8_t _v)    { b_ = _v; }
+  constexpr auto set_a(uint8_t _v)    { a_ = _v; }
 
-  auto operator+=(const Color& _c) -> Color&
+  constexpr auto operator==(const Color&) const -> bool = default;
+
+  /*! \brief  This color as one `default_pixel_format` pixel. */
+  constexpr auto pixel() const -> uint32_t
+    {
+      return uint32_t(r_) << r_shift
+           | uint32_t(g_) << g_shift
+           | uint32_t(b_) << b_shift
+           | uint32_t(a_) << a_shift;
+    }
+  /*! \brief  Unpack one `default_pixel_format` pixel. */
+  static constexpr auto from_pixel(uint32_t _p) -> Color
+    {
+      return Color
+        { uint8_t(_p >> r_shift)
+        , uint8_t(_p >> g_shift)
+        , uint8_t(_p >> b_shift)
+        , uint8_t(_p >> a_shift)
+        };
+    }
+
+  /*! \brief  Per-channel add, saturating at 255. */
+  constexpr auto operator+=(const Color& _c) -> Color&
     {
-      r_ += _c.r_;
-      g_ += _c.g_;
-      b_ += _c.b_;
-      a_ += _c.a_;
+      r_ = saturate(int(r_) + _c.r_);
+      g_ = saturate(int(g_) + _c.g_);
+      b_ = saturate(int(b_) + _c.b_);
+      a_ = saturate(int(a_) + _c.a_);
       return *this;
     }
-  auto operator-=(const Color& _c) -> Color&
+  /*! \brief  Per-channel subtract, saturating at 0. */
+  constexpr auto operator-=(const Color& _c) -> Color&
     {
-      r_ -= _c.r_;
-      g_ -= _c.g_;
-      b_ -= _c.b_;
-      a_ -= _c.a_;
+      r_ = saturate(int(r_) - _c.r_);
+      g_ = saturate(int(g_) - _c.g_);
+      b_ = saturate(int(b_) - _c.b_);
+      a_ = saturate(int(a_) - _c.a_);
       return *this;
     }
   static constexpr auto black()       -> Color { return Color { 0x00, 0x00, 0x00 }; }
@@ -54,6 +77,16 @@ public:
   static constexpr auto gray()        -> Color { return Color { 0x88, 0x88, 0x88 }; }
   static constexpr auto grey()        -> Color { return gray(); }
 private:
+  // RGBA32 is byte order R, G, B, A in memory, whatever the word order
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+  static constexpr int r_shift = 24, g_shift = 16, b_shift = 8, a_shift = 0;
+#else
+  static constexpr int r_shift = 0, g_shift = 8, b_shift = 16, a_shift = 24;
+#endif
+  static constexpr auto saturate(int _v) -> uint8_t
+    {
+      return uint8_t(_v < 0? 0 : _v > 255? 255 : _v);
+    }
   uint8_t r_;
   uint8_t g_;
   uint8_t b_;
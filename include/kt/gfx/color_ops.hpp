@@ -0,0 +1,267 @@
+#ifndef color_ops_hpp_20211105_093411_PDT
+#define color_ops_hpp_20211105_093411_PDT
+#include <kt/gfx/color.hpp>
+#include <array>
+#include <span>
+namespace kt {
+namespace gfx {
+/*! \brief    Colour arithmetic, one colour at a time and over spans of
+ *            `default_pixel_format` pixels.  The single-colour forms are
+ *            constexpr, for palettes built at compile time; the span forms
+ *            run SSE2 or AVX2 kernels picked for the CPU at start up and
+ *            give the same results.  Channels are 8 bit, products are
+ *            rounded, and nothing wraps.
+ */
+namespace color {
+struct hsv
+{
+  float   h = 0.0f;               //!< Hue in degrees, [0, 360).
+  float   s = 0.0f;               //!< Saturation, [0, 1].
+  float   v = 0.0f;               //!< Value, [0, 1].
+  uint8_t a = SDL_ALPHA_OPAQUE;
+};
+
+namespace detail {
+// rounded x / 255 for x <= 255 * 255
+constexpr auto div255(uint32_t _x) -> uint8_t
+  {
+    _x += 128;
+    return uint8_t((_x + (_x >> 8)) >> 8);
+  }
+constexpr auto to_byte(double _v) -> uint8_t
+  {
+    return uint8_t(_v <= 0.0? 0 : _v >= 255.0? 255 : int(_v + 0.5));
+  }
+// `_x` to the power 1 / `_n` for `_x` in [0, 1], by Newton's method from
+// above, which converges for every such `_x`; constexpr, unlike std::pow
+constexpr auto root(double _x, int _n) -> double
+  {
+    if(_x <= 0.0)
+    {
+      return 0.0;
+    }
+    auto y = 1.0;
+    for(int i = 0; i < 64; ++i)
+    {
+      auto p = 1.0;
+      for(int k = 1; k < _n; ++k)
+      {
+        p *= y;
+      }
+      auto next = y - (p * y - _x) / (_n * p);
+      if(next >= y)
+      {
+        break;
+      }
+      y = next;
+    }
+    return y;
+  }
+// IEC 61966-2-1 decoding on [0, 1]
+constexpr auto decode(double _c) -> double
+  {
+    if(_c <= 0.04045)
+    {
+      return _c / 12.92;
+    }
+    auto x = (_c + 0.055) / 1.055;
+    auto r = root(x, 5);
+    return x * x * r * r;   // x^2.4
+  }
+constexpr auto make_linear_table() -> std::array<uint16_t, 256>
+  {
+    std::array<uint16_t, 256> table {};
+    for(int i = 0; i < 256; ++i)
+    {
+      table[std::size_t(i)] = uint16_t(decode(i / 255.0) * 65535.0 + 0.5);
+    }
+    return table;
+  }
+// midpoints between neighbouring linear values; a linear value rounds up to
+// channel c + 1 from thresholds[c]
+constexpr auto make_threshold_table(const std::array<uint16_t, 256>& _linear) -> std::array<uint16_t, 255>
+  {
+    std::array<uint16_t, 255> table {};
+    for(std::size_t c = 0; c < 255; ++c)
+    {
+      table[c] = uint16_t((uint32_t(_linear[c]) + _linear[c + 1] + 1) / 2);
+    }
+    return table;
+  }
+// nearest channel for the start of each 16 wide bucket of linear values;
+// neighbouring linear values are at least 20 apart, so at most one
+// threshold falls inside a bucket
+constexpr auto make_srgb_table(const std::array<uint16_t, 255>& _thresholds) -> std::array<uint8_t, 4096>
+  {
+    std::array<uint8_t, 4096> table {};
+    std::size_t c = 0;
+    for(uint32_t i = 0; i < 4096; ++i)
+    {
+      while(c < 255 && i * 16 >= _thresholds[c])
+      {
+        ++c;
+      }
+      table[i] = uint8_t(c);
+    }
+    return table;
+  }
+inline constexpr auto linear_table    = make_linear_table();
+inline constexpr auto threshold_table = make_threshold_table(linear_table);
+inline constexpr auto srgb_table      = make_srgb_table(threshold_table);
+} /* namespace detail */
+
+/*! \brief  sRGB channel to linear light, 0 to 65535. */
+constexpr auto to_linear(uint8_t _c) -> uint16_t
+  {
+    return detail::linear_table[_c];
+  }
+/*! \brief  Linear light back to the nearest sRGB channel, so that
+ *          `to_srgb(to_linear(c)) == c`.
+ */
+constexpr auto to_srgb(uint16_t _l) -> uint8_t
+  {
+    auto c = detail::srgb_table[_l >> 4];
+    return c < 255 && _l >= detail::threshold_table[c]? uint8_t(c + 1) : c;
+  }
+
+constexpr auto add(Color _a, Color _b) -> Color
+  {
+    return _a += _b;
+  }
+constexpr auto subtract(Color _a, Color _b) -> Color
+  {
+    return _a -= _b;
+  }
+/*! \brief  Per-channel product, as if both were in [0, 1]. */
+constexpr auto multiply(Color _a, Color _b) -> Color
+  {
+    return Color
+      { detail::div255(uint32_t(_a.r()) * _b.r())
+      , detail::div255(uint32_t(_a.g()) * _b.g())
+      , detail::div255(uint32_t(_a.b()) * _b.b())
+      , detail::div255(uint32_t(_a.a()) * _b.a())
+      };
+  }
+/*! \brief  `_a` at `_t` 0, `_b` at `_t` 255. */
+constexpr auto lerp(Color _a, Color _b, uint8_t _t) -> Color
+  {
+    auto mix = [_t](uint8_t _x, uint8_t _y)
+      {
+        return detail::div255(uint32_t(_x) * (255u - _t) + uint32_t(_y) * _t);
+      };
+    return Color { mix(_a.r(), _b.r()), mix(_a.g(), _b.g()), mix(_a.b(), _b.b()), mix(_a.a(), _b.a()) };
+  }
+constexpr auto premultiply(Color _c) -> Color
+  {
+    return Color
+      { detail::div255(uint32_t(_c.r()) * _c.a())
+      , detail::div255(uint32_t(_c.g()) * _c.a())
+      , detail::div255(uint32_t(_c.b()) * _c.a())
+      , _c.a()
+      };
+  }
+/*! \brief  Undo `premultiply`; fully transparent colours come back black. */
+constexpr auto unpremultiply(Color _c) -> Color
+  {
+    auto a = uint32_t(_c.a());
+    if(a == 0)
+    {
+      return Color::transparent();
+    }
+    auto div = [a](uint8_t _x)
+      {
+        auto v = (uint32_t(_x) * 255u + a / 2) / a;
+        return uint8_t(v > 255u? 255u : v);
+      };
+    return Color { div(_c.r()), div(_c.g()), div(_c.b()), _c.a() };
+  }
+constexpr auto to_hsv(Color _c) -> hsv
+  {
+    auto r   = _c.r() / 255.0f;
+    auto g   = _c.g() / 255.0f;
+    auto b   = _c.b() / 255.0f;
+    auto max = r > g? (r > b? r : b) : (g > b? g : b);
+    auto min = r < g? (r < b? r : b) : (g < b? g : b);
+    auto d   = max - min;
+    auto h   = 0.0f;
+    if(d > 0.0f)
+    {
+      if(max == r)
+      {
+        h = 60.0f * ((g - b) / d);
+      }
+      else if(max == g)
+      {
+        h = 60.0f * ((b - r) / d + 2.0f);
+      }
+      else
+      {
+        h = 60.0f * ((r - g) / d + 4.0f);
+      }
+      if(h < 0.0f)
+      {
+        h += 360.0f;
+      }
+    }
+    return hsv { h, max > 0.0f? d / max : 0.0f, max, _c.a() };
+  }
+constexpr auto from_hsv(const hsv& _c) -> Color
+  {
+    auto h = _c.h / 60.0f;
+    auto k = int(h);
+    if(float(k) > h)
+    {
+      --k;
+    }
+    auto f = h - float(k);
+    k %= 6;
+    if(k < 0)
+    {
+      k += 6;
+    }
+    auto s = _c.s < 0.0f? 0.0f : _c.s > 1.0f? 1.0f : _c.s;
+    auto v = (_c.v < 0.0f? 0.0f : _c.v > 1.0f? 1.0f : _c.v) * 255.0f;
+    auto p = v * (1.0f - s);
+    auto q = v * (1.0f - s * f);
+    auto t = v * (1.0f - s * (1.0f - f));
+    auto c = [](float _x) { return detail::to_byte(_x); };
+    switch(k)
+    {
+    case 0:   return Color { c(v), c(t), c(p), _c.a };
+    case 1:   return Color { c(q), c(v), c(p), _c.a };
+    case 2:   return Color { c(p), c(v), c(t), _c.a };
+    case 3:   return Color { c(p), c(q), c(v), _c.a };
+    case 4:   return Color { c(t), c(p), c(v), _c.a };
+    default:  return Color { c(v), c(p), c(q), _c.a };
+    }
+  }
+
+// Span forms.  Binary operations combine `_dst` with `_src` or a colour in
+// place and stop at the shorter span.
+auto add(std::span<uint32_t> _dst, std::span<const uint32_t> _src) -> void;
+auto add(std::span<uint32_t> _dst, Color _c) -> void;
+auto subtract(std::span<uint32_t> _dst, std::span<const uint32_t> _src) -> void;
+auto subtract(std::span<uint32_t> _dst, Color _c) -> void;
+auto multiply(std::span<uint32_t> _dst, std::span<const uint32_t> _src) -> void;
+auto multiply(std::span<uint32_t> _dst, Color _c) -> void;
+/*! \brief  `_dst` moved towards `_src` by `_t` out of 255. */
+auto lerp(std::span<uint32_t> _dst, std::span<const uint32_t> _src, uint8_t _t) -> void;
+/*! \brief  `_dst` moved towards `_c` by `_t` out of 255. */
+auto lerp(std::span<uint32_t> _dst, Color _c, uint8_t _t) -> void;
+/*! \brief  Fill `_dst` with an even ramp from `_from` in the first pixel to
+ *          `_to` in the last.
+ */
+auto gradient(std::span<uint32_t> _dst, Color _from, Color _to) -> void;
+auto premultiply(std::span<uint32_t> _dst) -> void;
+auto unpremultiply(std::span<uint32_t> _dst) -> void;
+/*! \brief  Decode pixels to four linear 16 bit channels each; alpha is
+ *          scaled, not decoded.  `_dst` needs four entries per pixel.
+ */
+auto to_linear(std::span<const uint32_t> _src, std::span<uint16_t> _dst) -> void;
+auto to_srgb(std::span<const uint16_t> _src, std::span<uint32_t> _dst) -> void;
+auto to_hsv(std::span<const uint32_t> _src, std::span<hsv> _dst) -> void;
+auto from_hsv(std::span<const hsv> _src, std::span<uint32_t> _dst) -> void;
+} /* namespace color */
+} /* namespace gfx */
+} /* namespace kt */
+#endif//color_ops_hpp_20211105_093411_PDT
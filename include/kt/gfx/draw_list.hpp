@@ -0,0 +1,114 @@
+#ifndef draw_list_hpp_20211030_142207_PDT
+#define draw_list_hpp_20211030_142207_PDT
+#include <kt/gfx/renderer.hpp>
+#include <kt/thread_pool.hpp>
+#include <functional>
+#include <variant>
+#include <vector>
+namespace kt {
+namespace gfx {
+/*! \brief    Draw calls recorded for later submission.  Recording touches
+ *            no SDL state, so any thread may fill a list; `submit` replays
+ *            it on the thread that owns the renderer, into whatever target
+ *            is bound there.  Textures must outlive the submit.
+ */
+class DrawList final
+{
+public:
+  DrawList() = default;
+
+  auto color(const Color& _c) -> void;
+  auto set_draw_blend(SDL_BlendMode _mode) -> void;
+  auto clear() -> void;   //!< Records a clear of the target, like `Renderer::clear`.
+  auto point(int _x, int _y) -> void;
+  auto line(int _x1, int _y1, int _x2, int _y2) -> void;
+  auto line_f(float _x1, float _y1, float _x2, float _y2) -> void;
+  auto fill_rect(const SDL_Rect& _r) -> void;
+  auto circle(int _cx, int _cy, int _radius, bool _fill = false) -> void;
+  auto set_clip(const SDL_Rect& _clip) -> void;
+  auto clear_clip() -> void;
+  auto copy(const Texture& _t, const SDL_Rect& _dest) -> void;
+  auto copy(const Texture& _t, const SDL_Rect& _src, const SDL_Rect& _dest, double _angle = 0.0) -> void;
+  /*! \brief  Like `Renderer::geometry`; the vertices and indices are copied. */
+  auto geometry(const Texture* _t, const SDL_Vertex* _vertices, int _num_vertices, const int* _indices = nullptr, int _num_indices = 0) -> void;
+
+  /*! \brief  Replay every recorded call, in order. */
+  auto submit(Renderer& _r) const -> void;
+  /*! \brief  Forget the recorded calls, keeping the storage for reuse. */
+  auto reset() -> void;
+  auto size() const -> std::size_t;
+  auto empty() const -> bool;
+private:
+  struct set_color    { Color c; };
+  struct set_blend    { SDL_BlendMode mode; };
+  struct do_clear     {};
+  struct do_point     { int x, y; };
+  struct do_line      { int x1, y1, x2, y2; };
+  struct do_line_f    { float x1, y1, x2, y2; };
+  struct do_fill_rect { SDL_Rect r; };
+  struct do_circle    { int cx, cy, radius; bool fill; };
+  struct do_clip      { SDL_Rect r; };
+  struct do_unclip    {};
+  struct do_copy      { const Texture* t; SDL_Rect src, dest; double angle; bool whole; };
+  struct do_geometry  { const Texture* t; std::size_t first_vertex, vertex_count, first_index, index_count; };
+  using command = std::variant
+      < set_color, set_blend, do_clear, do_point, do_line, do_line_f
+      , do_fill_rect, do_circle, do_clip, do_unclip, do_copy, do_geometry
+      >;
+  std::vector<command>    commands_;
+  std::vector<SDL_Vertex> vertices_;
+  std::vector<int>        indices_;
+};
+
+/*! \brief    Builds a frame from tasks run across a thread pool.  Each task
+ *            records into a list of its own; `submit` replays the lists in
+ *            the order the tasks were added, so the frame comes out the same
+ *            however the tasks were scheduled.
+ */
+class DrawRecorder final
+{
+public:
+  using task = std::function<void(DrawList&)>;
+
+  explicit DrawRecorder(thread_pool& _pool = thread_pool::shared());
+
+  /*! \brief  Queue one recording task. */
+  auto add(task _t) -> void;
+  /*! \brief  Queue `_fn(list, begin, end)` over `[0, _count)` in chunks of
+   *          `_grain` items, one task per chunk.
+   */
+  template<typename FnT>
+    auto add_range(std::size_t _count, std::size_t _grain, FnT _fn) -> void
+    {
+      _grain = std::max<std::size_t>(_grain, 1);
+      for(std::size_t first = 0; first < _count; first += _grain)
+      {
+        auto last = std::min(_count, first + _grain);
+        add([_fn, first, last](DrawList& _list) { _fn(_list, first, last); });
+      }
+    }
+  /*! \brief  Run the queued tasks on the pool, helping from this thread, and
+   *          wait for them.  The first exception thrown by a task is
+   *          rethrown.
+   */
+  auto record() -> void;
+  /*! \brief  Record anything outstanding, then replay the lists in order
+   *          and start over.  Call it on the renderer's thread.
+   */
+  auto submit(Renderer& _r) -> void;
+  /*! \brief  Drop queued tasks and recorded lists without submitting. */
+  auto reset() -> void;
+
+  auto tasks() const -> std::size_t;
+  /*! \brief  Commands submitted by the last `submit`. */
+  auto last_commands() const -> std::size_t;
+private:
+  thread_pool&            pool_;
+  std::vector<task>       tasks_;
+  std::vector<DrawList>   lists_;     //!< Kept between frames for their storage.
+  std::size_t             recorded_       = 0;
+  std::size_t             last_commands_  = 0;
+};
+} /* namespace gfx */
+} /* namespace kt */
+#endif//draw_list_hpp_20211030_142207_PDT
@@ -0,0 +1,124 @@
+#ifndef filter_hpp_20211108_164027_PDT
+#define filter_hpp_20211108_164027_PDT
+#include <kt/gfx/surface.hpp>
+#include <kt/thread_pool.hpp>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+namespace kt {
+namespace gfx {
+/*! \brief    Bump allocator for short-lived buffers.  Everything taken since
+ *            the last `rewind` stays valid until the next; after a rewind
+ *            the memory is handed out again, so a loop that needs the same
+ *            buffers every frame stops allocating after the first.
+ */
+class ScratchArena final
+{
+public:
+  static constexpr std::size_t alignment = 64;
+
+  ScratchArena() = default;
+  ScratchArena(const ScratchArena&) = delete;
+
+  /*! \brief  Uninitialised room for `_n` objects of `T`, aligned to a cache
+   *          line.  `T` must be trivially copyable.
+   */
+  template<typename T>
+    auto take(std::size_t _n) -> T*
+    {
+      return static_cast<T*>(take_bytes(_n * sizeof(T)));
+    }
+  /*! \brief  Make everything taken so far reusable. */
+  auto rewind() -> void;
+  /*! \brief  Bytes held. */
+  auto capacity() const -> std::size_t;
+private:
+  struct free_deleter
+  {
+    auto operator()(void* _p) const -> void { std::free(_p); }
+  };
+  struct block
+  {
+    std::unique_ptr<std::byte[], free_deleter>  data;
+    std::size_t                                 size;
+  };
+
+  std::vector<block>  blocks_;
+  std::size_t         used_ = 0;  //!< Within `blocks_.back()`.
+
+  auto take_bytes(std::size_t _bytes) -> void*;
+  auto add_block(std::size_t _bytes) -> void;
+};
+
+/*! \brief    CPU post-processing of `Surface`s: blurs, threshold, bloom and
+ *            resampling.  Separable filters run as a horizontal pass into a
+ *            four-float-per-pixel intermediate and a vertical pass back to
+ *            bytes, with SIMD row kernels and the image cut into tiles
+ *            spread across the pool.  Intermediates come from a
+ *            `ScratchArena` the pipeline keeps, so chained calls reuse the
+ *            same memory.
+ *
+ *            Channels are filtered independently; premultiply images with
+ *            transparency first (see `color::premultiply`) so transparent
+ *            pixels don't bleed their colour.
+ */
+class FilterPipeline final
+{
+public:
+  enum class resample_filter
+  {
+    box,        //!< Area average; the choice for shrinking.
+    bilinear,   //!< Triangle, widened when shrinking.
+    lanczos,    //!< Windowed sinc, three lobes; sharpest, may ring.
+  };
+
+  FilterPipeline(const FilterPipeline&) = delete;
+  explicit FilterPipeline(thread_pool& _pool = thread_pool::shared());
+
+  /*! \brief  Gaussian blur with standard deviation `_sigma` pixels.  Near
+   *          the edges the kernel is renormalised over the pixels inside.
+   */
+  auto gaussian_blur(Surface& _s, float _sigma) -> void;
+  /*! \brief  Mean over a `2 * _radius + 1` square, `_passes` times; each
+   *          pass costs the same whatever the radius.  Three passes are
+   *          close to a gaussian.
+   */
+  auto box_blur(Surface& _s, int _radius, int _passes = 1) -> void;
+  /*! \brief  Clear pixels whose luma is below `_level`. */
+  auto threshold(Surface& _s, uint8_t _level) -> void;
+  /*! \brief  Add a blurred copy of the pixels at or above `_level`, scaled
+   *          by `_strength`.  The glow is blurred at half resolution.
+   */
+  auto bloom(Surface& _s, uint8_t _level, float _sigma, float _strength = 1.0f) -> void;
+  /*! \brief  Scale `_src` to the size of `_dst`. */
+  auto resample(const Surface& _src, Surface& _dst, resample_filter _f = resample_filter::bilinear) -> void;
+
+  auto scratch() const -> const ScratchArena&;
+private:
+  /*! \brief  Separable weights along one axis: output `i` sums `count[i]`
+   *          inputs from `first[i]`, weighted by `weights[i * width ...]`.
+   */
+  struct taps
+  {
+    std::vector<int>    first;
+    std::vector<int>    count;
+    std::vector<float>  weights;
+    int                 width = 0;
+  };
+
+  thread_pool&  pool_;
+  ScratchArena  arena_;
+  taps          x_taps_;
+  taps          y_taps_;
+
+  /*! \brief  Filter `_src` through `x_taps_` and `y_taps_`, into `_dst`
+   *          of the taps' output size.  `_src` and `_dst` may be the same.
+   */
+  auto convolve(const uint32_t* _src, int _src_w, int _src_h, int _src_pitch, uint32_t* _dst, int _dst_pitch) -> void;
+  auto box_pass(uint32_t* _pixels, int _w, int _h, int _pitch, int _radius) -> void;
+  /*! \brief  Chunks to split `_rows` rows into, a few per worker. */
+  auto row_chunks(int _rows) const -> std::size_t;
+};
+} /* namespace gfx */
+} /* namespace kt */
+#endif//filter_hpp_20211108_164027_PDT
@@ -0,0 +1,112 @@
+#ifndef font_hpp_20211102_201736_PDT
+#define font_hpp_20211102_201736_PDT
+#include <kt/gfx/atlas.hpp>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+namespace kt {
+namespace gfx {
+/*! \brief    Bitmap font drawn from a glyph sheet.  Glyphs are scaled to each
+ *            requested pixel size the first time it is used and packed into
+ *            an atlas; laid-out strings are cached, so redrawing an
+ *            unchanged label is a lookup and a vertex copy.  Queued text is
+ *            submitted with one geometry call per atlas page.  Sizes are
+ *            pixel heights and must be positive; calls given anything else
+ *            throw.
+ */
+class Font final
+{
+public:
+  /*! \brief  The sheet is a grid of equal cells holding consecutive
+   *          characters, left to right and top to bottom.
+   */
+  struct sheet_layout
+  {
+    int           cell_w;
+    int           cell_h;
+    unsigned char first           = ' ';
+    int           count           = 95;
+    bool          proportional    = true;   //!< Advance by each glyph's inked width, not the cell's.
+    bool          luminance_alpha = false;  //!< Light on black without alpha; coverage is brightness.
+  };
+  struct counters
+  {
+    std::size_t glyphs        = 0;  //!< Glyph images in the atlas, over all sizes.
+    std::size_t runs          = 0;  //!< Strings in the layout cache.
+    std::size_t run_hits      = 0;
+    std::size_t run_misses    = 0;
+    std::size_t last_batches  = 0;  //!< Geometry calls issued by the last flush.
+  };
+  static constexpr std::size_t default_run_cache = 4096;
+
+  Font(const Font&) = delete;
+  Font(Font&&)      = default;
+  Font(Surface _sheet, const sheet_layout& _layout);
+  static auto load_bmp(const std::string& _path, const sheet_layout& _layout) -> Font;
+
+  /*! \brief  Width in pixels of `_text` on one line at `_size` pixels high. */
+  auto measure(std::string_view _text, int _size) -> int;
+  /*! \brief  Queue `_text` as one line with its top-left corner at `_x`,
+   *          `_y`.  Glyphs are white, modulated by `_c`.
+   */
+  auto draw(std::string_view _text, float _x, float _y, int _size, Color _c = Color::white()) -> void;
+  /*! \brief  Queue `_text` wrapped by `kt::word_wrap` to `_columns`
+   *          characters, one line every `_size` pixels; newlines start a new
+   *          paragraph.
+   *  \return Height of the paragraph in pixels.
+   */
+  auto draw_paragraph(std::string_view _text, std::size_t _columns, float _x, float _y, int _size, Color _c = Color::white()) -> int;
+  /*! \brief  Upload glyphs added since the last flush and submit the queued
+   *          text, one geometry call per atlas page.
+   */
+  auto flush(Renderer& _r) -> void;
+  /*! \brief  Drop the queued text without drawing it. */
+  auto clear() -> void;
+
+  /*! \brief  Most strings kept laid out; past it the cache starts over. */
+  auto set_run_cache(std::size_t _runs) -> void;
+  auto stats() const -> counters;
+private:
+  struct ink { int left; int width; };      //!< Inked columns of a sheet cell.
+  struct glyph
+  {
+    std::size_t page;
+    SDL_Rect    rect;                       //!< Where the scaled image sits in the atlas.
+    bool        visible;                    //!< False for blank cells such as space.
+  };
+  struct placed
+  {
+    std::size_t page;
+    SDL_FRect   dest;                       //!< Relative to the run's origin.
+    SDL_FRect   uv;
+  };
+  struct run
+  {
+    std::vector<placed> glyphs;
+    int                 width = 0;
+  };
+  struct page_batch
+  {
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int>        indices;
+  };
+
+  Surface                               sheet_;
+  sheet_layout                          layout_;
+  std::vector<ink>                      ink_;
+  Atlas                                 atlas_;
+  std::unordered_map<uint64_t, glyph>   glyphs_;
+  std::unordered_map<std::string, run>  runs_;
+  std::string                           key_;       //!< Lookup key, reused to avoid allocating.
+  std::size_t                           run_cache_  = default_run_cache;
+  std::vector<page_batch>               batches_;
+  counters                              stats_;
+
+  auto advance(unsigned char _c, int _size) const -> int;
+  auto glyph_for(unsigned char _c, int _size) -> const glyph&;
+  auto layout(std::string_view _text, int _size) -> const run&;
+};
+} /* namespace gfx */
+} /* namespace kt */
+#endif//font_hpp_20211102_201736_PDT
@@ -0,0 +1,63 @@
+#ifndef frame_capture_hpp_20211031_110352_PDT
+#define frame_capture_hpp_20211031_110352_PDT
+#include <kt/gfx/surface.hpp>
+#include <kt/gfx/view.hpp>
+#include <cstdio>
+#include <iosfwd>
+#include <string>
+#include <vector>
+namespace kt {
+namespace gfx {
+/*! \brief    Reads frames back from a view into a buffer reused from frame
+ *            to frame, and writes them as PPM or PNG images or as a raw
+ *            RGBA stream piped to an encoder.
+ */
+class FrameCapture final
+{
+public:
+  FrameCapture(const FrameCapture&) = delete;
+  explicit FrameCapture(View& _view);
+  ~FrameCapture();
+
+  /*! \brief  Read the view's current frame; see `View::read_frame`. */
+  auto grab() -> const Surface&;
+  /*! \brief  The most recently grabbed frame. */
+  auto frame() const -> const Surface&;
+  auto frames_grabbed() const -> std::size_t;
+
+  /*! \brief  Grab and write a binary PPM; alpha is dropped. */
+  auto save_ppm(const std::string& _filename) -> void;
+  /*! \brief  Grab and write an RGBA PNG. */
+  auto save_png(const std::string& _filename) -> void;
+
+  /*! \brief  Start `_command` with `popen` and stream frames to its standard
+   *          input, e.g. `ffmpeg -f rawvideo -pix_fmt rgba -s 640x480 -i -
+   *          out.mp4`.
+   */
+  auto open_pipe(const std::string& _command) -> void;
+  /*! \brief  Grab and write one frame of raw RGBA to the pipe. */
+  auto pipe_frame() -> void;
+  /*! \brief  Close the pipe and wait for the command to exit. */
+  auto close_pipe() -> void;
+
+  static auto write_ppm(const Surface& _s, std::ostream& _out) -> void;
+  /*! \brief  Write `_s` as a PNG using stored (uncompressed) deflate
+   *          blocks: larger files, but no compressor to spend time in or to
+   *          depend on.
+   */
+  static auto write_png(const Surface& _s, std::ostream& _out) -> void;
+  /*! \brief  Count pixels where any channel of `_a` and `_b` differs by more
+   *          than `_tolerance`.  Surfaces of different sizes differ in
+   *          every pixel of the larger.
+   */
+  static auto diff(const Surface& _a, const Surface& _b, int _tolerance = 0) -> std::size_t;
+private:
+  View&                 view_;
+  Surface               frame_;
+  std::vector<uint8_t>  encoded_;   //!< PNG scratch, reused between saves.
+  std::FILE*            pipe_   = nullptr;
+  std::size_t           grabbed_ = 0;
+};
+} /* namespace gfx */
+} /* namespace kt */
+#endif//frame_capture_hpp_20211031_110352_PDT
@@ -0,0 +1,69 @@
+#ifndef frame_scheduler_hpp_20211021_194035_PDT
+#define frame_scheduler_hpp_20211021_194035_PDT
+#include <array>
+#include <chrono>
+namespace kt {
+namespace gfx {
+/*! \brief    Fixed-timestep clock for a render loop.  Each frame it reports how
+ *            many simulation steps of `step()` seconds are due, how far the
+ *            renderer is between the last two steps, and sleeps to hold a
+ *            target frame rate.  Catch-up is capped so a slow frame can't
+ *            snowball into ever longer ones.
+ */
+class FrameScheduler final
+{
+public:
+  using clock = std::chrono::steady_clock;
+
+  /*! \brief  Frame interval statistics over the recent window, in seconds. */
+  struct timing
+  {
+    double      mean    = 0.0;
+    double      jitter  = 0.0;  //!< Standard deviation of the interval.
+    double      max     = 0.0;
+    std::size_t frames  = 0;    //!< Frames in the window.
+  };
+  static constexpr double default_update_rate = 60.0;
+  static constexpr int    default_max_updates = 5;
+
+  /*! \brief  `_target_fps` of zero leaves the frame rate unpaced. */
+  explicit FrameScheduler(double _update_rate = default_update_rate, double _target_fps = 0.0);
+
+  auto set_update_rate(double _hz) -> void;
+  auto set_target_fps(double _fps) -> void;
+  /*! \brief  Most steps run in one frame; time beyond that is dropped. */
+  auto set_max_updates(int _n) -> void;
+
+  /*! \brief  Start a frame.
+   *  \return Number of fixed steps to simulate before rendering.
+   */
+  auto begin_frame() -> int;
+  /*! \brief  Finish a frame, sleeping until the next one is due. */
+  auto end_frame() -> void;
+  /*! \brief  Forget time that passed since the last frame, e.g. after
+   *          blocking on input.
+   */
+  auto resync() -> void;
+
+  /*! \brief  Seconds per fixed step. */
+  auto step()  const -> double;
+  /*! \brief  Fraction of a step since the last one, for interpolation. */
+  auto alpha() const -> double;
+  auto dropped_time() const -> double;
+  auto frame_timing() const -> timing;
+private:
+  static constexpr std::size_t window = 128;
+
+  double                      step_;
+  clock::duration             frame_period_ {};
+  int                         max_updates_  = default_max_updates;
+  double                      accumulator_  = 0.0;
+  double                      dropped_      = 0.0;
+  clock::time_point           last_frame_;
+  clock::time_point           next_frame_;
+  std::array<double, window>  intervals_ {};
+  std::size_t                 recorded_     = 0;
+};
+} /* namespace gfx */
+} /* namespace kt */
+#endif//frame_scheduler_hpp_20211021_194035_PDT
@@ -0,0 +1,54 @@
+#ifndef frame_stats_hpp_20211026_185547_PDT
+#define frame_stats_hpp_20211026_185547_PDT
+#include <kt/gfx/renderer.hpp>
+#include <array>
+namespace kt {
+namespace gfx {
+/*! \brief    Rolling per-frame timings and render counters, with a frame-time
+ *            histogram for percentiles and an optional on-screen graph.
+ */
+class FrameStats final
+{
+public:
+  /*! \brief  One frame; times are in seconds. */
+  struct sample
+  {
+    double                    events  = 0.0;
+    double                    update  = 0.0;
+    double                    render  = 0.0;
+    double                    present = 0.0;
+    double                    frame   = 0.0;  //!< Start of this frame to start of the next.
+    Renderer::frame_counters  counters;
+  };
+  static constexpr std::size_t  window    = 600;
+  static constexpr double       bin_width = 0.00025;
+  static constexpr std::size_t  bins      = 400;    //!< Up to 100ms; slower frames share an overflow bin.
+
+  auto record(const sample& _s) -> void;
+  auto last() const -> const sample&;
+  auto frames() const -> std::size_t;
+  /*! \brief  Frame time below which `_p` (0..1) of the window falls, to the
+   *          resolution of one histogram bin.
+   */
+  auto percentile(double _p) const -> double;
+  auto p50() const -> double;
+  auto p99() const -> double;
+  auto max() const -> double;
+
+  /*! \brief  Draw the window as a bar graph with its top-left corner at
+   *          `_x`, `_y`, in one geometry call.  Green bars fit 60Hz, yellow
+   *          fit 30Hz and red do not; the p50 and p99 marks are white and
+   *          magenta.
+   */
+  auto draw(Renderer& _r, int _x, int _y, int _height = 100) const -> void;
+private:
+  std::array<double, window>        frame_times_ {};
+  std::array<uint32_t, bins + 1>    histogram_ {};
+  std::size_t                       recorded_ = 0;
+  sample                            last_;
+
+  static auto bin(double _t) -> std::size_t;
+};
+} /* namespace gfx */
+} /* namespace kt */
+#endif//frame_stats_hpp_20211026_185547_PDT
@@ -0,0 +1,81 @@
+#ifndef indexed_surface_hpp_20211108_111945_PDT
+#define indexed_surface_hpp_20211108_111945_PDT
+#include <kt/gfx/surface.hpp>
+#include <array>
+#include <span>
+#include <vector>
+namespace kt {
+namespace gfx {
+class StreamingTexture;
+/*! \brief    CPU image of one byte per pixel, each an index into a 256 entry
+ *            palette, at a quarter of the memory of a `Surface`.  Pixels are
+ *            expanded to `default_pixel_format` only on the way to a texture
+ *            or surface, through a vectorized table lookup, so animating the
+ *            palette costs 256 writes plus the next upload.
+ */
+class IndexedSurface final
+{
+public:
+  static constexpr std::size_t palette_size = 256;
+
+  IndexedSurface(const IndexedSurface&) = delete;
+  IndexedSurface(IndexedSurface&&)      = default;
+  auto operator=(IndexedSurface&&) -> IndexedSurface& = default;
+  IndexedSurface() noexcept             = default;
+  IndexedSurface(int _w, int _h, uint8_t _index = 0);
+
+  auto reset(int _w, int _h, uint8_t _index = 0) -> void;
+  auto width()    const -> int;
+  auto height()   const -> int;
+  auto get_size() const -> Texture::size;
+  /*! \brief  Bytes per row; equal to the width. */
+  auto pitch()    const -> int;
+  auto pixels()   const -> const uint8_t*;
+  auto pixels()         ->       uint8_t*;
+  auto row(int _y) const -> const uint8_t*;
+  auto row(int _y)       ->       uint8_t*;
+
+  auto get(int _x, int _y) const -> uint8_t;
+  /*! \brief  Set one pixel; ignored outside the surface. */
+  auto set(int _x, int _y, uint8_t _index) -> void;
+  auto fill_rect(const SDL_Rect& _r, uint8_t _index) -> void;
+  auto clear(uint8_t _index = 0) -> void;
+
+  auto palette(uint8_t _index) const -> Color;
+  auto set_palette(uint8_t _index, Color _c) -> void;
+  /*! \brief  Set entries from `_first` on; extra colours are ignored. */
+  auto set_palette(std::span<const Color> _colors, uint8_t _first = 0) -> void;
+  /*! \brief  Rotate entries `_first` to `_last` inclusive by `_steps`:
+   *          entry `_first + _steps` takes the colour entry `_first` had.
+   *          Negative steps rotate the other way.
+   */
+  auto cycle(uint8_t _first, uint8_t _last, int _steps = 1) -> void;
+
+  /*! \brief  Write `_area` (the whole surface if null), translated through
+   *          the palette, to `_out` whose rows are `_pitch` bytes apart and
+   *          which holds `_area`'s pixels only.
+   */
+  auto expand(uint32_t* _out, int _pitch, const SDL_Rect* _area = nullptr) const -> void;
+  /*! \brief  Expand into `_into`, resizing it only when the size differs. */
+  auto expand(Surface& _into) const -> void;
+  /*! \brief  Expand `_area` into `_t`, which must be the same size, a band
+   *          of rows at a time.
+   */
+  auto upload(Texture& _t, const SDL_Rect* _area = nullptr) const -> void;
+  /*! \brief  Expand straight into the locked buffer of `_t`, with no
+   *          intermediate copy.
+   */
+  auto upload(StreamingTexture& _t, const SDL_Rect* _area = nullptr) const -> void;
+  auto make_texture(Renderer& _r) const -> Texture;
+private:
+  std::vector<uint8_t>              pixels_;
+  std::array<uint32_t, palette_size> palette_ {};
+  int                               width_  = 0;
+  int                               height_ = 0;
+
+  auto bounds() const -> SDL_Rect;
+  auto area_or_bounds(const SDL_Rect* _area) const -> SDL_Rect;
+};
+} /* namespace gfx */
+} /* namespace kt */
+#endif//indexed_surface_hpp_20211108_111945_PDT
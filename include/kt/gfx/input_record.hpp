@@ -0,0 +1,90 @@
+#ifndef input_record_hpp_20211101_093318_PDT
+#define input_record_hpp_20211101_093318_PDT
+#include <kt/gfx/defs.hpp>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+/*****************************************************************************
+ * input recording and replay
+ *
+ * A recording is a stream of frames.  Each frame holds the events
+ * `UserInterface::handle` routed during it (keyboard, window, controller
+ * axis and button), the number of fixed updates it ran, and its length.
+ * Replaying the frames reproduces the same events and the same updates,
+ * frame for frame, whatever the speed of the replaying machine.
+ *
+ * The file is a "KTIN" header and version byte, then records of a kind
+ * byte and a payload of LEB128 varints, signed values zigzag encoded.
+ ****************************************************************************/
+namespace kt {
+namespace gfx {
+/*! \brief    Writes frames of routed events to a recording. */
+class InputRecorder final
+{
+public:
+  InputRecorder(const InputRecorder&) = delete;
+  explicit InputRecorder(const std::string& _filename);
+  ~InputRecorder();
+
+  /*! \brief  Whether `_event` is of a kind that gets recorded. */
+  static auto records(const SDL_Event& _event) -> bool;
+  /*! \brief  Add an event to the current frame.  Axis motion replaces any
+   *          earlier motion of the same axis within the frame, so a
+   *          controller reporting at 1kHz costs one record per frame.
+   */
+  auto event(const SDL_Event& _event) -> void;
+  /*! \brief  Close the current frame, which ran `_updates` fixed steps. */
+  auto end_frame(int _updates) -> void;
+  /*! \brief  Finish the file; further frames are ignored. */
+  auto close() -> void;
+
+  auto frames() const -> std::size_t;
+private:
+  using clock = std::chrono::steady_clock;
+
+  std::ofstream             out_;
+  std::vector<SDL_Event>    pending_;
+  std::vector<uint8_t>      buffer_;
+  clock::time_point         last_frame_;
+  std::size_t               frames_ = 0;
+};
+
+/*! \brief    Reads a recording back a frame at a time. */
+class InputReplay final
+{
+public:
+  enum class pace
+  {
+    recorded    //!< Wait out each frame's recorded length.
+  , max_speed   //!< Hand frames out as fast as they are asked for.
+  };
+  struct frame
+  {
+    std::vector<SDL_Event>  events;
+    int                     updates     = 0;
+    uint64_t                duration_us = 0;
+  };
+
+  InputReplay(const InputReplay&) = delete;
+  explicit InputReplay(const std::string& _filename, pace _pace = pace::max_speed);
+
+  /*! \brief  Read the next frame into `_f`, reusing its storage.  At the
+   *          recorded pace this sleeps until the frame is due.
+   *  \return False once the recording is exhausted.
+   */
+  auto next(frame& _f) -> bool;
+  auto frames() const -> std::size_t;
+private:
+  using clock = std::chrono::steady_clock;
+
+  std::vector<uint8_t>  data_;
+  std::size_t           position_ = 0;
+  pace                  pace_;
+  clock::time_point     start_;
+  uint64_t              elapsed_us_ = 0;
+  std::size_t           frames_ = 0;
+};
+} /* namespace gfx */
+} /* namespace kt */
+#endif//input_record_hpp_20211101_093318_PDT
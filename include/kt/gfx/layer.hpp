@@ -0,0 +1,43 @@
+#ifndef layer_hpp_20211024_173012_PDT
+#define layer_hpp_20211024_173012_PDT
+#include <kt/gfx/texture.hpp>
+#include <functional>
+#include <vector>
+namespace kt {
+namespace gfx {
+/*! \brief    One level of a `View`'s layer stack.  Its content is drawn into a
+ *            cached target texture and only redrawn where it has been
+ *            invalidated.
+ */
+class Layer final
+{
+public:
+  /*! \brief  Draws the layer.  The renderer's target is the layer cache and
+   *          its clip rectangle is `_area`; anything outside is discarded, so
+   *          the callback may skip what doesn't touch `_area`.
+   */
+  using render_fn = std::function<void(Renderer& _r, const SDL_Rect& _area)>;
+
+  Layer(const Layer&) = delete;
+  explicit Layer(render_fn _fn);
+
+  /*! \brief  Redraw the whole layer on the next compose. */
+  auto invalidate() -> void;
+  /*! \brief  Redraw `_area` of the layer on the next compose. */
+  auto invalidate(const SDL_Rect& _area) -> void;
+  auto set_visible(bool _visible) -> void;
+  auto visible()  const -> bool;
+  auto is_dirty() const -> bool;
+private:
+  friend class View;
+
+  render_fn             render_;
+  Texture               cache_;
+  std::vector<SDL_Rect> damage_;
+  bool                  whole_        = true;
+  bool                  visible_      = true;
+  bool                  visibility_changed_ = false;
+};
+} /* namespace gfx */
+} /* namespace kt */
+#endif//layer_hpp_20211024_173012_PDT
@@ -0,0 +1,69 @@
+#ifndef plot_hpp_20211106_102214_PDT
+#define plot_hpp_20211106_102214_PDT
+#include <kt/gfx/color.hpp>
+#include <span>
+#include <utility>
+#include <vector>
+namespace kt {
+namespace gfx {
+class Renderer;
+/*! \brief    Time series plot for far more samples than pixels.  Samples are
+ *            summarised into a pyramid of per-block minima and maxima, each
+ *            level `fanout` times coarser than the one below, so the
+ *            envelope of any range comes from a few blocks per pixel column
+ *            and a frame costs about the same for a thousand samples as for
+ *            a hundred million.  Appending only touches the blocks the new
+ *            samples fall in.
+ */
+class Plot final
+{
+public:
+  static constexpr std::size_t fanout = 4;
+
+  struct range
+  {
+    float lo;
+    float hi;
+  };
+
+  Plot() = default;
+  explicit Plot(std::span<const float> _samples);
+
+  /*! \brief  Replace every sample and rebuild the pyramid. */
+  auto assign(std::span<const float> _samples) -> void;
+  /*! \brief  Add samples at the end. */
+  auto append(std::span<const float> _samples) -> void;
+  auto clear() -> void;
+  auto size() const -> std::size_t;
+  auto samples() const -> const std::vector<float>&;
+
+  /*! \brief  Smallest and largest sample in `[_first, _last)`, exactly. */
+  auto envelope(std::size_t _first, std::size_t _last) const -> range;
+  /*! \brief  Draw samples `[_first, _last)` across `_area`, with `_y` mapped
+   *          from the bottom of the area to the top, as one polyline in the
+   *          current draw colour.  With more samples than pixel columns,
+   *          each column spans its samples' minimum to maximum.
+   */
+  auto draw(Renderer& _r, const SDL_FRect& _area, std::size_t _first, std::size_t _last, range _y) -> void;
+  /*! \brief  Draw every sample, scaled to their own envelope. */
+  auto draw(Renderer& _r, const SDL_FRect& _area) -> void;
+private:
+  struct level
+  {
+    std::vector<float> lo;
+    std::vector<float> hi;
+  };
+
+  std::vector<float>      samples_;
+  // levels_[k] summarises blocks of fanout^(k + 1) samples
+  std::vector<level>      levels_;
+  std::vector<SDL_FPoint> points_;
+
+  auto rebuild_from(std::size_t _first_sample) -> void;
+  auto low(std::size_t _level, std::size_t _i) const -> float;
+  auto high(std::size_t _level, std::size_t _i) const -> float;
+  auto entries(std::size_t _level) const -> std::size_t;
+};
+} /* namespace gfx */
+} /* namespace kt */
+#endif//plot_hpp_20211106_102214_PDT
@@ -1,15 +1,40 @@
 #ifndef renderer_hpp_20210924_181737_PDT
 #define renderer_hpp_20210924_181737_PDT
 #include <kt/gfx/texture.hpp>
+#include <optional>
 namespace kt {
 namespace gfx {
 class Renderer final
 {
 public:
   static constexpr uint32_t default_flags = SDL_RENDERER_ACCELERATED | SDL_RENDERER_TARGETTEXTURE | SDL_RENDERER_PRESENTVSYNC;
+
+  /*! \brief  Render state changes seen during one frame. */
+  struct state_counters
+  {
+    std::size_t issued = 0;   //!< Changes forwarded to SDL.
+    std::size_t elided = 0;   //!< Redundant changes that were skipped.
+  };
+  /*! \brief  Work submitted during one frame.  Counting is a handful of
+   *          increments per call, cheap enough to leave on.
+   */
+  struct frame_counters
+  {
+    std::size_t     draw_calls        = 0;  //!< SDL draw calls issued.
+    std::size_t     primitives        = 0;  //!< Points, lines, rects, copies and triangles.
+    std::size_t     copies            = 0;  //!< Texture copies.
+    std::size_t     textures_created  = 0;
+    std::size_t     bytes_uploaded    = 0;  //!< Pixel bytes sent to textures.
+    state_counters  state;
+  };
+
   Renderer(const Renderer&) = delete;
   Renderer(Renderer&&)      = default;
   Renderer(SDL_Window*, int _index = -1, uint32_t _flags = default_flags);
+  /*! \brief  Software renderer drawing straight into `_target`, which must
+   *          outlive it.  Needs no video driver and never waits for vsync.
+   */
+  explicit Renderer(SDL_Surface* _target);
   ~Renderer();
 
   auto get() -> SDL_Renderer*;
@@ -24,6 +49,9 @@ public:
   auto point(int, int) -> void;
   auto line(int, int, int, int) -> void;
   auto line_f(float, float, float, float) -> void;
+  /*! \brief  Connected segments through `_count` points, in one call. */
+  auto lines_f(const SDL_FPoint* _points, int _count) -> void;
+  auto fill_rect(const SDL_Rect& _r) -> void;
 
   auto circle(int _cx, int _cy, int _radius, bool _fill = false) -> void;
   auto circle_fill(int _cx, int _cy, int _radius) -> void;
@@ -31,6 +59,10 @@ public:
   auto set_target(Texture& t) -> void;
   auto set_default_target() -> void;
 
+  auto set_clip(const SDL_Rect& _clip) -> void;
+  auto clear_clip() -> void;
+  auto set_scale(float _sx, float _sy) -> void;
+
   auto copy(const Texture& t) -> void;
   auto copy(const Texture& t, SDL_Rect& _dest) -> void;
   auto copy(const Texture& t, SDL_Rect& _src, SDL_Rect& _dest) -> void;
@@ -38,12 +70,86 @@ public:
   auto copy(const Texture& t, int _x, int _y, double _angle) -> void;
   auto copy(const Texture& _t, SDL_Rect& _src, SDL_Rect& _dest, double _angle) -> void;
 
+  /*! \brief  Draw indexed triangles in one call; `_t` may be null. */
+  auto geometry(const Texture* _t, const SDL_Vertex* _vertices, int _num_vertices, const int* _indices, int _num_indices) -> void;
+
   auto set_draw_blend(SDL_BlendMode) -> void;
 
+  /*! \brief  State change counters for the most recently presented frame. */
+  auto state_changes() const -> state_counters;
+  /*! \brief  All counters for the most recently presented frame. */
+  auto frame_stats() const -> const frame_counters&;
+  /*! \brief  Called by `Texture` to account for work done on its behalf. */
+  auto count_texture_created() -> void;
+  auto count_upload(std::size_t _bytes) -> void;
+  /*! \brief  Forget the shadowed render state, so the next change of each
+   *          kind is always forwarded.  Call this after using `get()` to
+   *          change renderer state behind our back.
+   */
+  auto invalidate_state() -> void;
+  /*! \brief  Called by `Texture` when it destroys `_t`; SDL silently
+   *          resets the render target if `_t` was bound.
+   */
+  auto forget(SDL_Texture* _t) -> void;
+
 private:
-  SDL_Renderer* renderer_ = nullptr;
+  // SDL saves the window's clip and scale while a texture is bound and
+  // restores them when the window is bound again; every texture bind starts
+  // with no clip and a scale of 1.  Mirror that here.
+  struct clip_state
+  {
+    bool      enabled;
+    SDL_Rect  rect;
+    auto operator==(const clip_state& _c) const -> bool
+      {
+        return enabled == _c.enabled
+            && (!enabled || (rect.x == _c.rect.x && rect.y == _c.rect.y && rect.w == _c.rect.w && rect.h == _c.rect.h));
+      }
+  };
+  struct target_state
+  {
+    std::optional<clip_state>               clip;
+    std::optional<std::pair<float, float>>  scale;
+  };
+  struct render_state
+  {
+    std::optional<Color>          color;
+    std::optional<SDL_BlendMode>  blend;
+    std::optional<SDL_Texture*>   target;
+    target_state                  window;
+    target_state                  texture;
+  };
+
+  SDL_Renderer*   renderer_ = nullptr;
+  render_state    state_;
+  frame_counters  frame_;
+  frame_counters  last_frame_;
 
   auto release() -> void;
+  auto bind_target(SDL_Texture*) -> void;
+  auto current_target_state() -> target_state&;
+  auto count_draw(std::size_t _primitives = 1) -> void
+    {
+      ++frame_.draw_calls;
+      frame_.primitives += _primitives;
+    }
+  auto count_copy() -> void
+    {
+      count_draw();
+      ++frame_.copies;
+    }
+  template<typename T, typename FnT>
+    auto apply(std::optional<T>& _shadow, const T& _value, FnT&& _issue) -> void
+    {
+      if(_shadow && *_shadow == _value)
+      {
+        ++frame_.state.elided;
+        return;
+      }
+      _issue();
+      _shadow = _value;
+      ++frame_.state.issued;
+    }
 };
 } /* namespace gfx */
 } /* namespace kt */
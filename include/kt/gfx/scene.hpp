@@ -0,0 +1,95 @@
+#ifndef scene_hpp_20211107_094501_PDT
+#define scene_hpp_20211107_094501_PDT
+#include <kt/gfx/color.hpp>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+namespace kt {
+namespace gfx {
+class Renderer;
+/*! \brief    Retained set of drawable items indexed by a sparse uniform grid
+ *            of world-space cells.  Drawing visits only the cells the camera
+ *            touches, so a frame costs about what is on screen however large
+ *            the world gets.  Moving an item within its cells only updates
+ *            its bounds; crossing a cell boundary re-files it in the few
+ *            cells involved.  Items too large for the grid are kept aside
+ *            and tested on every query.
+ */
+class Scene final
+{
+public:
+  using id = uint32_t;
+  /*! \brief  Draws an item at `_dest`, its bounds in screen coordinates. */
+  using draw_fn = std::function<void(Renderer& _r, const SDL_FRect& _dest)>;
+
+  static constexpr float  default_cell_size = 256.0f;
+  static constexpr int    max_cell_span     = 8;    //!< Cells per axis before an item is kept aside.
+
+  struct counters
+  {
+    std::size_t items     = 0;
+    std::size_t cells     = 0;  //!< Occupied cells.
+    std::size_t visited   = 0;  //!< Cell entries the last query looked at.
+    std::size_t visible   = 0;  //!< Items the last query returned.
+  };
+
+  Scene(const Scene&) = delete;
+  explicit Scene(float _cell_size = default_cell_size);
+
+  /*! \brief  Add an item covering `_bounds` (world pixels).  Items draw in
+   *          increasing `_z`, then in the order they were inserted.
+   */
+  auto insert(const SDL_FRect& _bounds, draw_fn _draw, int _z = 0) -> id;
+  /*! \brief  Move or resize `_item`.  Ids already removed are ignored, as
+   *          by `remove`.
+   */
+  auto move(id _item, const SDL_FRect& _bounds) -> void;
+  auto remove(id _item) -> void;
+  auto clear() -> void;
+  auto bounds(id _item) const -> const SDL_FRect&;
+
+  /*! \brief  Items whose bounds intersect `_area`, in draw order. */
+  auto query(const SDL_FRect& _area, std::vector<id>& _out) -> void;
+  /*! \brief  Draw the items `_camera` (world pixels) sees, with the camera's
+   *          top-left corner at `_x`, `_y` of the current target.  The
+   *          callbacks must not insert or remove items.
+   */
+  auto draw(Renderer& _r, const SDL_FRect& _camera, float _x = 0.0f, float _y = 0.0f) -> void;
+
+  auto stats() const -> counters;
+private:
+  struct span
+  {
+    int x1, y1, x2, y2;   //!< Cells covered, inclusive; x1 > x2 when kept aside.
+  };
+  struct item
+  {
+    SDL_FRect bounds;
+    span      cells;
+    draw_fn   draw;
+    int       z;
+    uint64_t  order;
+    uint32_t  stamp;
+    bool      live;
+  };
+
+  float                                           cell_size_;
+  std::vector<item>                               items_;
+  std::vector<id>                                 free_;
+  std::unordered_map<uint64_t, std::vector<id>>   cells_;
+  std::vector<id>                                 large_;
+  std::vector<id>                                 visible_;
+  uint64_t                                        next_order_ = 0;
+  uint32_t                                        stamp_      = 0;
+  counters                                        stats_;
+
+  auto cells_of(const SDL_FRect& _bounds) const -> span;
+  /*! \brief  Cells an item is filed under, or kept aside if too many. */
+  auto filed_cells(const SDL_FRect& _bounds) const -> span;
+  auto file(id _item, const span& _cells) -> void;
+  auto unfile(id _item, const span& _cells) -> void;
+};
+} /* namespace gfx */
+} /* namespace kt */
+#endif//scene_hpp_20211107_094501_PDT
@@ -0,0 +1,58 @@
+#ifndef sprite_batch_hpp_20211016_160811_PDT
+#define sprite_batch_hpp_20211016_160811_PDT
+#include <kt/gfx/atlas.hpp>
+#include <vector>
+namespace kt {
+namespace gfx {
+/*! \brief    Collects textured quads and submits each run that shares a
+ *            texture with a single `SDL_RenderGeometry` call.  Draw order is
+ *            kept: a texture change starts a new run.
+ */
+class SpriteBatch final
+{
+public:
+  SpriteBatch() = default;
+
+  /*! \brief  Queue `_src` of `_t` drawn into `_dest`, rotated clockwise by
+   *          `_angle` degrees about the centre of `_dest` and modulated by
+   *          `_tint`.  `_t` is kept by address until the next flush or
+   *          clear, so it must stay put until then; atlas pages do.
+   */
+  auto draw
+      ( const Texture&  _t
+      , const SDL_Rect& _src
+      , const SDL_FRect& _dest
+      , double          _angle = 0.0
+      , Color           _tint  = Color::white()
+      ) -> void;
+  /*! \brief  Queue an atlas region at its natural size. */
+  auto draw
+      ( const Atlas&          _atlas
+      , const Atlas::region&  _region
+      , float                 _x
+      , float                 _y
+      , double                _angle = 0.0
+      , Color                 _tint  = Color::white()
+      ) -> void;
+  /*! \brief  Submit everything queued since the last flush. */
+  auto flush(Renderer&) -> void;
+  auto clear() -> void;
+
+  auto sprites() const -> std::size_t;
+  /*! \brief  Geometry calls issued by the last flush. */
+  auto last_batches() const -> std::size_t;
+private:
+  struct run
+  {
+    const Texture*  texture;
+    std::size_t     first_index;
+    std::size_t     index_count;
+  };
+  std::vector<SDL_Vertex> vertices_;
+  std::vector<int>        indices_;
+  std::vector<run>        runs_;
+  std::size_t             last_batches_ = 0;
+};
+} /* namespace gfx */
+} /* namespace kt */
+#endif//sprite_batch_hpp_20211016_160811_PDT
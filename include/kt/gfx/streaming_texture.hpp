@@ -0,0 +1,90 @@
+#ifndef streaming_texture_hpp_20211105_141052_PDT
+#define streaming_texture_hpp_20211105_141052_PDT
+#include <kt/gfx/texture.hpp>
+#include <optional>
+#include <vector>
+namespace kt {
+namespace gfx {
+/*! \brief    Texture for pixels produced on the CPU every frame: video,
+ *            simulation grids, software-rendered layers.  It holds a ring of
+ *            `SDL_TEXTUREACCESS_STREAMING` textures; each `lock` hands out
+ *            the one drawn longest ago, so writing never waits on a texture
+ *            the GPU may still be reading, and `front` is whichever was
+ *            unlocked last.
+ *
+ *            Locked memory is write-only and each texture in the ring only
+ *            sees the updates made through it.  A partial lock therefore
+ *            grows to also cover whatever the other textures were given
+ *            since this one was last written, and the caller must write
+ *            every pixel of the area it gets back.
+ */
+class StreamingTexture final
+{
+public:
+  static constexpr int default_buffers = 2;
+
+  /*! \brief  Memory of a locked texture, `pitch` bytes per row. */
+  struct locked
+  {
+    uint32_t* pixels;
+    int       pitch;
+    SDL_Rect  area;   //!< What must be written; holds at least the area asked for.
+    auto row(int _y) const -> uint32_t*
+      {
+        return reinterpret_cast<uint32_t*>(reinterpret_cast<unsigned char*>(pixels) + std::size_t(_y) * std::size_t(pitch));
+      }
+  };
+  struct counters
+  {
+    std::size_t frames          = 0;  //!< Unlocks so far.
+    std::size_t bytes_uploaded  = 0;  //!< Bytes written through locks so far.
+    std::size_t bytes_extra     = 0;  //!< Of those, bytes locks grew by to catch up.
+  };
+
+  StreamingTexture(const StreamingTexture&) = delete;
+  /*! \brief  `_buffers` textures of `_w` by `_h`; two keep the CPU one frame
+   *          ahead of the GPU, three absorb an occasional slow frame.
+   */
+  StreamingTexture(Renderer& _r, int _w, int _h, int _buffers = default_buffers);
+  ~StreamingTexture();
+
+  /*! \brief  Lock the next texture in the ring over `_area`, or all of it.
+   *          Only one lock may be held at a time.
+   */
+  auto lock(const SDL_Rect* _area = nullptr) -> locked;
+  /*! \brief  Unlock, making the locked texture the front. */
+  auto unlock() -> void;
+  /*! \brief  Lock, copy `_dirty` (or everything) out of `_frame`, a whole
+   *          frame laid out `_pitch` bytes per row, and unlock.
+   */
+  auto upload(const uint32_t* _frame, int _pitch, const SDL_Rect* _dirty = nullptr) -> void;
+
+  /*! \brief  The most recently unlocked texture, for drawing. */
+  auto front() const -> const Texture&;
+  auto set(SDL_BlendMode) -> void;
+  auto get_size() const -> Texture::size;
+  auto buffers()  const -> int;
+  auto stats()    const -> counters;
+private:
+  struct buffer
+  {
+    Texture                 texture;
+    // updates made through the other buffers since this one was written
+    std::optional<SDL_Rect> stale;
+  };
+  struct lock_state
+  {
+    SDL_Rect  area;   // locked
+    SDL_Rect  asked;  // of that, what the caller asked for
+  };
+
+  Renderer*                 renderer_;
+  std::vector<buffer>       ring_;
+  std::size_t               front_  = 0;
+  std::size_t               next_   = 0;
+  std::optional<lock_state> locked_;
+  counters                  stats_;
+};
+} /* namespace gfx */
+} /* namespace kt */
+#endif//streaming_texture_hpp_20211105_141052_PDT
@@ -0,0 +1,89 @@
+#ifndef surface_hpp_20211013_190412_PDT
+#define surface_hpp_20211013_190412_PDT
+#include <kt/gfx/texture.hpp>
+#include <optional>
+#include <string>
+#include <vector>
+namespace kt {
+namespace gfx {
+/*! \brief    CPU pixel buffer in `default_pixel_format` with the same drawing
+ *            primitives as `Renderer`, for hosts without a GPU.  Large fills
+ *            and blits are vectorized and split by rows across
+ *            `kt::thread_pool::shared()`.
+ */
+class Surface final
+{
+public:
+  Surface(const Surface&) = delete;
+  Surface(Surface&&)      = default;
+  auto operator=(Surface&&) -> Surface& = default;
+  Surface() noexcept      = default;
+  Surface(Texture::size);
+  Surface(int _w, int _h);
+  Surface(int _w, int _h, Color _c);
+  /*! \brief  Decode a BMP file, converted to the default pixel format. */
+  static auto load_bmp(const std::string& _path) -> Surface;
+
+  auto reset(int _w, int _h) -> void;
+  auto width()    const -> int;
+  auto height()   const -> int;
+  auto get_size() const -> Texture::size;
+  /*! \brief  Bytes per row. */
+  auto pitch()    const -> int;
+  auto pixels()   const -> const uint32_t*;
+  auto pixels()         ->       uint32_t*;
+  auto row(int _y) const -> const uint32_t*;
+  auto row(int _y)       ->       uint32_t*;
+
+  auto clear() -> void;
+  auto color(uint8_t) -> void;
+  auto color(uint8_t, uint8_t, uint8_t) -> void;
+  auto color(uint8_t, uint8_t, uint8_t, uint8_t) -> void;
+  auto color(const Color& c) -> void;
+  auto get_color() -> Color;
+  auto point(int, int) -> void;
+  auto line(int, int, int, int) -> void;
+  auto line_f(float, float, float, float) -> void;
+  auto fill_rect(const SDL_Rect& _r) -> void;
+
+  auto circle(int _cx, int _cy, int _radius, bool _fill = false) -> void;
+  auto circle_fill(int _cx, int _cy, int _radius) -> void;
+
+  auto set_clip(const SDL_Rect& _clip) -> void;
+  auto clear_clip() -> void;
+
+  auto copy(const Surface& s) -> void;
+  auto copy(const Surface& s, SDL_Rect& _dest) -> void;
+  auto copy(const Surface& s, SDL_Rect& _src, SDL_Rect& _dest) -> void;
+  auto copy(const Surface& s, int _x, int _y) -> void;
+  auto copy(const Surface& s, int _x, int _y, double _angle) -> void;
+  auto copy(const Surface& _s, SDL_Rect& _src, SDL_Rect& _dest, double _angle) -> void;
+
+  /*! \brief  Store `_s` at `_x`, `_y` verbatim, ignoring blend modes and the
+   *          clip rectangle.
+   */
+  auto write(const Surface& _s, int _x, int _y) -> void;
+
+  /*! \brief  Blend mode used for drawing primitives onto this surface. */
+  auto set_draw_blend(SDL_BlendMode) -> void;
+  /*! \brief  Blend mode used when this surface is the source of a copy. */
+  auto set(SDL_BlendMode) -> void;
+
+  /*! \brief  Write the pixels into `_t`, which must be the same size. */
+  auto upload(Texture& _t) const -> void;
+  auto make_texture(Renderer&) const -> Texture;
+private:
+  std::vector<uint32_t>   pixels_;
+  int                     width_      = 0;
+  int                     height_     = 0;
+  Color                   color_      = Color::black();
+  SDL_BlendMode           draw_blend_ = SDL_BLENDMODE_NONE;
+  SDL_BlendMode           blend_      = SDL_BLENDMODE_BLEND;
+  std::optional<SDL_Rect> clip_;
+
+  auto bounds() const -> SDL_Rect;
+  auto span(int _x1, int _x2, int _y) -> void;
+};
+} /* namespace gfx */
+} /* namespace kt */
+#endif//surface_hpp_20211013_190412_PDT
@@ -0,0 +1,106 @@
+#ifndef terminal_view_hpp_20211109_201533_PDT
+#define terminal_view_hpp_20211109_201533_PDT
+#include <kt/gfx/surface.hpp>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+namespace kt {
+namespace gfx {
+/*! \brief    Shows frames in a terminal, for watching a headless renderer
+ *            over SSH.  In `half_block` mode each character cell is two
+ *            pixels, drawn as an upper half block with 24-bit foreground
+ *            and background colours; only cells whose colours changed since
+ *            they were last sent are written.  In `sixel` mode the frame is
+ *            sent as a 216 colour sixel image, and only when it changed.
+ *
+ *            Frames are scaled to fit the terminal, keeping their aspect,
+ *            and an optional bandwidth cap holds back output over slow
+ *            links: changed cells past the budget wait for later frames,
+ *            picked up from where the last frame stopped; sixel frames are
+ *            dropped until the budget recovers.
+ */
+class TerminalView final
+{
+public:
+  enum class mode
+  {
+    half_block,
+    sixel,
+  };
+  struct counters
+  {
+    std::size_t frames    = 0;
+    std::size_t cells     = 0;  //!< Cells written by the last frame.
+    std::size_t deferred  = 0;  //!< Changed cells the last frame held back.
+    std::size_t skipped   = 0;  //!< Frames not sent for lack of budget.
+    std::size_t bytes     = 0;  //!< Written so far.
+  };
+
+  TerminalView(const TerminalView&) = delete;
+  explicit TerminalView(std::FILE* _out = stdout, mode _mode = mode::half_block);
+  /*! \brief  Restores the cursor and colours if anything was drawn. */
+  ~TerminalView();
+
+  /*! \brief  Ask the terminal on standard input and output whether it
+   *          understands sixel, waiting up to `_timeout_ms` for the answer.
+   *          False when either isn't a terminal.
+   */
+  static auto probe_sixel(int _timeout_ms = 100) -> bool;
+
+  auto set_mode(mode _mode) -> void;
+  /*! \brief  Draw into `_columns` by `_rows` cells; zero follows the
+   *          terminal's size.
+   */
+  auto set_size(int _columns, int _rows) -> void;
+  /*! \brief  Most bytes to write per second on average; zero for no cap. */
+  auto set_bandwidth(std::size_t _bytes_per_second) -> void;
+  /*! \brief  Treat cells as unchanged while no channel moved more than
+   *          `_tolerance`, so noise doesn't cost bandwidth.
+   */
+  auto set_tolerance(int _tolerance) -> void;
+  /*! \brief  Clear the screen and redraw every cell on the next frame. */
+  auto invalidate() -> void;
+
+  auto present(const uint32_t* _pixels, int _w, int _h, int _pitch) -> void;
+  auto present(const Surface& _s) -> void;
+  /*! \brief  Read `_t`, which must have target access, back and present it.
+   *          Leaves the default render target bound.
+   */
+  auto present(Renderer& _r, Texture& _t) -> void;
+
+  auto stats() const -> counters;
+private:
+  using clock = std::chrono::steady_clock;
+
+  std::FILE*              out_;
+  mode                    mode_;
+  int                     columns_    = 0;
+  int                     rows_       = 0;
+  std::size_t             bandwidth_  = 0;
+  int                     tolerance_  = 0;
+  double                  budget_     = 0.0;
+  clock::time_point       refilled_;
+  Surface                 scaled_;
+  Surface                 readback_;
+  std::vector<uint64_t>   shown_;       //!< Top and bottom colour per cell.
+  int                     shown_columns_ = 0;
+  int                     shown_rows_    = 0;
+  std::size_t             resume_     = 0;
+  std::vector<uint8_t>    sixel_frame_;
+  std::vector<uint8_t>    sixel_bits_;
+  std::string             buffer_;
+  bool                    started_    = false;
+  bool                    clear_      = true;
+  counters                stats_;
+
+  auto terminal_size() const -> std::pair<int, int>;
+  auto refill() -> void;
+  auto scale(const uint32_t* _pixels, int _w, int _h, int _pitch, int _max_w, int _max_h) -> void;
+  auto present_cells(int _columns, int _rows) -> void;
+  auto present_sixel() -> void;
+  auto write() -> void;
+};
+} /* namespace gfx */
+} /* namespace kt */
+#endif//terminal_view_hpp_20211109_201533_PDT
@@ -11,6 +11,7 @@ public:
   static constexpr int default_access = SDL_TEXTUREACCESS_STATIC | SDL_TEXTUREACCESS_TARGET;
   Texture(const Texture&) = delete;
   Texture(Texture&&);
+  auto operator=(Texture&&) -> Texture&;
   Texture() noexcept      = default;
 
   Texture(Renderer&, size, int access = default_access);
@@ -19,12 +20,28 @@ public:
   Texture(Renderer&, const std::string& _path);
   ~Texture();
 
-  auto reset(Renderer&, int _w, int _h, int _access = default_access) -> void;
+  /*! \brief  (Re)create the texture; an existing texture that already has
+   *          this size, access and format is kept as it is.
+   */
+  auto reset(Renderer&, int _w, int _h, int _access = default_access, uint32_t _format = default_pixel_format) -> void;
+  /*! \brief  Fill with `_c`; leaves this texture bound as the render target. */
+  auto clear(Renderer&, Color _c) -> void;
   auto set(SDL_BlendMode) -> void;
+  /*! \brief  Replace the pixels of `_area`, or of the whole texture if it is
+   *          null, with `_pixels` laid out `_pitch` bytes per row.
+   */
+  auto update(const void* _pixels, int _pitch, const SDL_Rect* _area = nullptr) -> void;
   auto get() const ->       SDL_Texture*;
   auto get_size() const -> size;
+  auto format()   const -> uint32_t;
+  auto access()   const -> int;
 private:
-  mutable SDL_Texture*  texture_ = nullptr;
+  mutable SDL_Texture*  texture_  = nullptr;
+  Renderer*             renderer_ = nullptr;
+  // cached at creation so drawing never has to query SDL
+  size                  size_     = { 0, 0 };
+  uint32_t              format_   = SDL_PIXELFORMAT_UNKNOWN;
+  int                   access_   = 0;
 
   auto release() -> void;
 };
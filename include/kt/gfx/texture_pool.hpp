@@ -0,0 +1,107 @@
+#ifndef texture_pool_hpp_20211019_221903_PDT
+#define texture_pool_hpp_20211019_221903_PDT
+#include <kt/gfx/texture.hpp>
+#include <list>
+#include <unordered_map>
+#include <vector>
+namespace kt {
+namespace gfx {
+/*! \brief    Recycles textures by size, format and access, so temporary render
+ *            targets don't cost a driver allocation every frame.  Idle
+ *            textures are kept in least-recently-used order and trimmed to
+ *            stay under a memory budget.  A recycled texture keeps whatever
+ *            pixels and blend mode its last user left behind.
+ */
+class TexturePool final
+{
+public:
+  struct key
+  {
+    int       w;
+    int       h;
+    uint32_t  format;
+    int       access;
+    auto operator==(const key&) const -> bool = default;
+  };
+  struct counters
+  {
+    std::size_t hits            = 0;  //!< Acquires served from the pool.
+    std::size_t misses          = 0;  //!< Acquires that created a texture.
+    std::size_t evictions       = 0;  //!< Idle textures destroyed by trimming.
+    std::size_t bytes_idle      = 0;  //!< Bytes held by idle textures.
+    std::size_t bytes_leased    = 0;  //!< Bytes held by outstanding leases.
+    auto bytes_resident() const -> std::size_t { return bytes_idle + bytes_leased; }
+  };
+  /*! \brief  A pooled texture that goes back to the pool when destroyed. */
+  class lease final
+  {
+  public:
+    lease(const lease&) = delete;
+    lease(lease&&);
+    ~lease();
+    auto operator=(lease&&) -> lease&;
+
+    auto get()       ->       Texture&  { return texture_; }
+    auto get() const -> const Texture&  { return texture_; }
+    auto operator*()  -> Texture&       { return texture_; }
+    auto operator->() -> Texture*       { return &texture_; }
+  private:
+    friend class TexturePool;
+    lease(TexturePool& _pool, Texture&& _t);
+    TexturePool*  pool_;
+    Texture       texture_;
+
+    auto give_back() -> void;
+  };
+  static constexpr std::size_t default_budget = std::size_t(256) << 20;
+
+  TexturePool(const TexturePool&) = delete;
+  /*! \brief  Moving keeps the renderer and idle textures; leases still out
+   *          point at the old pool, so return them first.
+   */
+  TexturePool(TexturePool&&) = default;
+  auto operator=(TexturePool&&) -> TexturePool& = default;
+  explicit TexturePool(Renderer& _r, std::size_t _budget_bytes = default_budget);
+
+  /*! \brief  An idle texture matching the request, or a new one. */
+  auto acquire(int _w, int _h, int _access = Texture::default_access, uint32_t _format = default_pixel_format) -> Texture;
+  /*! \brief  Return a texture for reuse; trims if over budget. */
+  auto release(Texture&& _t) -> void;
+  auto lease_texture(int _w, int _h, int _access = Texture::default_access, uint32_t _format = default_pixel_format) -> lease;
+
+  auto set_budget(std::size_t _bytes) -> void;
+  auto budget() const -> std::size_t;
+  /*! \brief  Destroy least recently used idle textures until resident bytes
+   *          fit the budget.
+   */
+  auto trim() -> void;
+  /*! \brief  Destroy every idle texture. */
+  auto clear() -> void;
+  auto stats() const -> const counters&;
+  auto idle() const -> std::size_t;
+
+  static auto bytes(const Texture& _t) -> std::size_t;
+private:
+  struct key_hash
+  {
+    auto operator()(const key& _k) const -> std::size_t;
+  };
+  struct slot
+  {
+    key     k;
+    Texture texture;
+  };
+  using lru_list = std::list<slot>;
+
+  Renderer*                                                         renderer_;
+  std::size_t                                                       budget_;
+  counters                                                          stats_;
+  lru_list                                                          lru_;     // most recent at the front
+  std::unordered_map<key, std::vector<lru_list::iterator>, key_hash>  idle_;
+
+  static auto key_of(const Texture& _t) -> key;
+  auto evict_oldest() -> void;
+};
+} /* namespace gfx */
+} /* namespace kt */
+#endif//texture_pool_hpp_20211019_221903_PDT
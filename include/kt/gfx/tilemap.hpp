@@ -0,0 +1,102 @@
+#ifndef tilemap_hpp_20211103_190524_PDT
+#define tilemap_hpp_20211103_190524_PDT
+#include <kt/gfx/texture_pool.hpp>
+#include <optional>
+#include <vector>
+namespace kt {
+namespace gfx {
+/*! \brief    Tile world drawn from baked chunks.  The world is split into
+ *            square chunks of tiles; each chunk near the camera is drawn
+ *            once into a pooled render target and then copied whole, so a
+ *            frame costs one copy per visible chunk whatever the tile count.
+ *            Changing a tile rebakes only its chunk.  Baked chunks away
+ *            from the camera are released, least recently seen first, to
+ *            stay under a memory budget.
+ */
+class TileMap final
+{
+public:
+  using tile_t = uint16_t;
+  static constexpr tile_t       none                = 0;    //!< Tile `n` draws sheet cell `n - 1`.
+  static constexpr int          default_chunk_tiles = 32;
+  static constexpr std::size_t  default_budget      = std::size_t(64) << 20;
+
+  struct counters
+  {
+    std::size_t visible   = 0;  //!< Chunks drawn by the last `draw`.
+    std::size_t baked     = 0;  //!< Chunks baked by the last `prepare`.
+    std::size_t resident  = 0;  //!< Chunks holding a baked texture.
+    std::size_t evicted   = 0;  //!< Baked chunks released so far.
+  };
+
+  TileMap(const TileMap&) = delete;
+  TileMap(TexturePool& _pool, int _w, int _h, int _tile_w, int _tile_h, int _chunk_tiles = default_chunk_tiles);
+
+  /*! \brief  Sheet whose grid of `tile_w` by `tile_h` cells the tiles index.
+   *          It must outlive the map; every chunk is rebaked.
+   */
+  auto set_tileset(const Texture& _sheet) -> void;
+  auto set(int _x, int _y, tile_t _tile) -> void;
+  auto get(int _x, int _y) const -> tile_t;
+  /*! \brief  Set every tile in `_area`, given in tiles. */
+  auto fill(const SDL_Rect& _area, tile_t _tile) -> void;
+
+  /*! \brief  Most bytes of baked chunks to keep. */
+  auto set_budget(std::size_t _bytes) -> void;
+  /*! \brief  Chunks beyond the camera to bake ahead of time, and how many of
+   *          those to bake in one frame.
+   */
+  auto set_prefetch(int _margin_chunks, int _per_frame) -> void;
+
+  /*! \brief  Bake dirty or missing chunks that `_camera` (world pixels)
+   *          sees, prefetch around it and trim to the budget.  Binds chunk
+   *          textures as targets, so call it before setting up the target
+   *          `draw` should go to.
+   */
+  auto prepare(Renderer& _r, const SDL_Rect& _camera) -> void;
+  /*! \brief  Copy the chunks `_camera` sees to the current target, with the
+   *          camera's top-left corner at `_x`, `_y`.  Chunks `prepare` has
+   *          not baked are skipped.
+   */
+  auto draw(Renderer& _r, const SDL_Rect& _camera, int _x = 0, int _y = 0) -> void;
+
+  auto width()  const -> int;
+  auto height() const -> int;
+  auto stats() const -> counters;
+private:
+  struct chunk
+  {
+    std::optional<TexturePool::lease> baked;
+    bool                              dirty     = true;
+    uint64_t                          last_seen = 0;
+  };
+
+  TexturePool*              pool_;
+  const Texture*            sheet_      = nullptr;
+  int                       width_;
+  int                       height_;
+  int                       tile_w_;
+  int                       tile_h_;
+  int                       chunk_tiles_;
+  int                       chunks_x_;
+  int                       chunks_y_;
+  std::vector<tile_t>       tiles_;
+  std::vector<chunk>        chunks_;
+  std::vector<std::size_t>  resident_;
+  std::size_t               budget_     = default_budget;
+  int                       margin_     = 1;
+  int                       per_frame_  = 2;
+  uint64_t                  frame_      = 0;
+  counters                  stats_;
+
+  auto chunk_pixels_w() const -> int;
+  auto chunk_pixels_h() const -> int;
+  auto chunk_bytes() const -> std::size_t;
+  /*! \brief  Chunk columns and rows `_camera` touches, grown by `_margin`. */
+  auto chunk_range(const SDL_Rect& _camera, int _margin) const -> SDL_Rect;
+  auto bake(Renderer& _r, std::size_t _index) -> void;
+  auto evict(std::size_t _index) -> void;
+};
+} /* namespace gfx */
+} /* namespace kt */
+#endif//tilemap_hpp_20211103_190524_PDT
@@ -1,6 +1,11 @@
 #ifndef ui_hpp_20210914_162913_PDT
 #define ui_hpp_20210914_162913_PDT
 #include "view.hpp"
+#include "frame_scheduler.hpp"
+#include "frame_stats.hpp"
+#include "draw_list.hpp"
+#include "input_record.hpp"
+#include <memory>
 namespace kt {
 namespace gfx {
 class UserInterface
@@ -13,6 +18,10 @@ public:
   UserInterface();
   UserInterface(int, int);
 
+  /*! \brief  Run the frame loop until `quit()`.  Each drawn frame is
+   *          presented once, after `do_render` and the frame-stats overlay;
+   *          `do_render` draws but leaves presenting to the loop.
+   */
   auto start() -> void;
 
   auto view() const -> const View& { return view_; }
@@ -22,10 +31,56 @@ public:
   auto restart() -> void;
 
   auto is_restarting() -> bool;
+
+  auto scheduler() -> FrameScheduler& { return scheduler_; }
+  /*! \brief  In idle mode frames are only drawn after input or
+   *          `request_redraw()`; in between the loop blocks in
+   *          `SDL_WaitEventTimeout` for up to `_timeout_ms`, and the fixed
+   *          step clock does not advance while blocked.
+   */
+  auto set_idle(bool _idle, int _timeout_ms = default_idle_timeout_ms) -> void;
+  auto request_redraw() -> void;
+  /*! \brief  How far rendering is between the last two `on_update` steps. */
+  auto interpolation_alpha() const -> double;
+
+  /*! \brief  Timings and render counters of recently drawn frames. */
+  auto frame_stats() const -> const FrameStats& { return frame_stats_; }
+  /*! \brief  Draw the frame-time graph over each frame. */
+  auto show_frame_stats(bool _show) -> void;
+  /*! \brief  Scene recording spread over the shared thread pool.  Tasks
+   *          added during `do_render` are recorded in parallel and, unless
+   *          `do_render` submits them itself, submitted in order when it
+   *          returns.
+   */
+  auto recorder() -> DrawRecorder& { return recorder_; }
+
+  /*! \brief  Record routed input and each frame's update count to
+   *          `_filename`, until `stop_input()`.
+   */
+  auto record_input(const std::string& _filename) -> void;
+  /*! \brief  Drive the loop from a recording instead of live input, running
+   *          the recorded number of updates each frame.  Live input is
+   *          dropped, apart from closing the window; the loop quits when the
+   *          recording runs out.
+   */
+  auto replay_input(const std::string& _filename, InputReplay::pace _pace = InputReplay::pace::max_speed) -> void;
+  auto stop_input() -> void;
 private:
-  View  view_;
-  bool  quit_app_      = false;
-  bool  is_restarting_ = false;
+  static constexpr int default_idle_timeout_ms = 250;
+
+  View            view_;
+  FrameScheduler  scheduler_;
+  FrameStats      frame_stats_;
+  DrawRecorder    recorder_;
+  std::unique_ptr<InputRecorder>  input_recorder_;
+  std::unique_ptr<InputReplay>    input_replay_;
+  InputReplay::frame              replay_frame_;
+  bool            show_frame_stats_ = false;
+  bool            quit_app_         = false;
+  bool            is_restarting_    = false;
+  bool            idle_             = false;
+  bool            redraw_requested_ = true;
+  int             idle_timeout_ms_  = default_idle_timeout_ms;
 
   auto init_view() -> View;
   auto init_view(int, int) -> View;
@@ -36,6 +91,7 @@ private:
   virtual auto on_window_event(const SDL_WindowEvent&) -> void;
   virtual auto on_controller_button_event(const SDL_ControllerButtonEvent& _event) -> void;
   virtual auto on_controller_axis_event(const SDL_ControllerAxisEvent&) -> void;
+  virtual auto on_update(double _dt) -> void;
   virtual auto do_render() -> void;
 };
   
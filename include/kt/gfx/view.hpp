@@ -1,20 +1,41 @@
 #ifndef view_hpp_20210914_164707_PDT
 #define view_hpp_20210914_164707_PDT
 #include "renderer.hpp"
+#include "texture_pool.hpp"
+#include "layer.hpp"
+#include <memory>
 #include <tuple>
 namespace kt {
 namespace gfx {
 
+class Surface;
+
 class View final
 {
   static constexpr int default_width_   = 640;
   static constexpr int default_height_  = 480;
 public:
+  struct headless_t {};
+  static constexpr headless_t headless {};
+
   ~View();
   View(const View&) = delete;
   View(View&&)      = default;
   View();
   View(int _w, int _h);
+  /*! \brief  Offscreen view for batch rendering and tests: a software
+   *          renderer drawing into an RGBA surface, with no window, no video
+   *          driver and no vsync.
+   */
+  View(headless_t, int _w = default_width_, int _h = default_height_);
+
+  auto is_headless() const -> bool;
+  /*! \brief  Read the frame into `_into`, resizing it only when the view
+   *          size changed so the buffer can be reused frame after frame.  A
+   *          headless view keeps its last presented frame; a window's back
+   *          buffer is undefined after a present, so read it before.
+   */
+  auto read_frame(Surface& _into) -> void;
 
 
 
@@ -30,6 +51,9 @@ public:
   auto height() const -> int;
   auto size()   const -> std::pair<int, int>;
   
+  /*! \brief  Draw `fn` into the presentation texture and copy it to the
+   *          window; presenting is left to the caller.
+   */
   template<typename FnT>
     auto scene(FnT&& fn) -> void
     {
@@ -39,16 +63,51 @@ public:
     }
 
   auto make_texture(int _w, int _h, int _access  = Texture::default_access) -> Texture;
+  /*! \brief  Borrow a texture from the view's pool; it goes back to the
+   *          pool when the lease is destroyed.  Contents are undefined.
+   */
+  auto lease_texture(int _w, int _h, int _access = Texture::default_access) -> TexturePool::lease;
+  auto texture_pool() -> TexturePool&;
 
   auto renderer() const -> const Renderer&;
   auto renderer()       ->       Renderer&;
 
+  /*! \brief  Push a layer on top of the stack.  The reference stays valid
+   *          until the layer is removed.
+   */
+  auto add_layer(Layer::render_fn _fn) -> Layer&;
+  auto remove_layer(Layer& _layer) -> void;
+  auto layer_count() const -> std::size_t;
+  /*! \brief  Colour under the bottom layer. */
+  auto set_background(Color _c) -> void;
+  /*! \brief  Redraw the invalidated parts of each layer into its cache,
+   *          recomposite only those regions of the presentation texture, and
+   *          copy it to the window, leaving the present to the caller.  Layer
+   *          and composite work scale with the damaged area; the final copy
+   *          to the window is always one full blit, since the back buffer is
+   *          undefined after a present.
+   */
+  auto compose() -> void;
+  /*! \brief  Screen regions recomposited by the last `compose()`. */
+  auto last_damage() const -> const std::vector<SDL_Rect>&;
+
 private:
-  SDL_Window*   window_                     = nullptr;
-  Renderer      renderer_;
+  using window_ptr  = std::unique_ptr<SDL_Window, void(*)(SDL_Window*)>;
+  using surface_ptr = std::unique_ptr<SDL_Surface, void(*)(SDL_Surface*)>;
+
+  window_ptr    window_  { nullptr, SDL_DestroyWindow };
+  surface_ptr   surface_ { nullptr, SDL_FreeSurface };  //!< Headless target; outlives the renderer.
+  // on the heap so moving the view leaves it where the pool and every
+  // texture point
+  std::unique_ptr<Renderer> renderer_;
+  TexturePool   texture_pool_;
   Texture       presentation_texture_;
   int           width_;
   int           height_;
+  std::vector<std::unique_ptr<Layer>> layers_;
+  std::vector<SDL_Rect>               damage_;
+  Color                               background_       = Color::black();
+  bool                                layers_changed_   = false;
 
   auto init_window(int, int) -> SDL_Window*;
   auto init_renderer() -> SDL_Renderer*;
@@ -25,6 +25,8 @@
 #include <kt/string/pad.hpp>
 #include <map>
 #include <fstream>
+#include <functional>
+#include <optional>
 namespace kt {
  
 namespace program_option {
@@ -136,7 +138,7 @@ public:
       ( const std::function<void(const std::optional<T>&)>& _ah  //!< Callback function which receives the parsed value.
       )
     {
-      handler_ = [&_ah](auto key, auto value)
+      handler_ = [_ah](auto key, auto value)
         {
           if(value.empty())
           {
@@ -1,6 +1,8 @@
 #ifndef wrap_hpp_20210921_203454_PDT
 #define wrap_hpp_20210921_203454_PDT
+#include <cctype>
 #include <functional>
+#include <vector>
 namespace kt {
  
 template<typename StringT>
@@ -4,8 +4,15 @@
 namespace kt::terminal {
  
 auto get_size() -> std::pair<std::size_t, std::size_t>;
+/*! \brief  Size of the terminal on file descriptor `_fd`, columns then rows. */
+auto get_size(int _fd) -> std::pair<std::size_t, std::size_t>;
 auto get_columns() -> std::size_t;
 auto get_rows() -> std::size_t;
+/*! \brief  Text area size in pixels, width then height; zero where the
+ *          terminal doesn't report it.
+ */
+auto get_pixel_size() -> std::pair<std::size_t, std::size_t>;
+auto get_pixel_size(int _fd) -> std::pair<std::size_t, std::size_t>;
 
 } /* namespace kt::terminal */
 #endif//terminal_hpp_20210921_192454_PDT
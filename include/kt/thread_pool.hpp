@@ -0,0 +1,143 @@
+#ifndef kt_thread_pool_hpp_20211012_201544_PDT
+#define kt_thread_pool_hpp_20211012_201544_PDT
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+namespace kt {
+
+/*! \brief    Fixed set of worker threads, each with its own task deque.
+ *            A worker runs its newest task first and, when it runs dry,
+ *            steals the oldest task from another worker, so tasks spawned
+ *            from tasks stay local while idle workers still find work.
+ */
+class thread_pool final
+{
+public:
+  using task = std::function<void(void)>;   //!< Unit of work run on a worker.
+
+  thread_pool(const thread_pool&) = delete;
+  /*! \brief  Start `_threads` workers; zero means one per hardware thread. */
+  explicit thread_pool(std::size_t _threads = 0);
+  ~thread_pool();
+
+  /*! \brief  Number of worker threads. */
+  auto size() const -> std::size_t;
+  /*! \brief  Queue a task to run on some worker.  Called from one of our
+   *          workers, the task goes on that worker's own deque; otherwise
+   *          the deques are fed in turn.
+   */
+  auto submit(task _t) -> void;
+  /*! \brief  Run one queued task on the calling thread, if there is one.
+   *          Lets a thread waiting on pooled work help instead of blocking.
+   */
+  auto run_pending() -> bool;
+
+  /*! \brief    Split `[_begin, _end)` into chunks of at most `_grain` items
+   *            and call `_fn(chunk_begin, chunk_end)` for each, spread over
+   *            the workers and the calling thread.  Returns once every chunk
+   *            is done; the first exception thrown by `_fn` is rethrown.
+   */
+  template<typename FnT>
+    auto parallel_for(std::size_t _begin, std::size_t _end, std::size_t _grain, FnT&& _fn) -> void
+    {
+      if(_end <= _begin)
+      {
+        return;
+      }
+      _grain = std::max<std::size_t>(_grain, 1);
+      auto chunks = (_end - _begin + _grain - 1) / _grain;
+      if(chunks == 1 || size() == 0)
+      {
+        _fn(_begin, _end);
+        return;
+      }
+      // helpers may be dequeued after the loop is finished, so the shared
+      // state outlives this call; `_fn` is only touched while chunks remain
+      struct loop_state
+      {
+        std::atomic<std::size_t>  next { 0 };
+        std::atomic<std::size_t>  done { 0 };
+        std::size_t               chunks;
+        std::mutex                mutex;
+        std::condition_variable   finished;
+        std::exception_ptr        error;
+      };
+      auto state    = std::make_shared<loop_state>();
+      state->chunks = chunks;
+      auto body = std::function<void(std::size_t, std::size_t)>(std::ref(_fn));
+      auto work = [state, body, _begin, _end, _grain]
+        {
+          std::size_t chunk;
+          while((chunk = state->next.fetch_add(1)) < state->chunks)
+          {
+            auto first = _begin + chunk * _grain;
+            try
+            {
+              body(first, std::min(_end, first + _grain));
+            }
+            catch(...)
+            {
+              std::lock_guard<std::mutex> lock(state->mutex);
+              if(!state->error)
+              {
+                state->error = std::current_exception();
+              }
+            }
+            if(state->done.fetch_add(1) + 1 == state->chunks)
+            {
+              std::lock_guard<std::mutex> lock(state->mutex);
+              state->finished.notify_all();
+            }
+          }
+        };
+      auto helpers = std::min(size(), chunks - 1);
+      for(std::size_t i = 0; i < helpers; ++i)
+      {
+        submit(work);
+      }
+      work();
+      // the last chunks may still be running elsewhere; help with other
+      // queued work rather than sleep while they finish
+      while(state->done.load() != state->chunks && run_pending())
+      {
+      }
+      std::unique_lock<std::mutex> lock(state->mutex);
+      state->finished.wait(lock, [&] { return state->done.load() == state->chunks; });
+      if(state->error)
+      {
+        std::rethrow_exception(state->error);
+      }
+    }
+
+  /*! \brief  Process-wide pool sized to the hardware. */
+  static auto shared() -> thread_pool&;
+private:
+  struct task_queue
+  {
+    std::mutex        mutex;
+    std::deque<task>  tasks;
+  };
+  std::vector<std::unique_ptr<task_queue>>  queues_;    //!< One per worker.
+  std::vector<std::thread>                  workers_;
+  std::atomic<std::size_t>                  next_queue_ { 0 };
+  std::size_t                               pending_    = 0;   //!< Queued tasks, guarded by `mutex_`.
+  std::mutex                                mutex_;
+  std::condition_variable                   wake_;
+  bool                                      stopping_ = false;
+
+  auto worker_loop(std::size_t _index) -> void;
+  /*! \brief  Pop from queue `_home`'s back, else steal from another's front. */
+  auto take(std::size_t _home, task& _t) -> bool;
+  /*! \brief  Index of the calling thread's queue, or `npos` off the pool. */
+  auto home() const -> std::size_t;
+  static constexpr std::size_t npos = std::size_t(-1);
+};
+} /* namespace kt */
+#endif//kt_thread_pool_hpp_20211012_201544_PDT
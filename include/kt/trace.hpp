@@ -0,0 +1,108 @@
+#ifndef kt_trace_hpp_20211029_204412_PDT
+#define kt_trace_hpp_20211029_204412_PDT
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+/*****************************************************************************
+ * scoped tracing zones
+ *
+ * `KT_TRACE_ZONE("name")` times the enclosing scope.  Zones are recorded into
+ * a ring buffer owned by the calling thread, so recording takes no locks;
+ * when tracing is disabled at run time a zone costs one relaxed load.
+ * Building with KT_TRACE_ENABLED=0 removes zones altogether.  `dump()`
+ * writes everything recorded as Chrome trace JSON, which chrome://tracing
+ * and Perfetto both open.
+ ****************************************************************************/
+#ifndef KT_TRACE_ENABLED
+#define KT_TRACE_ENABLED 1
+#endif
+namespace kt::trace {
+
+/*! \brief  Number of zones each thread keeps before overwriting the oldest. */
+constexpr std::size_t ring_capacity = std::size_t(1) << 16;
+
+namespace detail {
+  inline std::atomic<bool> active { false };
+
+  inline auto clock_ns() -> uint64_t
+    {
+      using namespace std::chrono;
+      return uint64_t(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+    }
+  /*! \brief  Zone timestamp in ticks: the TSC on x86, nanoseconds elsewhere.
+   *          `dump()` converts ticks against the clock.
+   */
+  inline auto now() -> uint64_t
+    {
+#if defined(__x86_64__) || defined(__i386__)
+      return __rdtsc();
+#else
+      return clock_ns();
+#endif
+    }
+  auto record(const char* _name, const char* _category, uint64_t _begin, uint64_t _end) -> void;
+} /* namespace detail */
+
+/*! \brief  Start or stop recording. */
+auto enable(bool _on = true) -> void;
+inline auto enabled() -> bool
+  {
+    return detail::active.load(std::memory_order_relaxed);
+  }
+/*! \brief  Name the calling thread in dumps. */
+auto name_thread(const std::string& _name) -> void;
+/*! \brief  Write every recorded zone as Chrome trace JSON.  Call it while
+ *          traced threads are quiet; zones being written concurrently may
+ *          come out torn.
+ */
+auto dump(std::ostream& _out) -> void;
+auto dump(const std::string& _filename) -> void;
+/*! \brief  Forget everything recorded so far.  Safe while other threads
+ *          are recording: their buffers are left alone, and later dumps
+ *          just start after what each had written when this was called.
+ */
+auto clear() -> void;
+
+/*! \brief  Records its lifetime as one zone.  `_name` and `_category` must
+ *          outlive the trace, which string literals do.
+ */
+class zone final
+{
+public:
+  zone(const zone&) = delete;
+  explicit zone(const char* _name, const char* _category = "kt")
+    {
+      if(enabled())
+      {
+        name_     = _name;
+        category_ = _category;
+        begin_    = detail::now();
+      }
+    }
+  ~zone()
+    {
+      if(name_)
+      {
+        detail::record(name_, category_, begin_, detail::now());
+      }
+    }
+private:
+  const char* name_     = nullptr;
+  const char* category_ = nullptr;
+  uint64_t    begin_    = 0;
+};
+} /* namespace kt::trace */
+
+#define KT_TRACE_CONCAT_(a, b) a##b
+#define KT_TRACE_CONCAT(a, b)  KT_TRACE_CONCAT_(a, b)
+#if KT_TRACE_ENABLED
+#define KT_TRACE_ZONE(...) ::kt::trace::zone KT_TRACE_CONCAT(kt_trace_zone_, __LINE__) { __VA_ARGS__ }
+#else
+#define KT_TRACE_ZONE(...) static_cast<void>(0)
+#endif
+#endif//kt_trace_hpp_20211029_204412_PDT
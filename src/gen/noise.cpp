@@ -0,0 +1,208 @@
+#include <kt/gen/noise.hpp>
+#include <kt/trace.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#if defined(__x86_64__) || defined(__i386__)
+#define KT_GEN_X86 1
+#endif
+namespace kt {
+namespace gen {
+namespace {
+// parameters in the shape the kernels read
+struct setup
+{
+  basis     kind;
+  uint32_t  seed;
+  float     frequency;
+  int       octaves;
+  float     lacunarity;
+  float     gain;
+  float     warp;
+};
+auto make_setup(const noise_params& _p) -> setup
+  {
+    return setup
+      { _p.kind
+      , _p.seed
+      , _p.frequency
+      , std::clamp(_p.octaves, 1, 16)
+      , _p.lacunarity
+      , _p.gain
+      , _p.warp
+      };
+  }
+
+// four lanes build everywhere, as SSE2 on x86 and NEON on arm
+namespace narrow {
+constexpr int lanes = 4;
+#include "noise_kernels.hpp"
+} /* namespace narrow */
+
+// eight lanes of AVX2.  FMA is left off so both paths round the same way
+// and a field looks identical whichever one drew it.
+#if defined(KT_GEN_X86)
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+namespace wide {
+constexpr int lanes = 8;
+#include "noise_kernels.hpp"
+} /* namespace wide */
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+#endif
+
+using row_fn = void (*)(const setup&, float*, int, float, float);
+
+auto pick_row() -> row_fn
+  {
+#if defined(KT_GEN_X86)
+    if(__builtin_cpu_supports("avx2"))
+    {
+      return wide::fill_row;
+    }
+#endif
+    return narrow::fill_row;
+  }
+auto fill_row = pick_row();
+// rows per pooled task; enough to amortise the hand-off, few enough that
+// cores finishing early can take more
+constexpr std::size_t band_rows = 16;
+} /* namespace */
+
+ColorRamp::ColorRamp()
+    : ColorRamp({ { 0.0f, gfx::Color::black() }, { 1.0f, gfx::Color::white() } })
+  {
+  }
+ColorRamp::ColorRamp(std::initializer_list<std::pair<float, gfx::Color>> _stops)
+  {
+    for(const auto& s : _stops)
+    {
+      stops_.push_back(s);
+    }
+    rebuild();
+  }
+auto ColorRamp::add(float _t, gfx::Color _c) -> ColorRamp&
+  {
+    stops_.emplace_back(_t, _c);
+    rebuild();
+    return *this;
+  }
+// every way stops come in ends here, so clamping and sorting here covers
+// the constructors and add() alike
+auto ColorRamp::rebuild() -> void
+  {
+    for(auto& s : stops_)
+    {
+      s.first = std::clamp(s.first, 0.0f, 1.0f);
+    }
+    std::stable_sort(stops_.begin(), stops_.end(), [](const auto& _a, const auto& _b)
+      {
+        return _a.first < _b.first;
+      });
+    if(stops_.empty())
+    {
+      lut_.fill(gfx::Color::black().pixel());
+      return;
+    }
+    auto mix = [](uint8_t _a, uint8_t _b, float _t)
+      {
+        return uint8_t(std::lround(float(_a) + (float(_b) - float(_a)) * _t));
+      };
+    std::size_t stop = 0;
+    for(std::size_t i = 0; i < resolution; ++i)
+    {
+      auto t = float(i) / float(resolution - 1);
+      while(stop + 1 < stops_.size() && stops_[stop + 1].first <= t)
+      {
+        ++stop;
+      }
+      const auto& [t1, c1] = stops_[stop];
+      if(t <= t1 || stop + 1 == stops_.size())
+      {
+        lut_[i] = c1.pixel();
+        continue;
+      }
+      const auto& [t2, c2] = stops_[stop + 1];
+      auto f = (t - t1) / (t2 - t1);
+      lut_[i] = gfx::Color
+        { mix(c1.r(), c2.r(), f)
+        , mix(c1.g(), c2.g(), f)
+        , mix(c1.b(), c2.b(), f)
+        , mix(c1.a(), c2.a(), f)
+        }.pixel();
+    }
+  }
+
+Noise::Noise(const noise_params& _params)
+    : params_(_params)
+  {
+  }
+auto Noise::params() const -> const noise_params&
+  {
+    return params_;
+  }
+auto Noise::sample(float _x, float _y) const -> float
+  {
+    float out;
+    narrow::fill_row(make_setup(params_), &out, 1, _x, _y);
+    return out;
+  }
+auto Noise::fill(float* _out, int _w, int _h, std::size_t _stride, float _x0, float _y0, thread_pool& _pool) const -> void
+  {
+    KT_TRACE_ZONE("noise fill", "gen");
+    if(_w <= 0 || _h <= 0)
+    {
+      return;
+    }
+    auto s = make_setup(params_);
+    _pool.parallel_for(0, std::size_t(_h), band_rows, [&](std::size_t _first, std::size_t _last)
+      {
+        for(auto y = _first; y < _last; ++y)
+        {
+          fill_row(s, _out + y * _stride, _w, _x0, _y0 + float(y));
+        }
+      });
+  }
+auto Noise::render(uint32_t* _pixels, int _w, int _h, int _pitch, const ColorRamp& _ramp, float _x0, float _y0, thread_pool& _pool) const -> void
+  {
+    KT_TRACE_ZONE("noise render", "gen");
+    if(_w <= 0 || _h <= 0)
+    {
+      return;
+    }
+    auto s     = make_setup(params_);
+    auto bytes = reinterpret_cast<unsigned char*>(_pixels);
+    _pool.parallel_for(0, std::size_t(_h), band_rows, [&](std::size_t _first, std::size_t _last)
+      {
+        // one row of samples at a time, so the floats stay in cache and
+        // only the finished pixels go out to memory
+        auto values = std::vector<float>(std::size_t(_w));
+        for(auto y = _first; y < _last; ++y)
+        {
+          fill_row(s, values.data(), _w, _x0, _y0 + float(y));
+          auto row = reinterpret_cast<uint32_t*>(bytes + y * std::size_t(_pitch));
+          for(int x = 0; x < _w; ++x)
+          {
+            row[x] = _ramp.map(values[std::size_t(x)]);
+          }
+        }
+      });
+  }
+auto Noise::render(gfx::Surface& _s, const ColorRamp& _ramp, float _x0, float _y0, thread_pool& _pool) const -> void
+  {
+    render(_s.pixels(), _s.width(), _s.height(), _s.pitch(), _ramp, _x0, _y0, _pool);
+  }
+auto Noise::lanes() -> int
+  {
+    return fill_row == narrow::fill_row? narrow::lanes : 8;
+  }
+} /* namespace gen */
+} /* namespace kt */
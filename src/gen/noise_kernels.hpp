@@ -0,0 +1,182 @@
+// Noise kernels, written once over vector types of `lanes` floats.
+// noise.cpp includes this file several times, each inside a namespace that
+// defines `lanes` and under its own target options, so there is deliberately
+// no include guard.
+
+typedef float     vf __attribute__((vector_size(lanes * 4)));
+typedef int32_t   vi __attribute__((vector_size(lanes * 4)));
+typedef uint32_t  vu __attribute__((vector_size(lanes * 4)));
+
+inline auto splat(float _v) -> vf
+  {
+    return vf {} + _v;
+  }
+inline auto to_int(vf _v) -> vi
+  {
+    return __builtin_convertvector(_v, vi);
+  }
+inline auto to_float(vi _v) -> vf
+  {
+    return __builtin_convertvector(_v, vf);
+  }
+inline auto floor_v(vf _x) -> vf
+  {
+    auto t = to_float(to_int(_x));
+    return t - to_float((t > _x) & 1);
+  }
+inline auto select(vi _mask, vf _a, vf _b) -> vf
+  {
+    return (vf)((_mask & (vi)_a) | (~_mask & (vi)_b));
+  }
+inline auto fade(vf _t) -> vf
+  {
+    return _t * _t * _t * (_t * (_t * 6.0f - 15.0f) + 10.0f);
+  }
+inline auto lerp(vf _a, vf _b, vf _t) -> vf
+  {
+    return _a + (_b - _a) * _t;
+  }
+inline auto hash(vi _x, vi _y, uint32_t _seed) -> vu
+  {
+    auto h = ((vu)_x * 0x27d4eb2du) ^ ((vu)_y * 0x165667b1u) ^ _seed;
+    h ^= h >> 15;
+    h *= 0x2c1b3c6du;
+    h ^= h >> 12;
+    h *= 0x297a2d39u;
+    h ^= h >> 15;
+    return h;
+  }
+// dot product with one of the four diagonal gradients, picked by flipping
+// sign bits
+inline auto grad(vu _h, vf _x, vf _y) -> vf
+  {
+    auto sx = (vi)((_h & 1u) << 31);
+    auto sy = (vi)((_h & 2u) << 30);
+    return (vf)((vi)_x ^ sx) + (vf)((vi)_y ^ sy);
+  }
+
+inline auto value(vf _x, vf _y, uint32_t _seed) -> vf
+  {
+    auto fx = floor_v(_x);
+    auto fy = floor_v(_y);
+    auto ix = to_int(fx);
+    auto iy = to_int(fy);
+    auto tx = fade(_x - fx);
+    auto ty = fade(_y - fy);
+    auto corner = [&](vi _cx, vi _cy)
+      {
+        return to_float((vi)(hash(_cx, _cy, _seed) >> 8)) * (2.0f / 16777215.0f) - 1.0f;
+      };
+    return lerp
+      ( lerp(corner(ix, iy),     corner(ix + 1, iy),     tx)
+      , lerp(corner(ix, iy + 1), corner(ix + 1, iy + 1), tx)
+      , ty
+      );
+  }
+inline auto perlin(vf _x, vf _y, uint32_t _seed) -> vf
+  {
+    auto fx = floor_v(_x);
+    auto fy = floor_v(_y);
+    auto ix = to_int(fx);
+    auto iy = to_int(fy);
+    auto rx = _x - fx;
+    auto ry = _y - fy;
+    auto u  = fade(rx);
+    auto v  = fade(ry);
+    auto n00 = grad(hash(ix,     iy,     _seed), rx,        ry);
+    auto n10 = grad(hash(ix + 1, iy,     _seed), rx - 1.0f, ry);
+    auto n01 = grad(hash(ix,     iy + 1, _seed), rx,        ry - 1.0f);
+    auto n11 = grad(hash(ix + 1, iy + 1, _seed), rx - 1.0f, ry - 1.0f);
+    return lerp(lerp(n00, n10, u), lerp(n01, n11, u), v);
+  }
+inline auto simplex_corner(vu _h, vf _x, vf _y) -> vf
+  {
+    auto f = 0.5f - _x * _x - _y * _y;
+    f = select(f > 0.0f, f, splat(0.0f));
+    f *= f;
+    return f * f * grad(_h, _x, _y);
+  }
+inline auto simplex(vf _x, vf _y, uint32_t _seed) -> vf
+  {
+    constexpr float f2 = 0.366025403784f;   // (sqrt(3) - 1) / 2
+    constexpr float g2 = 0.211324865405f;   // (3 - sqrt(3)) / 6
+    auto s  = (_x + _y) * f2;
+    auto fi = floor_v(_x + s);
+    auto fj = floor_v(_y + s);
+    auto t  = (fi + fj) * g2;
+    auto x0 = _x - (fi - t);
+    auto y0 = _y - (fj - t);
+    // which of the cell's two triangles holds the point
+    auto upper = x0 > y0;
+    auto i1 = select(upper, splat(1.0f), splat(0.0f));
+    auto j1 = 1.0f - i1;
+    auto x1 = x0 - i1 + g2;
+    auto y1 = y0 - j1 + g2;
+    auto x2 = x0 - 1.0f + 2.0f * g2;
+    auto y2 = y0 - 1.0f + 2.0f * g2;
+    auto i  = to_int(fi);
+    auto j  = to_int(fj);
+    auto n = simplex_corner(hash(i, j, _seed), x0, y0)
+           + simplex_corner(hash(i + to_int(i1), j + to_int(j1), _seed), x1, y1)
+           + simplex_corner(hash(i + 1, j + 1, _seed), x2, y2);
+    return n * 70.0f;
+  }
+inline auto octaves(const setup& _s, vf _x, vf _y, uint32_t _seed) -> vf
+  {
+    auto sum  = splat(0.0f);
+    auto amp  = 1.0f;
+    auto norm = 0.0f;
+    auto freq = 1.0f;
+    for(int o = 0; o < _s.octaves; ++o)
+    {
+      auto seed = _seed + uint32_t(o) * 0x9e3779b9u;
+      auto x    = _x * freq;
+      auto y    = _y * freq;
+      switch(_s.kind)
+      {
+      case gen::basis::value:   sum += amp * value(x, y, seed);   break;
+      case gen::basis::perlin:  sum += amp * perlin(x, y, seed);  break;
+      case gen::basis::simplex: sum += amp * simplex(x, y, seed); break;
+      }
+      norm += amp;
+      amp  *= _s.gain;
+      freq *= _s.lacunarity;
+    }
+    return norm > 0.0f? sum / norm : sum;
+  }
+inline auto eval(const setup& _s, vf _x, vf _y) -> vf
+  {
+    auto x = _x * _s.frequency;
+    auto y = _y * _s.frequency;
+    if(_s.warp != 0.0f)
+    {
+      // offset the lookup by two more fields, decorrelated by seed
+      auto qx = octaves(_s, x, y, _s.seed ^ 0x68e31da4u);
+      auto qy = octaves(_s, x, y, _s.seed ^ 0xb5297a4du);
+      x += qx * (_s.warp * _s.frequency);
+      y += qy * (_s.warp * _s.frequency);
+    }
+    auto v = octaves(_s, x, y, _s.seed);
+    return select(v > 1.0f, splat(1.0f), select(v < -1.0f, splat(-1.0f), v));
+  }
+inline auto fill_row(const setup& _s, float* _out, int _n, float _x0, float _y) -> void
+  {
+    vf step {};
+    for(int l = 0; l < lanes; ++l)
+    {
+      step[l] = float(l);
+    }
+    auto y = splat(_y);
+    for(int i = 0; i < _n; i += lanes)
+    {
+      auto v = eval(_s, (_x0 + float(i)) + step, y);
+      if(i + lanes <= _n)
+      {
+        std::memcpy(_out + i, &v, sizeof(v));
+      }
+      else
+      {
+        std::memcpy(_out + i, &v, sizeof(float) * std::size_t(_n - i));
+      }
+    }
+  }
@@ -0,0 +1,539 @@
+#include <kt/gfx/asset_pack.hpp>
+#include <kt/gfx/renderer.hpp>
+#include <kt/trace.hpp>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+namespace kt {
+namespace gfx {
+namespace {
+constexpr std::size_t header_bytes  = 32;
+constexpr std::size_t image_bytes   = 40;
+constexpr std::size_t region_bytes  = 28;
+
+auto get_u32(const uint8_t* _p) -> uint32_t
+  {
+    return uint32_t(_p[0]) | uint32_t(_p[1]) << 8 | uint32_t(_p[2]) << 16 | uint32_t(_p[3]) << 24;
+  }
+auto get_u64(const uint8_t* _p) -> uint64_t
+  {
+    return uint64_t(get_u32(_p)) | uint64_t(get_u32(_p + 4)) << 32;
+  }
+auto put_u32(std::vector<uint8_t>& _out, uint32_t _v) -> void
+  {
+    for(int i = 0; i < 4; ++i)
+    {
+      _out.push_back(uint8_t(_v >> (8 * i)));
+    }
+  }
+auto put_u64(std::vector<uint8_t>& _out, uint64_t _v) -> void
+  {
+    put_u32(_out, uint32_t(_v));
+    put_u32(_out, uint32_t(_v >> 32));
+  }
+auto corrupt(const std::string& _path) -> std::runtime_error
+  {
+    return std::runtime_error("\"" + _path + "\" is not a valid asset pack");
+  }
+
+// QOI, as specified at qoiformat.org; RGBA32 pixels are R, G, B, A in
+// memory, which is the order QOI works in
+constexpr uint8_t qoi_index = 0x00;
+constexpr uint8_t qoi_diff  = 0x40;
+constexpr uint8_t qoi_luma  = 0x80;
+constexpr uint8_t qoi_run   = 0xc0;
+constexpr uint8_t qoi_rgb   = 0xfe;
+constexpr uint8_t qoi_rgba  = 0xff;
+constexpr uint8_t qoi_mask  = 0xc0;
+constexpr uint8_t qoi_end[8] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+
+auto qoi_hash(Color _c) -> std::size_t
+  {
+    return (std::size_t(_c.r()) * 3 + std::size_t(_c.g()) * 5 + std::size_t(_c.b()) * 7 + std::size_t(_c.a()) * 11) % 64;
+  }
+auto put_be32(std::vector<uint8_t>& _out, uint32_t _v) -> void
+  {
+    _out.push_back(uint8_t(_v >> 24));
+    _out.push_back(uint8_t(_v >> 16));
+    _out.push_back(uint8_t(_v >> 8));
+    _out.push_back(uint8_t(_v));
+  }
+auto get_be32(const uint8_t* _p) -> uint32_t
+  {
+    return uint32_t(_p[0]) << 24 | uint32_t(_p[1]) << 16 | uint32_t(_p[2]) << 8 | uint32_t(_p[3]);
+  }
+} /* namespace */
+
+auto qoi_encode(const uint32_t* _pixels, int _w, int _h, std::vector<uint8_t>& _out) -> void
+  {
+    _out.insert(_out.end(), { 'q', 'o', 'i', 'f' });
+    put_be32(_out, uint32_t(_w));
+    put_be32(_out, uint32_t(_h));
+    _out.push_back(4);    // channels
+    _out.push_back(0);    // sRGB with linear alpha
+    uint32_t index[64] = {};
+    auto prev  = Color { 0, 0, 0, 255 }.pixel();
+    auto count = std::size_t(_w) * std::size_t(_h);
+    int  run   = 0;
+    for(std::size_t i = 0; i < count; ++i)
+    {
+      auto px = _pixels[i];
+      if(px == prev)
+      {
+        if(++run == 62 || i + 1 == count)
+        {
+          _out.push_back(uint8_t(qoi_run | (run - 1)));
+          run = 0;
+        }
+        continue;
+      }
+      if(run > 0)
+      {
+        _out.push_back(uint8_t(qoi_run | (run - 1)));
+        run = 0;
+      }
+      auto c    = Color::from_pixel(px);
+      auto slot = qoi_hash(c);
+      if(index[slot] == px)
+      {
+        _out.push_back(uint8_t(qoi_index | slot));
+      }
+      else
+      {
+        index[slot] = px;
+        auto p = Color::from_pixel(prev);
+        if(c.a() == p.a())
+        {
+          auto dr  = int8_t(c.r() - p.r());
+          auto dg  = int8_t(c.g() - p.g());
+          auto db  = int8_t(c.b() - p.b());
+          auto drg = int8_t(dr - dg);
+          auto dbg = int8_t(db - dg);
+          if(dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1)
+          {
+            _out.push_back(uint8_t(qoi_diff | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2)));
+          }
+          else if(dg >= -32 && dg <= 31 && drg >= -8 && drg <= 7 && dbg >= -8 && dbg <= 7)
+          {
+            _out.push_back(uint8_t(qoi_luma | (dg + 32)));
+            _out.push_back(uint8_t((drg + 8) << 4 | (dbg + 8)));
+          }
+          else
+          {
+            _out.insert(_out.end(), { qoi_rgb, c.r(), c.g(), c.b() });
+          }
+        }
+        else
+        {
+          _out.insert(_out.end(), { qoi_rgba, c.r(), c.g(), c.b(), c.a() });
+        }
+      }
+      prev = px;
+    }
+    _out.insert(_out.end(), std::begin(qoi_end), std::end(qoi_end));
+  }
+auto qoi_decode(const uint8_t* _data, std::size_t _size, int _w, int _h, uint32_t* _pixels) -> void
+  {
+    if(_size < 14 + sizeof(qoi_end) || std::memcmp(_data, "qoif", 4) != 0
+      || get_be32(_data + 4) != uint32_t(_w) || get_be32(_data + 8) != uint32_t(_h))
+    {
+      throw std::runtime_error("malformed QOI image");
+    }
+    uint32_t index[64] = {};
+    auto c     = Color { 0, 0, 0, 255 };
+    auto count = std::size_t(_w) * std::size_t(_h);
+    auto p     = _data + 14;
+    auto end   = _data + _size - sizeof(qoi_end);
+    std::size_t i = 0;
+    while(i < count)
+    {
+      if(p >= end)
+      {
+        throw std::runtime_error("truncated QOI image");
+      }
+      auto op = *p++;
+      if(op == qoi_rgb || op == qoi_rgba)
+      {
+        auto need = op == qoi_rgb? 3 : 4;
+        if(end - p < need)
+        {
+          throw std::runtime_error("truncated QOI image");
+        }
+        c = Color { p[0], p[1], p[2], op == qoi_rgb? c.a() : p[3] };
+        p += need;
+      }
+      else if((op & qoi_mask) == qoi_index)
+      {
+        c = Color::from_pixel(index[op]);
+      }
+      else if((op & qoi_mask) == qoi_diff)
+      {
+        c = Color
+          { uint8_t(c.r() + ((op >> 4) & 3) - 2)
+          , uint8_t(c.g() + ((op >> 2) & 3) - 2)
+          , uint8_t(c.b() + (op & 3) - 2)
+          , c.a()
+          };
+      }
+      else if((op & qoi_mask) == qoi_luma)
+      {
+        if(p >= end)
+        {
+          throw std::runtime_error("truncated QOI image");
+        }
+        auto dg = (op & 0x3f) - 32;
+        auto rb = *p++;
+        c = Color
+          { uint8_t(c.r() + dg - 8 + (rb >> 4))
+          , uint8_t(c.g() + dg)
+          , uint8_t(c.b() + dg - 8 + (rb & 0x0f))
+          , c.a()
+          };
+      }
+      else
+      {
+        auto run = std::min(std::size_t(op & 0x3f) + 1, count - i);
+        std::fill_n(_pixels + i, run, c.pixel());
+        i += run;
+        continue;
+      }
+      index[qoi_hash(c)] = c.pixel();
+      _pixels[i++] = c.pixel();
+    }
+  }
+
+AssetPack::AssetPack(const std::string& _path)
+  {
+    KT_TRACE_ZONE("open asset pack", "gfx");
+    auto fd = ::open(_path.c_str(), O_RDONLY);
+    if(fd < 0)
+    {
+      throw std::runtime_error("can't open asset pack \"" + _path + "\"");
+    }
+    struct stat st;
+    if(::fstat(fd, &st) != 0 || std::size_t(st.st_size) < header_bytes)
+    {
+      ::close(fd);
+      throw corrupt(_path);
+    }
+    auto mapped = ::mmap(nullptr, std::size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if(mapped == MAP_FAILED)
+    {
+      throw std::runtime_error("can't map asset pack \"" + _path + "\"");
+    }
+    map_  = static_cast<const uint8_t*>(mapped);
+    size_ = std::size_t(st.st_size);
+    // start reading everything in now; uploads then go at disk speed
+    ::madvise(mapped, size_, MADV_WILLNEED);
+    try
+    {
+      if(std::memcmp(map_, "KTPK", 4) != 0 || get_u32(map_ + 4) != version)
+      {
+        throw corrupt(_path);
+      }
+      auto images       = std::size_t(get_u32(map_ + 8));
+      auto regions      = std::size_t(get_u32(map_ + 12));
+      auto string_bytes = std::size_t(get_u32(map_ + 16));
+      auto strings_at   = header_bytes + images * image_bytes + regions * region_bytes;
+      if(strings_at + string_bytes > size_)
+      {
+        throw corrupt(_path);
+      }
+      auto name = [&](const uint8_t* _p)
+        {
+          auto offset = std::size_t(get_u32(_p));
+          auto length = std::size_t(get_u32(_p + 4));
+          if(offset + length > string_bytes)
+          {
+            throw corrupt(_path);
+          }
+          return std::string_view(reinterpret_cast<const char*>(map_ + strings_at + offset), length);
+        };
+      images_.reserve(images);
+      for(std::size_t i = 0; i < images; ++i)
+      {
+        auto p      = map_ + header_bytes + i * image_bytes;
+        auto w      = get_u32(p + 8);
+        auto h      = get_u32(p + 12);
+        auto format = get_u32(p + 16);
+        auto enc    = get_u32(p + 20);
+        auto offset = get_u64(p + 24);
+        auto bytes  = get_u64(p + 32);
+        if(format != default_pixel_format || enc > uint32_t(codec::qoi) || offset > size_ || bytes > size_ - offset
+          || w > 1u << 15 || h > 1u << 15
+          || (codec(enc) == codec::raw && bytes != uint64_t(w) * h * 4))
+        {
+          throw corrupt(_path);
+        }
+        images_.push_back(image { name(p), int(w), int(h), codec(enc), map_ + offset, std::size_t(bytes) });
+        image_index_.emplace(images_.back().name, i);
+      }
+      regions_.reserve(regions);
+      for(std::size_t i = 0; i < regions; ++i)
+      {
+        auto p     = map_ + header_bytes + images * image_bytes + i * region_bytes;
+        auto owner = std::size_t(get_u32(p + 8));
+        auto rect  = SDL_Rect { int(get_u32(p + 12)), int(get_u32(p + 16)), int(get_u32(p + 20)), int(get_u32(p + 24)) };
+        if(owner >= images_.size() || rect.x < 0 || rect.y < 0 || rect.w < 0 || rect.h < 0
+          || int64_t(rect.x) + rect.w > images_[owner].w || int64_t(rect.y) + rect.h > images_[owner].h)
+        {
+          throw corrupt(_path);
+        }
+        regions_.push_back(region { name(p), owner, rect });
+        region_index_.emplace(regions_.back().name, i);
+      }
+    }
+    catch(...)
+    {
+      release();
+      throw;
+    }
+  }
+AssetPack::AssetPack(AssetPack&& _src)
+    : map_(_src.map_)
+    , size_(_src.size_)
+    , images_(std::move(_src.images_))
+    , regions_(std::move(_src.regions_))
+    , image_index_(std::move(_src.image_index_))
+    , region_index_(std::move(_src.region_index_))
+  {
+    _src.map_   = nullptr;
+    _src.size_  = 0;
+  }
+auto AssetPack::operator=(AssetPack&& _src) -> AssetPack&
+  {
+    if(this != &_src)
+    {
+      release();
+      map_          = _src.map_;
+      size_         = _src.size_;
+      images_       = std::move(_src.images_);
+      regions_      = std::move(_src.regions_);
+      image_index_  = std::move(_src.image_index_);
+      region_index_ = std::move(_src.region_index_);
+      _src.map_     = nullptr;
+      _src.size_    = 0;
+    }
+    return *this;
+  }
+AssetPack::~AssetPack()
+  {
+    release();
+  }
+auto AssetPack::release() -> void
+  {
+    if(map_)
+    {
+      ::munmap(const_cast<uint8_t*>(map_), size_);
+    }
+    map_  = nullptr;
+    size_ = 0;
+    images_.clear();
+    regions_.clear();
+    image_index_.clear();
+    region_index_.clear();
+  }
+auto AssetPack::images() const -> const std::vector<image>&
+  {
+    return images_;
+  }
+auto AssetPack::regions() const -> const std::vector<region>&
+  {
+    return regions_;
+  }
+auto AssetPack::find_image(std::string_view _name) const -> const image*
+  {
+    auto found = image_index_.find(_name);
+    return found == image_index_.end()? nullptr : &images_[found->second];
+  }
+auto AssetPack::find(std::string_view _name) const -> const region*
+  {
+    auto found = region_index_.find(_name);
+    return found == region_index_.end()? nullptr : &regions_[found->second];
+  }
+auto AssetPack::decode(const image& _i) const -> Surface
+  {
+    Surface result(_i.w, _i.h);
+    if(_i.encoding == codec::qoi)
+    {
+      qoi_decode(_i.data, _i.size, _i.w, _i.h, result.pixels());
+    }
+    else
+    {
+      std::memcpy(result.pixels(), _i.data, _i.size);
+    }
+    return result;
+  }
+auto AssetPack::upload(Renderer& _r, const image& _i) const -> Texture
+  {
+    std::vector<uint32_t> scratch;
+    return upload(_r, _i, scratch);
+  }
+auto AssetPack::upload(Renderer& _r, const image& _i, std::vector<uint32_t>& _scratch) const -> Texture
+  {
+    KT_TRACE_ZONE("upload packed image", "gfx");
+    Texture result;
+    result.reset(_r, _i.w, _i.h, SDL_TEXTUREACCESS_STATIC);
+    result.set(SDL_BLENDMODE_BLEND);
+    if(_i.encoding == codec::raw)
+    {
+      result.update(_i.data, _i.w * 4);
+    }
+    else
+    {
+      _scratch.resize(std::size_t(_i.w) * std::size_t(_i.h));
+      qoi_decode(_i.data, _i.size, _i.w, _i.h, _scratch.data());
+      result.update(_scratch.data(), _i.w * 4);
+    }
+    return result;
+  }
+auto AssetPack::upload_all(Renderer& _r) const -> std::vector<Texture>
+  {
+    std::vector<Texture>  result;
+    std::vector<uint32_t> scratch;
+    result.reserve(images_.size());
+    for(const auto& i : images_)
+    {
+      result.push_back(upload(_r, i, scratch));
+    }
+    return result;
+  }
+
+AssetPackWriter::AssetPackWriter(AssetPack::codec _codec, int _page_size, std::size_t _alignment)
+    : codec_(_codec)
+    , page_size_(_page_size)
+    , alignment_(std::max<std::size_t>(_alignment, 1))
+  {
+  }
+auto AssetPackWriter::add(const std::string& _name, Surface _image) -> void
+  {
+    auto rect = SDL_Rect { 0, 0, _image.width(), _image.height() };
+    images_.push_back(entry { _name, std::move(_image) });
+    regions_.push_back(named_rect { _name, images_.size() - 1, rect });
+  }
+auto AssetPackWriter::add_to_atlas(const std::string& _name, const Surface& _image) -> void
+  {
+    for(auto& p : pages_)
+    {
+      if(auto placed = p.packer.pack(_image.width(), _image.height()))
+      {
+        images_[p.image].pixels.write(_image, placed->x, placed->y);
+        regions_.push_back(named_rect { _name, p.image, *placed });
+        return;
+      }
+    }
+    SkylinePacker packer(page_size_, page_size_);
+    auto placed = packer.pack(_image.width(), _image.height());
+    if(!placed)
+    {
+      // too big for any page
+      Surface copy(_image.width(), _image.height());
+      copy.write(_image, 0, 0);
+      add(_name, std::move(copy));
+      return;
+    }
+    images_.push_back(entry { "atlas/" + std::to_string(pages_.size()), Surface(page_size_, page_size_, Color::transparent()) });
+    images_.back().pixels.write(_image, placed->x, placed->y);
+    pages_.push_back(page { images_.size() - 1, std::move(packer) });
+    regions_.push_back(named_rect { _name, images_.size() - 1, *placed });
+  }
+auto AssetPackWriter::write(const std::string& _path) const -> void
+  {
+    std::vector<uint8_t> strings;
+    auto add_string = [&](const std::string& _s)
+      {
+        auto offset = uint32_t(strings.size());
+        strings.insert(strings.end(), _s.begin(), _s.end());
+        return offset;
+      };
+    std::vector<std::vector<uint8_t>> blobs(images_.size());
+    for(std::size_t i = 0; i < images_.size(); ++i)
+    {
+      const auto& s = images_[i].pixels;
+      if(codec_ == AssetPack::codec::qoi)
+      {
+        qoi_encode(s.pixels(), s.width(), s.height(), blobs[i]);
+      }
+      else
+      {
+        auto bytes = reinterpret_cast<const uint8_t*>(s.pixels());
+        blobs[i].assign(bytes, bytes + std::size_t(s.width()) * std::size_t(s.height()) * 4);
+      }
+    }
+    std::vector<uint32_t> image_names;
+    std::vector<uint32_t> region_names;
+    for(const auto& e : images_)
+    {
+      image_names.push_back(add_string(e.name));
+    }
+    for(const auto& r : regions_)
+    {
+      region_names.push_back(add_string(r.name));
+    }
+    auto align = [&](std::size_t _at) { return (_at + alignment_ - 1) / alignment_ * alignment_; };
+    auto data_at = align(header_bytes + images_.size() * image_bytes + regions_.size() * region_bytes + strings.size());
+
+    std::vector<uint8_t> index;
+    index.insert(index.end(), { 'K', 'T', 'P', 'K' });
+    put_u32(index, AssetPack::version);
+    put_u32(index, uint32_t(images_.size()));
+    put_u32(index, uint32_t(regions_.size()));
+    put_u32(index, uint32_t(strings.size()));
+    put_u32(index, uint32_t(alignment_));
+    put_u64(index, 0);
+    std::vector<std::size_t> offsets;
+    auto at = data_at;
+    for(std::size_t i = 0; i < images_.size(); ++i)
+    {
+      const auto& s = images_[i].pixels;
+      put_u32(index, image_names[i]);
+      put_u32(index, uint32_t(images_[i].name.size()));
+      put_u32(index, uint32_t(s.width()));
+      put_u32(index, uint32_t(s.height()));
+      put_u32(index, default_pixel_format);
+      put_u32(index, uint32_t(codec_));
+      put_u64(index, at);
+      put_u64(index, blobs[i].size());
+      offsets.push_back(at);
+      at = align(at + blobs[i].size());
+    }
+    for(std::size_t i = 0; i < regions_.size(); ++i)
+    {
+      const auto& r = regions_[i];
+      put_u32(index, region_names[i]);
+      put_u32(index, uint32_t(r.name.size()));
+      put_u32(index, uint32_t(r.image));
+      put_u32(index, uint32_t(r.rect.x));
+      put_u32(index, uint32_t(r.rect.y));
+      put_u32(index, uint32_t(r.rect.w));
+      put_u32(index, uint32_t(r.rect.h));
+    }
+    index.insert(index.end(), strings.begin(), strings.end());
+
+    std::ofstream out(_path, std::ios::binary | std::ios::trunc);
+    if(!out)
+    {
+      throw std::runtime_error("can't write asset pack \"" + _path + "\"");
+    }
+    out.write(reinterpret_cast<const char*>(index.data()), std::streamsize(index.size()));
+    std::vector<char> padding(alignment_, 0);
+    auto written = index.size();
+    for(std::size_t i = 0; i < blobs.size(); ++i)
+    {
+      out.write(padding.data(), std::streamsize(offsets[i] - written));
+      out.write(reinterpret_cast<const char*>(blobs[i].data()), std::streamsize(blobs[i].size()));
+      written = offsets[i] + blobs[i].size();
+    }
+    if(!out)
+    {
+      throw std::runtime_error("error writing asset pack \"" + _path + "\"");
+    }
+  }
+} /* namespace gfx */
+} /* namespace kt */
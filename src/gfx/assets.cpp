@@ -0,0 +1,172 @@
+#include <kt/gfx/assets.hpp>
+#include <kt/gfx/renderer.hpp>
+namespace kt {
+namespace gfx {
+struct AssetManager::entry
+{
+  enum class state { decoding, decoded, ready, failed };
+
+  std::string         path;
+  std::atomic<state>  status { state::decoding };
+  Surface             pixels;     // owned by the decoder until `decoded`
+  Texture             texture;    // render thread only
+  std::exception_ptr  error;
+};
+
+auto AssetManager::handle::ready() const -> bool
+  {
+    return entry_ && entry_->status == entry::state::ready;
+  }
+auto AssetManager::handle::failed() const -> bool
+  {
+    return entry_ && entry_->status == entry::state::failed;
+  }
+auto AssetManager::handle::texture() const -> const Texture&
+  {
+    if(!entry_)
+    {
+      throw std::runtime_error("empty asset handle");
+    }
+    if(entry_->status == entry::state::failed)
+    {
+      std::rethrow_exception(entry_->error);
+    }
+    if(entry_->status != entry::state::ready)
+    {
+      throw std::runtime_error("asset \"" + entry_->path + "\" is not loaded yet");
+    }
+    return entry_->texture;
+  }
+auto AssetManager::handle::path() const -> const std::string&
+  {
+    return entry_->path;
+  }
+
+AssetManager::AssetManager(Renderer& _r, std::size_t _decoders)
+    : renderer_(_r)
+    , decoders_(_decoders)
+  {
+  }
+AssetManager::~AssetManager()
+  {
+  }
+auto AssetManager::load(const std::string& _path) -> handle
+  {
+    auto found = cache_.find(_path);
+    if(found != cache_.end())
+    {
+      return handle(found->second);
+    }
+    auto e  = std::make_shared<entry>();
+    e->path = _path;
+    cache_.emplace(_path, e);
+    {
+      std::lock_guard<std::mutex> lock(uploads_mutex_);
+      ++pending_;
+    }
+    decoders_.submit([this, e] { decode(e); });
+    return handle(e);
+  }
+auto AssetManager::decode(std::shared_ptr<entry> _e) -> void
+  {
+    try
+    {
+      _e->pixels = Surface::load_bmp(_e->path);
+    }
+    catch(...)
+    {
+      _e->error = std::current_exception();
+    }
+    {
+      std::lock_guard<std::mutex> lock(uploads_mutex_);
+      _e->status = entry::state::decoded;
+      uploads_.push_back(std::move(_e));
+    }
+    decoded_.notify_all();
+  }
+auto AssetManager::upload(entry& _e) -> void
+  {
+    if(_e.error)
+    {
+      _e.status = entry::state::failed;
+      return;
+    }
+    try
+    {
+      auto sz = _e.pixels.get_size();
+      _e.texture.reset(renderer_, sz.w, sz.h, SDL_TEXTUREACCESS_STATIC);
+      _e.texture.set(SDL_BLENDMODE_BLEND);
+      _e.pixels.upload(_e.texture);
+      _e.pixels = Surface();
+      _e.status = entry::state::ready;
+    }
+    catch(...)
+    {
+      _e.error  = std::current_exception();
+      _e.status = entry::state::failed;
+    }
+  }
+auto AssetManager::pump(budget_t _budget) -> std::size_t
+  {
+    using clock = std::chrono::steady_clock;
+    auto deadline = clock::now() + _budget;
+    std::size_t uploaded = 0;
+    do
+    {
+      std::shared_ptr<entry> next;
+      {
+        std::lock_guard<std::mutex> lock(uploads_mutex_);
+        if(uploads_.empty())
+        {
+          break;
+        }
+        next = std::move(uploads_.front());
+        uploads_.pop_front();
+        --pending_;
+      }
+      upload(*next);
+      ++uploaded;
+    }
+    while(clock::now() < deadline);
+    return uploaded;
+  }
+auto AssetManager::finish() -> void
+  {
+    while(pending() > 0)
+    {
+      {
+        std::unique_lock<std::mutex> lock(uploads_mutex_);
+        decoded_.wait(lock, [&] { return !uploads_.empty(); });
+      }
+      pump(budget_t::zero());
+    }
+  }
+auto AssetManager::pending() const -> std::size_t
+  {
+    std::lock_guard<std::mutex> lock(uploads_mutex_);
+    return pending_;
+  }
+auto AssetManager::purge_unused() -> std::size_t
+  {
+    std::size_t dropped = 0;
+    for(auto e = cache_.begin(); e != cache_.end(); )
+    {
+      // entries still decoding are also held by their decode job
+      if(e->second.use_count() == 1 && e->second->status != entry::state::decoding)
+      {
+        e = cache_.erase(e);
+        ++dropped;
+      }
+      else
+      {
+        ++e;
+      }
+    }
+    return dropped;
+  }
+auto AssetManager::cached() const -> std::size_t
+  {
+    return cache_.size();
+  }
+} /* namespace gfx */
+} /* namespace kt */
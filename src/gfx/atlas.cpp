@@ -0,0 +1,221 @@
+#include <kt/gfx/atlas.hpp>
+#include <kt/gfx/renderer.hpp>
+#include <algorithm>
+#include <numeric>
+namespace kt {
+namespace gfx {
+SkylinePacker::SkylinePacker(int _w, int _h, int _padding)
+    : width_(_w)
+    , height_(_h)
+    , padding_(_padding)
+  {
+    reset();
+  }
+auto SkylinePacker::reset() -> void
+  {
+    skyline_.assign(1, segment { 0, 0, width_ });
+    used_area_ = 0;
+  }
+auto SkylinePacker::width() const -> int
+  {
+    return width_;
+  }
+auto SkylinePacker::height() const -> int
+  {
+    return height_;
+  }
+auto SkylinePacker::occupancy() const -> double
+  {
+    auto area = double(width_) * double(height_);
+    return area > 0? double(used_area_) / area : 0.0;
+  }
+auto SkylinePacker::fit(std::size_t _index, int _w, int _h) const -> std::optional<int>
+  {
+    auto x = skyline_[_index].x;
+    if(x + _w > width_)
+    {
+      return {};
+    }
+    // the rectangle rests on the highest segment it spans
+    auto y = 0;
+    auto remaining = _w;
+    for(auto i = _index; remaining > 0; ++i)
+    {
+      y = std::max(y, skyline_[i].y);
+      remaining -= skyline_[i].w;
+    }
+    if(y + _h > height_)
+    {
+      return {};
+    }
+    return y;
+  }
+auto SkylinePacker::pack(int _w, int _h) -> std::optional<SDL_Rect>
+  {
+    if(_w <= 0 || _h <= 0)
+    {
+      return SDL_Rect { 0, 0, 0, 0 };
+    }
+    auto w = _w + padding_;
+    auto h = _h + padding_;
+    std::optional<std::size_t> best;
+    int best_top    = 0;
+    int best_width  = 0;
+    for(std::size_t i = 0; i < skyline_.size(); ++i)
+    {
+      if(auto y = fit(i, w, h))
+      {
+        auto top = *y + h;
+        if(!best || top < best_top || (top == best_top && skyline_[i].w < best_width))
+        {
+          best        = i;
+          best_top    = top;
+          best_width  = skyline_[i].w;
+        }
+      }
+    }
+    if(!best)
+    {
+      return {};
+    }
+    auto index = *best;
+    SDL_Rect result { skyline_[index].x, best_top - h, _w, _h };
+    skyline_.insert(skyline_.begin() + index, segment { result.x, best_top, w });
+    // trim the segments now hidden under the new one
+    for(auto i = index + 1; i < skyline_.size(); )
+    {
+      auto& prev = skyline_[i - 1];
+      auto& cur  = skyline_[i];
+      auto overlap = prev.x + prev.w - cur.x;
+      if(overlap <= 0)
+      {
+        break;
+      }
+      if(overlap < cur.w)
+      {
+        cur.x += overlap;
+        cur.w -= overlap;
+        break;
+      }
+      skyline_.erase(skyline_.begin() + i);
+    }
+    for(std::size_t i = 1; i < skyline_.size(); )
+    {
+      if(skyline_[i - 1].y == skyline_[i].y)
+      {
+        skyline_[i - 1].w += skyline_[i].w;
+        skyline_.erase(skyline_.begin() + i);
+      }
+      else
+      {
+        ++i;
+      }
+    }
+    used_area_ += std::size_t(_w) * std::size_t(_h);
+    return result;
+  }
+
+Atlas::Atlas(int _page_w, int _page_h, int _padding)
+    : page_w_(_page_w)
+    , page_h_(_page_h)
+    , padding_(_padding)
+  {
+  }
+auto Atlas::add(const Surface& _image) -> region
+  {
+    // the packer pads every image, so the padding has to fit on the page too
+    if(_image.width() + padding_ > page_w_ || _image.height() + padding_ > page_h_)
+    {
+      throw std::runtime_error("image and padding are larger than an atlas page");
+    }
+    auto place = [&](page_store& _p, std::size_t _index) -> std::optional<region>
+      {
+        auto rect = _p.packer.pack(_image.width(), _image.height());
+        if(!rect)
+        {
+          return {};
+        }
+        _p.pixels.write(_image, rect->x, rect->y);
+        if(_p.dirty)
+        {
+          auto x1 = std::min(_p.dirty->x, rect->x);
+          auto y1 = std::min(_p.dirty->y, rect->y);
+          auto x2 = std::max(_p.dirty->x + _p.dirty->w, rect->x + rect->w);
+          auto y2 = std::max(_p.dirty->y + _p.dirty->h, rect->y + rect->h);
+          _p.dirty = SDL_Rect { x1, y1, x2 - x1, y2 - y1 };
+        }
+        else
+        {
+          _p.dirty = *rect;
+        }
+        return region { _index, *rect };
+      };
+    for(std::size_t i = 0; i < pages_.size(); ++i)
+    {
+      if(auto r = place(pages_[i], i))
+      {
+        return *r;
+      }
+    }
+    pages_.push_back(page_store
+      { SkylinePacker(page_w_, page_h_, padding_)
+      , Surface(page_w_, page_h_)
+      , Texture()
+      , SDL_Rect { 0, 0, page_w_, page_h_ }
+      });
+    auto r = place(pages_.back(), pages_.size() - 1);
+    if(!r)
+    {
+      pages_.pop_back();
+      throw std::runtime_error("image does not fit on an empty atlas page");
+    }
+    return *r;
+  }
+auto Atlas::add(const std::vector<const Surface*>& _images) -> std::vector<region>
+  {
+    std::vector<std::size_t> order(_images.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](auto _a, auto _b)
+      {
+        return _images[_a]->height() > _images[_b]->height();
+      });
+    std::vector<region> results(_images.size());
+    for(auto i : order)
+    {
+      results[i] = add(*_images[i]);
+    }
+    return results;
+  }
+auto Atlas::upload(Renderer& _r) -> void
+  {
+    for(auto& p : pages_)
+    {
+      if(!p.dirty)
+      {
+        continue;
+      }
+      if(p.texture.get() == nullptr)
+      {
+        p.texture.reset(_r, page_w_, page_h_, SDL_TEXTUREACCESS_STATIC);
+        p.texture.set(SDL_BLENDMODE_BLEND);
+        p.dirty = SDL_Rect { 0, 0, page_w_, page_h_ };
+      }
+      // only the rectangle bounding what was added since the last upload
+      p.texture.update(p.pixels.row(p.dirty->y) + p.dirty->x, p.pixels.pitch(), &*p.dirty);
+      p.dirty.reset();
+    }
+  }
+auto Atlas::pages() const -> std::size_t
+  {
+    return pages_.size();
+  }
+auto Atlas::page(std::size_t _index) const -> const Texture&
+  {
+    return pages_.at(_index).texture;
+  }
+auto Atlas::page_size() const -> Texture::size
+  {
+    return Texture::size { page_w_, page_h_ };
+  }
+} /* namespace gfx */
+} /* namespace kt */
@@ -1 +1,379 @@
 #include <kt/gfx/color.hpp>
+#include <kt/gfx/color_ops.hpp>
+#include <algorithm>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define KT_GFX_X86 1
+#endif
+namespace kt {
+namespace gfx {
+namespace color {
+namespace {
+auto add_scalar(uint32_t* _dst, const uint32_t* _src, std::size_t _n) -> void
+  {
+    for(std::size_t i = 0; i < _n; ++i)
+    {
+      _dst[i] = add(Color::from_pixel(_dst[i]), Color::from_pixel(_src[i])).pixel();
+    }
+  }
+auto subtract_scalar(uint32_t* _dst, const uint32_t* _src, std::size_t _n) -> void
+  {
+    for(std::size_t i = 0; i < _n; ++i)
+    {
+      _dst[i] = subtract(Color::from_pixel(_dst[i]), Color::from_pixel(_src[i])).pixel();
+    }
+  }
+auto multiply_scalar(uint32_t* _dst, const uint32_t* _src, std::size_t _n) -> void
+  {
+    for(std::size_t i = 0; i < _n; ++i)
+    {
+      _dst[i] = multiply(Color::from_pixel(_dst[i]), Color::from_pixel(_src[i])).pixel();
+    }
+  }
+auto lerp_scalar(uint32_t* _dst, const uint32_t* _src, std::size_t _n, uint8_t _t) -> void
+  {
+    for(std::size_t i = 0; i < _n; ++i)
+    {
+      _dst[i] = lerp(Color::from_pixel(_dst[i]), Color::from_pixel(_src[i]), _t).pixel();
+    }
+  }
+auto premultiply_scalar(uint32_t* _dst, std::size_t _n) -> void
+  {
+    for(std::size_t i = 0; i < _n; ++i)
+    {
+      _dst[i] = premultiply(Color::from_pixel(_dst[i])).pixel();
+    }
+  }
+#if defined(KT_GFX_X86) && defined(__SSE2__)
+inline auto div255_sse2(__m128i _x) -> __m128i
+  {
+    _x = _mm_add_epi16(_x, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(_x, _mm_srli_epi16(_x, 8)), 8);
+  }
+auto add_sse2(uint32_t* _dst, const uint32_t* _src, std::size_t _n) -> void
+  {
+    std::size_t i = 0;
+    for(; i + 4 <= _n; i += 4)
+    {
+      auto p = reinterpret_cast<__m128i*>(_dst + i);
+      auto s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_src + i));
+      _mm_storeu_si128(p, _mm_adds_epu8(_mm_loadu_si128(p), s));
+    }
+    add_scalar(_dst + i, _src + i, _n - i);
+  }
+auto subtract_sse2(uint32_t* _dst, const uint32_t* _src, std::size_t _n) -> void
+  {
+    std::size_t i = 0;
+    for(; i + 4 <= _n; i += 4)
+    {
+      auto p = reinterpret_cast<__m128i*>(_dst + i);
+      auto s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_src + i));
+      _mm_storeu_si128(p, _mm_subs_epu8(_mm_loadu_si128(p), s));
+    }
+    subtract_scalar(_dst + i, _src + i, _n - i);
+  }
+inline auto multiply4_sse2(__m128i _d, __m128i _s) -> __m128i
+  {
+    auto zero = _mm_setzero_si128();
+    auto lo   = div255_sse2(_mm_mullo_epi16(_mm_unpacklo_epi8(_d, zero), _mm_unpacklo_epi8(_s, zero)));
+    auto hi   = div255_sse2(_mm_mullo_epi16(_mm_unpackhi_epi8(_d, zero), _mm_unpackhi_epi8(_s, zero)));
+    return _mm_packus_epi16(lo, hi);
+  }
+auto multiply_sse2(uint32_t* _dst, const uint32_t* _src, std::size_t _n) -> void
+  {
+    std::size_t i = 0;
+    for(; i + 4 <= _n; i += 4)
+    {
+      auto p = reinterpret_cast<__m128i*>(_dst + i);
+      auto s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_src + i));
+      _mm_storeu_si128(p, multiply4_sse2(_mm_loadu_si128(p), s));
+    }
+    multiply_scalar(_dst + i, _src + i, _n - i);
+  }
+// d * (255 - t) + s * t never passes 255 * 255, so 16 bit lanes hold it
+auto lerp_sse2(uint32_t* _dst, const uint32_t* _src, std::size_t _n, uint8_t _t) -> void
+  {
+    auto zero = _mm_setzero_si128();
+    auto t    = _mm_set1_epi16(short(_t));
+    auto it   = _mm_set1_epi16(short(255 - _t));
+    std::size_t i = 0;
+    for(; i + 4 <= _n; i += 4)
+    {
+      auto p  = reinterpret_cast<__m128i*>(_dst + i);
+      auto d  = _mm_loadu_si128(p);
+      auto s  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_src + i));
+      auto lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), it), _mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), t));
+      auto hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), it), _mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), t));
+      _mm_storeu_si128(p, _mm_packus_epi16(div255_sse2(lo), div255_sse2(hi)));
+    }
+    lerp_scalar(_dst + i, _src + i, _n - i, _t);
+  }
+// colour lanes times alpha, the alpha lane times 255
+inline auto premultiply2_sse2(__m128i _x) -> __m128i
+  {
+    const auto alpha_lanes = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+    auto a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(_x, 0xFF), 0xFF);
+    a = _mm_or_si128(_mm_andnot_si128(alpha_lanes, a), _mm_and_si128(alpha_lanes, _mm_set1_epi16(255)));
+    return div255_sse2(_mm_mullo_epi16(_x, a));
+  }
+auto premultiply_sse2(uint32_t* _dst, std::size_t _n) -> void
+  {
+    auto zero = _mm_setzero_si128();
+    std::size_t i = 0;
+    for(; i + 4 <= _n; i += 4)
+    {
+      auto p = reinterpret_cast<__m128i*>(_dst + i);
+      auto d = _mm_loadu_si128(p);
+      _mm_storeu_si128(p, _mm_packus_epi16
+        ( premultiply2_sse2(_mm_unpacklo_epi8(d, zero))
+        , premultiply2_sse2(_mm_unpackhi_epi8(d, zero))
+        ));
+    }
+    premultiply_scalar(_dst + i, _n - i);
+  }
+#endif
+#if defined(KT_GFX_X86)
+#define KT_AVX2 __attribute__((target("avx2")))
+KT_AVX2 inline auto div255_avx2(__m256i _x) -> __m256i
+  {
+    _x = _mm256_add_epi16(_x, _mm256_set1_epi16(128));
+    return _mm256_srli_epi16(_mm256_add_epi16(_x, _mm256_srli_epi16(_x, 8)), 8);
+  }
+KT_AVX2 auto add_avx2(uint32_t* _dst, const uint32_t* _src, std::size_t _n) -> void
+  {
+    std::size_t i = 0;
+    for(; i + 8 <= _n; i += 8)
+    {
+      auto p = reinterpret_cast<__m256i*>(_dst + i);
+      auto s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(_src + i));
+      _mm256_storeu_si256(p, _mm256_adds_epu8(_mm256_loadu_si256(p), s));
+    }
+    add_scalar(_dst + i, _src + i, _n - i);
+  }
+KT_AVX2 auto subtract_avx2(uint32_t* _dst, const uint32_t* _src, std::size_t _n) -> void
+  {
+    std::size_t i = 0;
+    for(; i + 8 <= _n; i += 8)
+    {
+      auto p = reinterpret_cast<__m256i*>(_dst + i);
+      auto s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(_src + i));
+      _mm256_storeu_si256(p, _mm256_subs_epu8(_mm256_loadu_si256(p), s));
+    }
+    subtract_scalar(_dst + i, _src + i, _n - i);
+  }
+// unpack/pack work within 128-bit halves, so pixel order survives the trip
+KT_AVX2 auto multiply_avx2(uint32_t* _dst, const uint32_t* _src, std::size_t _n) -> void
+  {
+    auto zero = _mm256_setzero_si256();
+    std::size_t i = 0;
+    for(; i + 8 <= _n; i += 8)
+    {
+      auto p  = reinterpret_cast<__m256i*>(_dst + i);
+      auto d  = _mm256_loadu_si256(p);
+      auto s  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(_src + i));
+      auto lo = div255_avx2(_mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), _mm256_unpacklo_epi8(s, zero)));
+      auto hi = div255_avx2(_mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), _mm256_unpackhi_epi8(s, zero)));
+      _mm256_storeu_si256(p, _mm256_packus_epi16(lo, hi));
+    }
+    multiply_scalar(_dst + i, _src + i, _n - i);
+  }
+KT_AVX2 auto lerp_avx2(uint32_t* _dst, const uint32_t* _src, std::size_t _n, uint8_t _t) -> void
+  {
+    auto zero = _mm256_setzero_si256();
+    auto t    = _mm256_set1_epi16(short(_t));
+    auto it   = _mm256_set1_epi16(short(255 - _t));
+    std::size_t i = 0;
+    for(; i + 8 <= _n; i += 8)
+    {
+      auto p  = reinterpret_cast<__m256i*>(_dst + i);
+      auto d  = _mm256_loadu_si256(p);
+      auto s  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(_src + i));
+      auto lo = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), it), _mm256_mullo_epi16(_mm256_unpacklo_epi8(s, zero), t));
+      auto hi = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), it), _mm256_mullo_epi16(_mm256_unpackhi_epi8(s, zero), t));
+      _mm256_storeu_si256(p, _mm256_packus_epi16(div255_avx2(lo), div255_avx2(hi)));
+    }
+    lerp_scalar(_dst + i, _src + i, _n - i, _t);
+  }
+KT_AVX2 inline auto premultiply4_avx2(__m256i _x) -> __m256i
+  {
+    const auto alpha_lanes = _mm256_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0);
+    auto a = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(_x, 0xFF), 0xFF);
+    a = _mm256_blendv_epi8(a, _mm256_set1_epi16(255), alpha_lanes);
+    return div255_avx2(_mm256_mullo_epi16(_x, a));
+  }
+KT_AVX2 auto premultiply_avx2(uint32_t* _dst, std::size_t _n) -> void
+  {
+    auto zero = _mm256_setzero_si256();
+    std::size_t i = 0;
+    for(; i + 8 <= _n; i += 8)
+    {
+      auto p = reinterpret_cast<__m256i*>(_dst + i);
+      auto d = _mm256_loadu_si256(p);
+      _mm256_storeu_si256(p, _mm256_packus_epi16
+        ( premultiply4_avx2(_mm256_unpacklo_epi8(d, zero))
+        , premultiply4_avx2(_mm256_unpackhi_epi8(d, zero))
+        ));
+    }
+    premultiply_scalar(_dst + i, _n - i);
+  }
+#undef KT_AVX2
+#endif
+struct kernel_table
+{
+  void (*add)(uint32_t*, const uint32_t*, std::size_t);
+  void (*subtract)(uint32_t*, const uint32_t*, std::size_t);
+  void (*multiply)(uint32_t*, const uint32_t*, std::size_t);
+  void (*lerp)(uint32_t*, const uint32_t*, std::size_t, uint8_t);
+  void (*premultiply)(uint32_t*, std::size_t);
+};
+auto select_kernels() -> kernel_table
+  {
+#if defined(KT_GFX_X86)
+    if(__builtin_cpu_supports("avx2"))
+    {
+      return kernel_table { add_avx2, subtract_avx2, multiply_avx2, lerp_avx2, premultiply_avx2 };
+    }
+#endif
+#if defined(KT_GFX_X86) && defined(__SSE2__)
+    return kernel_table { add_sse2, subtract_sse2, multiply_sse2, lerp_sse2, premultiply_sse2 };
+#else
+    return kernel_table { add_scalar, subtract_scalar, multiply_scalar, lerp_scalar, premultiply_scalar };
+#endif
+  }
+auto kernels() -> const kernel_table&
+  {
+    static const kernel_table table = select_kernels();
+    return table;
+  }
+// a colour operand goes through the span kernels a stack tile at a time
+template<typename FnT>
+auto with_color(std::span<uint32_t> _dst, Color _c, FnT&& _fn) -> void
+  {
+    constexpr std::size_t tile_pixels = 256;
+    uint32_t tile[tile_pixels];
+    std::fill_n(tile, tile_pixels, _c.pixel());
+    for(std::size_t i = 0; i < _dst.size(); i += tile_pixels)
+    {
+      _fn(_dst.data() + i, tile, std::min(tile_pixels, _dst.size() - i));
+    }
+  }
+} /* namespace */
+
+auto add(std::span<uint32_t> _dst, std::span<const uint32_t> _src) -> void
+  {
+    kernels().add(_dst.data(), _src.data(), std::min(_dst.size(), _src.size()));
+  }
+auto add(std::span<uint32_t> _dst, Color _c) -> void
+  {
+    with_color(_dst, _c, kernels().add);
+  }
+auto subtract(std::span<uint32_t> _dst, std::span<const uint32_t> _src) -> void
+  {
+    kernels().subtract(_dst.data(), _src.data(), std::min(_dst.size(), _src.size()));
+  }
+auto subtract(std::span<uint32_t> _dst, Color _c) -> void
+  {
+    with_color(_dst, _c, kernels().subtract);
+  }
+auto multiply(std::span<uint32_t> _dst, std::span<const uint32_t> _src) -> void
+  {
+    kernels().multiply(_dst.data(), _src.data(), std::min(_dst.size(), _src.size()));
+  }
+auto multiply(std::span<uint32_t> _dst, Color _c) -> void
+  {
+    with_color(_dst, _c, kernels().multiply);
+  }
+auto lerp(std::span<uint32_t> _dst, std::span<const uint32_t> _src, uint8_t _t) -> void
+  {
+    kernels().lerp(_dst.data(), _src.data(), std::min(_dst.size(), _src.size()), _t);
+  }
+auto lerp(std::span<uint32_t> _dst, Color _c, uint8_t _t) -> void
+  {
+    with_color(_dst, _c, [_t](uint32_t* _d, const uint32_t* _s, std::size_t _n)
+      {
+        kernels().lerp(_d, _s, _n, _t);
+      });
+  }
+auto gradient(std::span<uint32_t> _dst, Color _from, Color _to) -> void
+  {
+    if(_dst.empty())
+    {
+      return;
+    }
+    // 16.16 fixed point steps, so long spans stay smooth past 256 pixels
+    auto steps = std::max<std::size_t>(_dst.size() - 1, 1);
+    int32_t from[4] = { _from.r(), _from.g(), _from.b(), _from.a() };
+    int32_t to[4]   = { _to.r(),   _to.g(),   _to.b(),   _to.a()   };
+    int64_t value[4];
+    int64_t step[4];
+    for(int c = 0; c < 4; ++c)
+    {
+      value[c] = (int64_t(from[c]) << 16) + 0x8000;
+      step[c]  = ((int64_t(to[c]) - from[c]) << 16) / int64_t(steps);
+    }
+    for(auto& p : _dst)
+    {
+      p = Color { uint8_t(value[0] >> 16), uint8_t(value[1] >> 16), uint8_t(value[2] >> 16), uint8_t(value[3] >> 16) }.pixel();
+      for(int c = 0; c < 4; ++c)
+      {
+        value[c] += step[c];
+      }
+    }
+    _dst.back() = _to.pixel();
+  }
+auto premultiply(std::span<uint32_t> _dst) -> void
+  {
+    kernels().premultiply(_dst.data(), _dst.size());
+  }
+auto unpremultiply(std::span<uint32_t> _dst) -> void
+  {
+    for(auto& p : _dst)
+    {
+      auto c = Color::from_pixel(p);
+      if(c.a() != SDL_ALPHA_OPAQUE)
+      {
+        p = unpremultiply(c).pixel();
+      }
+    }
+  }
+auto to_linear(std::span<const uint32_t> _src, std::span<uint16_t> _dst) -> void
+  {
+    auto n = std::min(_src.size(), _dst.size() / 4);
+    for(std::size_t i = 0; i < n; ++i)
+    {
+      auto c   = Color::from_pixel(_src[i]);
+      auto out = _dst.data() + i * 4;
+      out[0] = to_linear(c.r());
+      out[1] = to_linear(c.g());
+      out[2] = to_linear(c.b());
+      out[3] = uint16_t(c.a() * 257u);
+    }
+  }
+auto to_srgb(std::span<const uint16_t> _src, std::span<uint32_t> _dst) -> void
+  {
+    auto n = std::min(_src.size() / 4, _dst.size());
+    for(std::size_t i = 0; i < n; ++i)
+    {
+      auto in = _src.data() + i * 4;
+      _dst[i] = Color { to_srgb(in[0]), to_srgb(in[1]), to_srgb(in[2]), uint8_t((in[3] * 255u + 32767u) / 65535u) }.pixel();
+    }
+  }
+auto to_hsv(std::span<const uint32_t> _src, std::span<hsv> _dst) -> void
+  {
+    auto n = std::min(_src.size(), _dst.size());
+    for(std::size_t i = 0; i < n; ++i)
+    {
+      _dst[i] = to_hsv(Color::from_pixel(_src[i]));
+    }
+  }
+auto from_hsv(std::span<const hsv> _src, std::span<uint32_t> _dst) -> void
+  {
+    auto n = std::min(_src.size(), _dst.size());
+    for(std::size_t i = 0; i < n; ++i)
+    {
+      _dst[i] = from_hsv(_src[i]).pixel();
+    }
+  }
+} /* namespace color */
+} /* namespace gfx */
+} /* namespace kt */
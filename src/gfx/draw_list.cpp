@@ -0,0 +1,217 @@
+#include <kt/gfx/draw_list.hpp>
+#include <kt/trace.hpp>
+#include <algorithm>
+#include <type_traits>
+namespace kt {
+namespace gfx {
+auto DrawList::color(const Color& _c) -> void
+  {
+    commands_.emplace_back(set_color { _c });
+  }
+auto DrawList::set_draw_blend(SDL_BlendMode _mode) -> void
+  {
+    commands_.emplace_back(set_blend { _mode });
+  }
+auto DrawList::clear() -> void
+  {
+    commands_.emplace_back(do_clear {});
+  }
+auto DrawList::point(int _x, int _y) -> void
+  {
+    commands_.emplace_back(do_point { _x, _y });
+  }
+auto DrawList::line(int _x1, int _y1, int _x2, int _y2) -> void
+  {
+    commands_.emplace_back(do_line { _x1, _y1, _x2, _y2 });
+  }
+auto DrawList::line_f(float _x1, float _y1, float _x2, float _y2) -> void
+  {
+    commands_.emplace_back(do_line_f { _x1, _y1, _x2, _y2 });
+  }
+auto DrawList::fill_rect(const SDL_Rect& _r) -> void
+  {
+    commands_.emplace_back(do_fill_rect { _r });
+  }
+auto DrawList::circle(int _cx, int _cy, int _radius, bool _fill) -> void
+  {
+    commands_.emplace_back(do_circle { _cx, _cy, _radius, _fill });
+  }
+auto DrawList::set_clip(const SDL_Rect& _clip) -> void
+  {
+    commands_.emplace_back(do_clip { _clip });
+  }
+auto DrawList::clear_clip() -> void
+  {
+    commands_.emplace_back(do_unclip {});
+  }
+auto DrawList::copy(const Texture& _t, const SDL_Rect& _dest) -> void
+  {
+    commands_.emplace_back(do_copy { &_t, SDL_Rect {}, _dest, 0.0, true });
+  }
+auto DrawList::copy(const Texture& _t, const SDL_Rect& _src, const SDL_Rect& _dest, double _angle) -> void
+  {
+    commands_.emplace_back(do_copy { &_t, _src, _dest, _angle, false });
+  }
+auto DrawList::geometry(const Texture* _t, const SDL_Vertex* _vertices, int _num_vertices, const int* _indices, int _num_indices) -> void
+  {
+    if(_num_vertices <= 0)
+    {
+      return;
+    }
+    auto first_vertex = vertices_.size();
+    auto first_index  = indices_.size();
+    vertices_.insert(vertices_.end(), _vertices, _vertices + _num_vertices);
+    if(_indices && _num_indices > 0)
+    {
+      indices_.insert(indices_.end(), _indices, _indices + _num_indices);
+    }
+    commands_.emplace_back(do_geometry { _t, first_vertex, std::size_t(_num_vertices), first_index, indices_.size() - first_index });
+  }
+auto DrawList::submit(Renderer& _r) const -> void
+  {
+    for(const auto& c : commands_)
+    {
+      std::visit([&](const auto& _op)
+        {
+          using op_t = std::decay_t<decltype(_op)>;
+          if constexpr(std::is_same_v<op_t, set_color>)
+          {
+            _r.color(_op.c);
+          }
+          else if constexpr(std::is_same_v<op_t, set_blend>)
+          {
+            _r.set_draw_blend(_op.mode);
+          }
+          else if constexpr(std::is_same_v<op_t, do_clear>)
+          {
+            _r.clear();
+          }
+          else if constexpr(std::is_same_v<op_t, do_point>)
+          {
+            _r.point(_op.x, _op.y);
+          }
+          else if constexpr(std::is_same_v<op_t, do_line>)
+          {
+            _r.line(_op.x1, _op.y1, _op.x2, _op.y2);
+          }
+          else if constexpr(std::is_same_v<op_t, do_line_f>)
+          {
+            _r.line_f(_op.x1, _op.y1, _op.x2, _op.y2);
+          }
+          else if constexpr(std::is_same_v<op_t, do_fill_rect>)
+          {
+            _r.fill_rect(_op.r);
+          }
+          else if constexpr(std::is_same_v<op_t, do_circle>)
+          {
+            _r.circle(_op.cx, _op.cy, _op.radius, _op.fill);
+          }
+          else if constexpr(std::is_same_v<op_t, do_clip>)
+          {
+            _r.set_clip(_op.r);
+          }
+          else if constexpr(std::is_same_v<op_t, do_unclip>)
+          {
+            _r.clear_clip();
+          }
+          else if constexpr(std::is_same_v<op_t, do_copy>)
+          {
+            auto src  = _op.src;
+            auto dest = _op.dest;
+            if(_op.whole)
+            {
+              _r.copy(*_op.t, dest);
+            }
+            else if(_op.angle != 0.0)
+            {
+              _r.copy(*_op.t, src, dest, _op.angle);
+            }
+            else
+            {
+              _r.copy(*_op.t, src, dest);
+            }
+          }
+          else if constexpr(std::is_same_v<op_t, do_geometry>)
+          {
+            _r.geometry
+                ( _op.t
+                , vertices_.data() + _op.first_vertex, int(_op.vertex_count)
+                , _op.index_count? indices_.data() + _op.first_index : nullptr, int(_op.index_count)
+                );
+          }
+        }, c);
+    }
+  }
+auto DrawList::reset() -> void
+  {
+    commands_.clear();
+    vertices_.clear();
+    indices_.clear();
+  }
+auto DrawList::size() const -> std::size_t
+  {
+    return commands_.size();
+  }
+auto DrawList::empty() const -> bool
+  {
+    return commands_.empty();
+  }
+
+DrawRecorder::DrawRecorder(thread_pool& _pool)
+    : pool_(_pool)
+  {
+  }
+auto DrawRecorder::add(task _t) -> void
+  {
+    tasks_.push_back(std::move(_t));
+  }
+auto DrawRecorder::record() -> void
+  {
+    KT_TRACE_ZONE("record", "gfx");
+    if(lists_.size() < tasks_.size())
+    {
+      lists_.resize(tasks_.size());
+    }
+    // tasks vary in cost, so hand them out one at a time
+    pool_.parallel_for(recorded_, tasks_.size(), 1, [this](std::size_t _begin, std::size_t _end)
+      {
+        for(auto i = _begin; i < _end; ++i)
+        {
+          KT_TRACE_ZONE("record task", "gfx");
+          tasks_[i](lists_[i]);
+        }
+      });
+    recorded_ = tasks_.size();
+  }
+auto DrawRecorder::submit(Renderer& _r) -> void
+  {
+    record();
+    KT_TRACE_ZONE("submit lists", "gfx");
+    last_commands_ = 0;
+    for(std::size_t i = 0; i < tasks_.size(); ++i)
+    {
+      last_commands_ += lists_[i].size();
+      lists_[i].submit(_r);
+    }
+    reset();
+  }
+auto DrawRecorder::reset() -> void
+  {
+    // tasks added since the last record() have no list yet
+    for(std::size_t i = 0; i < std::min(tasks_.size(), lists_.size()); ++i)
+    {
+      lists_[i].reset();
+    }
+    tasks_.clear();
+    recorded_ = 0;
+  }
+auto DrawRecorder::tasks() const -> std::size_t
+  {
+    return tasks_.size();
+  }
+auto DrawRecorder::last_commands() const -> std::size_t
+  {
+    return last_commands_;
+  }
+} /* namespace gfx */
+} /* namespace kt */
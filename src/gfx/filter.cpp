@@ -0,0 +1,753 @@
+#include <kt/gfx/filter.hpp>
+#include <kt/trace.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <new>
+#include <numbers>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define KT_GFX_X86 1
+#endif
+namespace kt {
+namespace gfx {
+namespace {
+// the vertical passes work on strips of this many pixels, so the rows a
+// tile reads stay in cache and box sums fit on the stack
+constexpr int strip_pixels = 64;
+
+// luma weights in 8.8 fixed point, summing to 256
+constexpr int luma_r = 54, luma_g = 183, luma_b = 19;
+
+inline auto channel(uint32_t _p, int _c) -> uint32_t
+  {
+    return (_p >> (8 * _c)) & 0xFF;
+  }
+inline auto to_byte(float _v) -> uint32_t
+  {
+    return uint32_t(std::clamp(std::lrint(_v), 0L, 255L));
+  }
+auto to_float_scalar(const uint32_t* _src, float* _dst, std::size_t _n) -> void
+  {
+    for(std::size_t i = 0; i < _n; ++i)
+    {
+      for(int c = 0; c < 4; ++c)
+      {
+        _dst[4 * i + c] = float(channel(_src[i], c));
+      }
+    }
+  }
+auto from_float_scalar(const float* _src, uint32_t* _dst, std::size_t _n) -> void
+  {
+    for(std::size_t i = 0; i < _n; ++i)
+    {
+      uint32_t p = 0;
+      for(int c = 0; c < 4; ++c)
+      {
+        p |= to_byte(_src[4 * i + c]) << (8 * c);
+      }
+      _dst[i] = p;
+    }
+  }
+auto horizontal_scalar(const float* _row, float* _out, std::size_t _n, const int* _first, const int* _count, const float* _weights, int _width) -> void
+  {
+    for(std::size_t x = 0; x < _n; ++x)
+    {
+      float acc[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+      auto  src = _row + 4 * std::size_t(_first[x]);
+      auto  w   = _weights + x * std::size_t(_width);
+      for(int k = 0; k < _count[x]; ++k)
+      {
+        for(int c = 0; c < 4; ++c)
+        {
+          acc[c] += w[k] * src[4 * k + c];
+        }
+      }
+      std::memcpy(_out + 4 * x, acc, sizeof(acc));
+    }
+  }
+auto vertical_scalar(const float* _rows, std::size_t _stride, int _count, const float* _weights, uint32_t* _dst, std::size_t _n) -> void
+  {
+    for(std::size_t i = 0; i < 4 * _n; i += 4)
+    {
+      float acc[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+      for(int k = 0; k < _count; ++k)
+      {
+        for(int c = 0; c < 4; ++c)
+        {
+          acc[c] += _weights[k] * _rows[std::size_t(k) * _stride + i + c];
+        }
+      }
+      from_float_scalar(acc, _dst + i / 4, 1);
+    }
+  }
+auto box_accumulate_scalar(int32_t* _sums, const uint32_t* _add, const uint32_t* _sub, std::size_t _n) -> void
+  {
+    for(std::size_t i = 0; i < _n; ++i)
+    {
+      for(int c = 0; c < 4; ++c)
+      {
+        _sums[4 * i + c] += int32_t(channel(_add[i], c)) - int32_t(channel(_sub[i], c));
+      }
+    }
+  }
+auto box_store_scalar(const int32_t* _sums, uint32_t* _dst, float _scale, std::size_t _n) -> void
+  {
+    for(std::size_t i = 0; i < _n; ++i)
+    {
+      uint32_t p = 0;
+      for(int c = 0; c < 4; ++c)
+      {
+        p |= to_byte(float(_sums[4 * i + c]) * _scale) << (8 * c);
+      }
+      _dst[i] = p;
+    }
+  }
+#if !defined(KT_GFX_X86) || !defined(__SSE2__)
+auto box_row_scalar(const uint32_t* _src, uint32_t* _dst, int _w, int _radius, float _scale) -> void
+  {
+    int32_t sum[4] = { 0, 0, 0, 0 };
+    for(auto x = -_radius; x <= _radius; ++x)
+    {
+      auto p = _src[std::clamp(x, 0, _w - 1)];
+      for(int c = 0; c < 4; ++c)
+      {
+        sum[c] += int32_t(channel(p, c));
+      }
+    }
+    for(int x = 0; x < _w; ++x)
+    {
+      box_store_scalar(sum, _dst + x, _scale, 1);
+      box_accumulate_scalar(sum, _src + std::min(x + _radius + 1, _w - 1), _src + std::max(x - _radius, 0), 1);
+    }
+  }
+#endif
+auto threshold_scalar(const uint32_t* _src, uint32_t* _dst, std::size_t _n, uint8_t _level) -> void
+  {
+    for(std::size_t i = 0; i < _n; ++i)
+    {
+      auto p    = _src[i];
+      auto luma = (luma_r * channel(p, 0) + luma_g * channel(p, 1) + luma_b * channel(p, 2)) >> 8;
+      _dst[i]   = p & (0u - uint32_t(luma >= _level));
+    }
+  }
+auto add_scaled_scalar(uint32_t* _dst, const uint32_t* _glow, std::size_t _n, int _scale) -> void
+  {
+    for(std::size_t i = 0; i < _n; ++i)
+    {
+      uint32_t p = 0;
+      for(int c = 0; c < 4; ++c)
+      {
+        auto v = channel(_dst[i], c) + ((channel(_glow[i], c) * uint32_t(_scale)) >> 8);
+        p |= std::min(v, 255u) << (8 * c);
+      }
+      _dst[i] = p;
+    }
+  }
+#if defined(KT_GFX_X86) && defined(__SSE2__)
+// four pixels of bytes to four vectors of channel floats, and back
+inline auto unpack4_sse2(__m128i _p, __m128 _out[4]) -> void
+  {
+    auto zero = _mm_setzero_si128();
+    auto lo   = _mm_unpacklo_epi8(_p, zero);
+    auto hi   = _mm_unpackhi_epi8(_p, zero);
+    _out[0] = _mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero));
+    _out[1] = _mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero));
+    _out[2] = _mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero));
+    _out[3] = _mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero));
+  }
+inline auto pack4_sse2(__m128i _a, __m128i _b, __m128i _c, __m128i _d) -> __m128i
+  {
+    return _mm_packus_epi16(_mm_packs_epi32(_a, _b), _mm_packs_epi32(_c, _d));
+  }
+auto to_float_sse2(const uint32_t* _src, float* _dst, std::size_t _n) -> void
+  {
+    std::size_t i = 0;
+    for(; i + 4 <= _n; i += 4)
+    {
+      __m128 v[4];
+      unpack4_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(_src + i)), v);
+      for(int k = 0; k < 4; ++k)
+      {
+        _mm_storeu_ps(_dst + 4 * (i + k), v[k]);
+      }
+    }
+    to_float_scalar(_src + i, _dst + 4 * i, _n - i);
+  }
+auto from_float_sse2(const float* _src, uint32_t* _dst, std::size_t _n) -> void
+  {
+    std::size_t i = 0;
+    for(; i + 4 <= _n; i += 4)
+    {
+      auto s = _src + 4 * i;
+      auto p = pack4_sse2
+        ( _mm_cvtps_epi32(_mm_loadu_ps(s))
+        , _mm_cvtps_epi32(_mm_loadu_ps(s + 4))
+        , _mm_cvtps_epi32(_mm_loadu_ps(s + 8))
+        , _mm_cvtps_epi32(_mm_loadu_ps(s + 12))
+        );
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(_dst + i), p);
+    }
+    from_float_scalar(_src + 4 * i, _dst + i, _n - i);
+  }
+auto horizontal_sse2(const float* _row, float* _out, std::size_t _n, const int* _first, const int* _count, const float* _weights, int _width) -> void
+  {
+    // one pixel's four channels fill a register, so each tap is one
+    // multiply-add; four pixels go together so their sums don't wait on each
+    // other, all running to the padded width, whose extra weights are zero
+    std::size_t x = 0;
+    for(; x + 4 <= _n; x += 4)
+    {
+      auto a0 = _mm_setzero_ps(), a1 = a0, a2 = a0, a3 = a0;
+      auto s0 = _row + 4 * std::size_t(_first[x]);
+      auto s1 = _row + 4 * std::size_t(_first[x + 1]);
+      auto s2 = _row + 4 * std::size_t(_first[x + 2]);
+      auto s3 = _row + 4 * std::size_t(_first[x + 3]);
+      auto w  = _weights + x * std::size_t(_width);
+      auto ww = std::size_t(_width);
+      for(std::size_t k = 0; k < ww; ++k)
+      {
+        a0 = _mm_add_ps(a0, _mm_mul_ps(_mm_set1_ps(w[k]), _mm_loadu_ps(s0 + 4 * k)));
+        a1 = _mm_add_ps(a1, _mm_mul_ps(_mm_set1_ps(w[ww + k]), _mm_loadu_ps(s1 + 4 * k)));
+        a2 = _mm_add_ps(a2, _mm_mul_ps(_mm_set1_ps(w[2 * ww + k]), _mm_loadu_ps(s2 + 4 * k)));
+        a3 = _mm_add_ps(a3, _mm_mul_ps(_mm_set1_ps(w[3 * ww + k]), _mm_loadu_ps(s3 + 4 * k)));
+      }
+      _mm_storeu_ps(_out + 4 * x, a0);
+      _mm_storeu_ps(_out + 4 * x + 4, a1);
+      _mm_storeu_ps(_out + 4 * x + 8, a2);
+      _mm_storeu_ps(_out + 4 * x + 12, a3);
+    }
+    horizontal_scalar(_row, _out + 4 * x, _n - x, _first + x, _count + x, _weights + x * std::size_t(_width), _width);
+  }
+auto vertical_sse2(const float* _rows, std::size_t _stride, int _count, const float* _weights, uint32_t* _dst, std::size_t _n) -> void
+  {
+    // four pixels at a time, summed down the rows in registers
+    std::size_t i = 0;
+    for(; i + 4 <= _n; i += 4)
+    {
+      auto a0 = _mm_setzero_ps(), a1 = a0, a2 = a0, a3 = a0;
+      auto src = _rows + 4 * i;
+      for(int k = 0; k < _count; ++k, src += _stride)
+      {
+        auto w = _mm_set1_ps(_weights[k]);
+        a0 = _mm_add_ps(a0, _mm_mul_ps(w, _mm_loadu_ps(src)));
+        a1 = _mm_add_ps(a1, _mm_mul_ps(w, _mm_loadu_ps(src + 4)));
+        a2 = _mm_add_ps(a2, _mm_mul_ps(w, _mm_loadu_ps(src + 8)));
+        a3 = _mm_add_ps(a3, _mm_mul_ps(w, _mm_loadu_ps(src + 12)));
+      }
+      auto p = pack4_sse2(_mm_cvtps_epi32(a0), _mm_cvtps_epi32(a1), _mm_cvtps_epi32(a2), _mm_cvtps_epi32(a3));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(_dst + i), p);
+    }
+    vertical_scalar(_rows + 4 * i, _stride, _count, _weights, _dst + i, _n - i);
+  }
+inline auto widen4_sse2(__m128i _p, __m128i _out[4]) -> void
+  {
+    auto zero = _mm_setzero_si128();
+    auto lo   = _mm_unpacklo_epi8(_p, zero);
+    auto hi   = _mm_unpackhi_epi8(_p, zero);
+    _out[0] = _mm_unpacklo_epi16(lo, zero);
+    _out[1] = _mm_unpackhi_epi16(lo, zero);
+    _out[2] = _mm_unpacklo_epi16(hi, zero);
+    _out[3] = _mm_unpackhi_epi16(hi, zero);
+  }
+auto box_accumulate_sse2(int32_t* _sums, const uint32_t* _add, const uint32_t* _sub, std::size_t _n) -> void
+  {
+    std::size_t i = 0;
+    for(; i + 4 <= _n; i += 4)
+    {
+      __m128i a[4], s[4];
+      widen4_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(_add + i)), a);
+      widen4_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(_sub + i)), s);
+      for(int k = 0; k < 4; ++k)
+      {
+        auto p = reinterpret_cast<__m128i*>(_sums + 4 * (i + k));
+        _mm_storeu_si128(p, _mm_add_epi32(_mm_loadu_si128(p), _mm_sub_epi32(a[k], s[k])));
+      }
+    }
+    box_accumulate_scalar(_sums + 4 * i, _add + i, _sub + i, _n - i);
+  }
+auto box_store_sse2(const int32_t* _sums, uint32_t* _dst, float _scale, std::size_t _n) -> void
+  {
+    auto scale = _mm_set1_ps(_scale);
+    auto mean  = [&](const int32_t* _s)
+      {
+        auto v = _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(_s)));
+        return _mm_cvtps_epi32(_mm_mul_ps(v, scale));
+      };
+    std::size_t i = 0;
+    for(; i + 4 <= _n; i += 4)
+    {
+      auto s = _sums + 4 * i;
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(_dst + i), pack4_sse2(mean(s), mean(s + 4), mean(s + 8), mean(s + 12)));
+    }
+    box_store_scalar(_sums + 4 * i, _dst + i, _scale, _n - i);
+  }
+auto box_row_sse2(const uint32_t* _src, uint32_t* _dst, int _w, int _radius, float _scale) -> void
+  {
+    // a pixel's four channel sums share a register; each step adds the
+    // pixel entering the window and takes away the one leaving
+    auto zero   = _mm_setzero_si128();
+    auto widen  = [&](uint32_t _p)
+      {
+        return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(int(_p)), zero), zero);
+      };
+    auto scale  = _mm_set1_ps(_scale);
+    auto sum    = zero;
+    for(auto x = -_radius; x <= _radius; ++x)
+    {
+      sum = _mm_add_epi32(sum, widen(_src[std::clamp(x, 0, _w - 1)]));
+    }
+    for(int x = 0; x < _w; ++x)
+    {
+      auto mean = _mm_cvtps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(sum), scale));
+      auto p    = _mm_packus_epi16(_mm_packs_epi32(mean, zero), zero);
+      _dst[x]   = uint32_t(_mm_cvtsi128_si32(p));
+      sum = _mm_add_epi32(sum, _mm_sub_epi32(widen(_src[std::min(x + _radius + 1, _w - 1)]), widen(_src[std::max(x - _radius, 0)])));
+    }
+  }
+auto threshold_sse2(const uint32_t* _src, uint32_t* _dst, std::size_t _n, uint8_t _level) -> void
+  {
+    auto mask  = _mm_set1_epi32(0xFF);
+    auto wr    = _mm_set1_epi32(luma_r);
+    auto wg    = _mm_set1_epi32(luma_g);
+    auto wb    = _mm_set1_epi32(luma_b);
+    auto below = _mm_set1_epi32(int(_level) - 1);
+    std::size_t i = 0;
+    for(; i + 4 <= _n; i += 4)
+    {
+      auto p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_src + i));
+      // each channel sits alone in a 32-bit lane, so madd is a plain multiply
+      auto luma = _mm_add_epi32
+        ( _mm_madd_epi16(_mm_and_si128(p, mask), wr)
+        , _mm_add_epi32
+          ( _mm_madd_epi16(_mm_and_si128(_mm_srli_epi32(p, 8), mask), wg)
+          , _mm_madd_epi16(_mm_and_si128(_mm_srli_epi32(p, 16), mask), wb)
+          )
+        );
+      auto keep = _mm_cmpgt_epi32(_mm_srli_epi32(luma, 8), below);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(_dst + i), _mm_and_si128(p, keep));
+    }
+    threshold_scalar(_src + i, _dst + i, _n - i, _level);
+  }
+auto add_scaled_sse2(uint32_t* _dst, const uint32_t* _glow, std::size_t _n, int _scale) -> void
+  {
+    auto zero  = _mm_setzero_si128();
+    auto scale = _mm_set1_epi16(short(_scale));
+    std::size_t i = 0;
+    for(; i + 4 <= _n; i += 4)
+    {
+      auto g  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_glow + i));
+      // (glow << 8) * scale >> 16 is glow * scale / 256
+      auto lo = _mm_mulhi_epu16(_mm_slli_epi16(_mm_unpacklo_epi8(g, zero), 8), scale);
+      auto hi = _mm_mulhi_epu16(_mm_slli_epi16(_mm_unpackhi_epi8(g, zero), 8), scale);
+      auto p  = reinterpret_cast<__m128i*>(_dst + i);
+      _mm_storeu_si128(p, _mm_adds_epu8(_mm_loadu_si128(p), _mm_packus_epi16(lo, hi)));
+    }
+    add_scaled_scalar(_dst + i, _glow + i, _n - i, _scale);
+  }
+#endif
+#if defined(KT_GFX_X86)
+#define KT_AVX2 __attribute__((target("avx2")))
+KT_AVX2 auto vertical_avx2(const float* _rows, std::size_t _stride, int _count, const float* _weights, uint32_t* _dst, std::size_t _n) -> void
+  {
+    std::size_t i = 0;
+    for(; i + 8 <= _n; i += 8)
+    {
+      auto a0 = _mm256_setzero_ps(), a1 = a0, a2 = a0, a3 = a0;
+      auto src = _rows + 4 * i;
+      for(int k = 0; k < _count; ++k, src += _stride)
+      {
+        auto w = _mm256_set1_ps(_weights[k]);
+        a0 = _mm256_add_ps(a0, _mm256_mul_ps(w, _mm256_loadu_ps(src)));
+        a1 = _mm256_add_ps(a1, _mm256_mul_ps(w, _mm256_loadu_ps(src + 8)));
+        a2 = _mm256_add_ps(a2, _mm256_mul_ps(w, _mm256_loadu_ps(src + 16)));
+        a3 = _mm256_add_ps(a3, _mm256_mul_ps(w, _mm256_loadu_ps(src + 24)));
+      }
+      // packs work within 128-bit halves, so pixels come out as 0 2 4 6 |
+      // 1 3 5 7 and need one cross-lane permute
+      auto lo = _mm256_packs_epi32(_mm256_cvtps_epi32(a0), _mm256_cvtps_epi32(a1));
+      auto hi = _mm256_packs_epi32(_mm256_cvtps_epi32(a2), _mm256_cvtps_epi32(a3));
+      auto p  = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(lo, hi), _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(_dst + i), p);
+    }
+    vertical_scalar(_rows + 4 * i, _stride, _count, _weights, _dst + i, _n - i);
+  }
+KT_AVX2 auto box_accumulate_avx2(int32_t* _sums, const uint32_t* _add, const uint32_t* _sub, std::size_t _n) -> void
+  {
+    std::size_t i = 0;
+    for(; i + 2 <= _n; i += 2)
+    {
+      auto a = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(_add + i)));
+      auto s = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(_sub + i)));
+      auto p = reinterpret_cast<__m256i*>(_sums + 4 * i);
+      _mm256_storeu_si256(p, _mm256_add_epi32(_mm256_loadu_si256(p), _mm256_sub_epi32(a, s)));
+    }
+    box_accumulate_scalar(_sums + 4 * i, _add + i, _sub + i, _n - i);
+  }
+#undef KT_AVX2
+#endif
+struct kernel_table
+{
+  void (*to_float)(const uint32_t*, float*, std::size_t);
+  void (*from_float)(const float*, uint32_t*, std::size_t);
+  void (*horizontal)(const float*, float*, std::size_t, const int*, const int*, const float*, int);
+  void (*vertical)(const float*, std::size_t, int, const float*, uint32_t*, std::size_t);
+  void (*box_accumulate)(int32_t*, const uint32_t*, const uint32_t*, std::size_t);
+  void (*box_store)(const int32_t*, uint32_t*, float, std::size_t);
+  void (*box_row)(const uint32_t*, uint32_t*, int, int, float);
+  void (*threshold)(const uint32_t*, uint32_t*, std::size_t, uint8_t);
+  void (*add_scaled)(uint32_t*, const uint32_t*, std::size_t, int);
+};
+auto select_kernels() -> kernel_table
+  {
+#if defined(KT_GFX_X86) && defined(__SSE2__)
+    kernel_table table
+      { to_float_sse2, from_float_sse2, horizontal_sse2, vertical_sse2
+      , box_accumulate_sse2, box_store_sse2, box_row_sse2, threshold_sse2, add_scaled_sse2
+      };
+    if(__builtin_cpu_supports("avx2"))
+    {
+      table.vertical        = vertical_avx2;
+      table.box_accumulate  = box_accumulate_avx2;
+    }
+    return table;
+#else
+    return kernel_table
+      { to_float_scalar, from_float_scalar, horizontal_scalar, vertical_scalar
+      , box_accumulate_scalar, box_store_scalar, box_row_scalar, threshold_scalar, add_scaled_scalar
+      };
+#endif
+  }
+auto kernels() -> const kernel_table&
+  {
+    static const kernel_table table = select_kernels();
+    return table;
+  }
+inline auto sinc(float _x) -> float
+  {
+    if(_x == 0.0f)
+    {
+      return 1.0f;
+    }
+    auto px = std::numbers::pi_v<float> * _x;
+    return std::sin(px) / px;
+  }
+/*! \brief  Fill `_t` with the weights mapping `_in` samples to `_out`, the
+ *          filter `_fn` spanning `_support` on each side and widened by the
+ *          scale when shrinking.  Taps falling outside are dropped and the
+ *          rest renormalised; each output's weights are padded with zeros
+ *          to `width`.
+ */
+template<typename TapsT, typename FnT>
+auto build_taps(TapsT& _t, int _in, int _out, float _support, FnT&& _fn) -> void
+  {
+    auto scale    = float(_in) / float(_out);
+    auto widen    = std::max(scale, 1.0f);
+    auto support  = _support * widen;
+    _t.width      = std::max(1, int(std::ceil(support)) * 2 + 1);
+    _t.first.assign(std::size_t(_out), 0);
+    _t.count.assign(std::size_t(_out), 0);
+    _t.weights.assign(std::size_t(_out) * std::size_t(_t.width), 0.0f);
+    for(int i = 0; i < _out; ++i)
+    {
+      auto center = (float(i) + 0.5f) * scale;
+      auto lo     = std::max(0, int(std::floor(center - support + 0.5f)));
+      auto hi     = std::min(_in, int(std::floor(center + support + 0.5f)));
+      hi          = std::min(hi, lo + _t.width);
+      auto w      = _t.weights.data() + std::size_t(i) * std::size_t(_t.width);
+      auto total  = 0.0f;
+      for(auto j = lo; j < hi; ++j)
+      {
+        w[j - lo] = _fn((float(j) + 0.5f - center) / widen);
+        total    += w[j - lo];
+      }
+      if(total == 0.0f)
+      {
+        // nothing in reach; take the nearest sample
+        lo    = std::clamp(int(center), 0, _in - 1);
+        hi    = lo + 1;
+        w[0]  = 1.0f;
+        total = 1.0f;
+      }
+      for(auto j = lo; j < hi; ++j)
+      {
+        w[j - lo] /= total;
+      }
+      _t.first[std::size_t(i)] = lo;
+      _t.count[std::size_t(i)] = hi - lo;
+    }
+  }
+} /* namespace */
+
+auto ScratchArena::add_block(std::size_t _bytes) -> void
+  {
+    _bytes = (_bytes + alignment - 1) & ~(alignment - 1);
+    auto p = static_cast<std::byte*>(std::aligned_alloc(alignment, _bytes));
+    if(!p)
+    {
+      throw std::bad_alloc();
+    }
+    blocks_.push_back(block { decltype(block::data)(p), _bytes });
+    used_ = 0;
+  }
+auto ScratchArena::take_bytes(std::size_t _bytes) -> void*
+  {
+    _bytes = (std::max<std::size_t>(_bytes, 1) + alignment - 1) & ~(alignment - 1);
+    if(blocks_.empty() || blocks_.back().size - used_ < _bytes)
+    {
+      add_block(std::max(_bytes, blocks_.empty()? std::size_t(1) << 20 : blocks_.back().size));
+    }
+    auto p = blocks_.back().data.get() + used_;
+    used_ += _bytes;
+    return p;
+  }
+auto ScratchArena::rewind() -> void
+  {
+    // fold the blocks into one big enough for the lot, so the next round
+    // fits without allocating
+    if(blocks_.size() > 1)
+    {
+      std::size_t total = 0;
+      for(const auto& b : blocks_)
+      {
+        total += b.size;
+      }
+      blocks_.clear();
+      add_block(total);
+    }
+    used_ = 0;
+  }
+auto ScratchArena::capacity() const -> std::size_t
+  {
+    std::size_t total = 0;
+    for(const auto& b : blocks_)
+    {
+      total += b.size;
+    }
+    return total;
+  }
+
+FilterPipeline::FilterPipeline(thread_pool& _pool)
+    : pool_(_pool)
+  {
+  }
+auto FilterPipeline::row_chunks(int _rows) const -> std::size_t
+  {
+    return std::min<std::size_t>(std::size_t(std::max(_rows, 1)), 4 * (pool_.size() + 1));
+  }
+auto FilterPipeline::convolve(const uint32_t* _src, int _src_w, int _src_h, int _src_pitch, uint32_t* _dst, int _dst_pitch) -> void
+  {
+    auto dst_w = int(x_taps_.first.size());
+    auto dst_h = int(y_taps_.first.size());
+    if(dst_w == 0 || dst_h == 0 || _src_w == 0 || _src_h == 0)
+    {
+      return;
+    }
+    auto& k       = kernels();
+    auto  row     = std::size_t(dst_w) * 4;
+    auto  middle  = arena_.take<float>(row * std::size_t(_src_h));
+    // horizontal: each chunk of rows converts a source row to floats in its
+    // own buffer, then filters it into the intermediate
+    auto chunks   = row_chunks(_src_h);
+    auto grain    = (std::size_t(_src_h) + chunks - 1) / chunks;
+    // each line has room for a full width of taps past the end; it is
+    // zeroed so the zero weights there multiply zeros
+    auto line_len = (std::size_t(_src_w) + std::size_t(x_taps_.width)) * 4;
+    auto buffers  = arena_.take<float>(chunks * line_len);
+    for(std::size_t c = 0; c < chunks; ++c)
+    {
+      std::fill_n(buffers + c * line_len + std::size_t(_src_w) * 4, std::size_t(x_taps_.width) * 4, 0.0f);
+    }
+    pool_.parallel_for(0, std::size_t(_src_h), grain, [&](std::size_t _first, std::size_t _last)
+      {
+        auto line = buffers + (_first / grain) * line_len;
+        for(auto y = _first; y < _last; ++y)
+        {
+          auto src = reinterpret_cast<const uint32_t*>(reinterpret_cast<const unsigned char*>(_src) + y * std::size_t(_src_pitch));
+          k.to_float(src, line, std::size_t(_src_w));
+          k.horizontal(line, middle + y * row, std::size_t(dst_w), x_taps_.first.data(), x_taps_.count.data(), x_taps_.weights.data(), x_taps_.width);
+        }
+      });
+    // vertical: tiles of a strip of columns by a band of rows, each output
+    // row summed down its taps in registers
+    auto strips = (dst_w + strip_pixels - 1) / strip_pixels;
+    auto bands  = int(row_chunks(dst_h));
+    auto band_h = (dst_h + bands - 1) / bands;
+    pool_.parallel_for(0, std::size_t(strips) * std::size_t(bands), 1, [&](std::size_t _first, std::size_t _last)
+      {
+        for(auto t = _first; t < _last; ++t)
+        {
+          auto x0 = int(t % std::size_t(strips)) * strip_pixels;
+          auto n  = std::size_t(std::min(strip_pixels, dst_w - x0));
+          auto y0 = int(t / std::size_t(strips)) * band_h;
+          for(auto y = y0; y < std::min(y0 + band_h, dst_h); ++y)
+          {
+            auto i    = std::size_t(y);
+            auto rows = middle + std::size_t(y_taps_.first[i]) * row + 4 * std::size_t(x0);
+            auto dst  = reinterpret_cast<uint32_t*>(reinterpret_cast<unsigned char*>(_dst) + i * std::size_t(_dst_pitch));
+            k.vertical(rows, row, y_taps_.count[i], y_taps_.weights.data() + i * std::size_t(y_taps_.width), dst + x0, n);
+          }
+        }
+      });
+  }
+auto FilterPipeline::gaussian_blur(Surface& _s, float _sigma) -> void
+  {
+    KT_TRACE_ZONE("gaussian blur", "gfx");
+    if(!(_sigma > 0.0f) || _s.width() == 0 || _s.height() == 0)
+    {
+      return;
+    }
+    arena_.rewind();
+    auto gauss = [&](float _x) { return std::exp(-_x * _x / (2.0f * _sigma * _sigma)); };
+    build_taps(x_taps_, _s.width(), _s.width(), 3.0f * _sigma, gauss);
+    build_taps(y_taps_, _s.height(), _s.height(), 3.0f * _sigma, gauss);
+    convolve(_s.pixels(), _s.width(), _s.height(), _s.pitch(), _s.pixels(), _s.pitch());
+  }
+auto FilterPipeline::box_pass(uint32_t* _pixels, int _w, int _h, int _pitch, int _radius) -> void
+  {
+    auto& k     = kernels();
+    auto  line  = [&](uint32_t* _base, int _y) { return reinterpret_cast<uint32_t*>(reinterpret_cast<unsigned char*>(_base) + std::size_t(_y) * std::size_t(_pitch)); };
+    auto  temp  = arena_.take<uint32_t>(std::size_t(_pitch / 4) * std::size_t(_h));
+    auto  scale = 1.0f / float(2 * _radius + 1);
+    // horizontal into `temp`: a running sum per channel, edge pixels
+    // repeated, so one add and one subtract per pixel whatever the radius
+    auto chunks = row_chunks(_h);
+    auto grain  = (std::size_t(_h) + chunks - 1) / chunks;
+    pool_.parallel_for(0, std::size_t(_h), grain, [&](std::size_t _first, std::size_t _last)
+      {
+        for(auto y = int(_first); y < int(_last); ++y)
+        {
+          k.box_row(line(_pixels, y), line(temp, y), _w, _radius, scale);
+        }
+      });
+    // vertical back into `_pixels`: the same running sum, kept for a strip
+    // of columns at once so each row step is a vector add and subtract
+    auto strips = (_w + strip_pixels - 1) / strip_pixels;
+    pool_.parallel_for(0, std::size_t(strips), 1, [&](std::size_t _first, std::size_t _last)
+      {
+        alignas(ScratchArena::alignment) int32_t  sums[strip_pixels * 4];
+        alignas(ScratchArena::alignment) uint32_t none[strip_pixels] = {};
+        for(auto s = _first; s < _last; ++s)
+        {
+          auto x0 = int(s) * strip_pixels;
+          auto n  = std::size_t(std::min(strip_pixels, _w - x0));
+          std::fill(sums, sums + 4 * n, 0);
+          for(auto y = -_radius; y <= _radius; ++y)
+          {
+            k.box_accumulate(sums, line(temp, std::clamp(y, 0, _h - 1)) + x0, none, n);
+          }
+          for(int y = 0; y < _h; ++y)
+          {
+            k.box_store(sums, line(_pixels, y) + x0, scale, n);
+            k.box_accumulate(sums, line(temp, std::min(y + _radius + 1, _h - 1)) + x0, line(temp, std::max(y - _radius, 0)) + x0, n);
+          }
+        }
+      });
+  }
+auto FilterPipeline::box_blur(Surface& _s, int _radius, int _passes) -> void
+  {
+    KT_TRACE_ZONE("box blur", "gfx");
+    if(_radius <= 0 || _s.width() == 0 || _s.height() == 0)
+    {
+      return;
+    }
+    for(int i = 0; i < _passes; ++i)
+    {
+      arena_.rewind();
+      box_pass(_s.pixels(), _s.width(), _s.height(), _s.pitch(), _radius);
+    }
+  }
+auto FilterPipeline::threshold(Surface& _s, uint8_t _level) -> void
+  {
+    KT_TRACE_ZONE("threshold", "gfx");
+    auto chunks = row_chunks(_s.height());
+    auto grain  = (std::size_t(_s.height()) + chunks - 1) / chunks;
+    pool_.parallel_for(0, std::size_t(_s.height()), grain, [&](std::size_t _first, std::size_t _last)
+      {
+        for(auto y = int(_first); y < int(_last); ++y)
+        {
+          kernels().threshold(_s.row(y), _s.row(y), std::size_t(_s.width()), _level);
+        }
+      });
+  }
+auto FilterPipeline::bloom(Surface& _s, uint8_t _level, float _sigma, float _strength) -> void
+  {
+    KT_TRACE_ZONE("bloom", "gfx");
+    auto w = _s.width();
+    auto h = _s.height();
+    if(w == 0 || h == 0 || !(_strength > 0.0f))
+    {
+      return;
+    }
+    arena_.rewind();
+    auto& k       = kernels();
+    auto  count   = std::size_t(w) * std::size_t(h);
+    auto  bright  = arena_.take<uint32_t>(count);
+    auto  chunks  = row_chunks(h);
+    auto  grain   = (std::size_t(h) + chunks - 1) / chunks;
+    pool_.parallel_for(0, std::size_t(h), grain, [&](std::size_t _first, std::size_t _last)
+      {
+        for(auto y = _first; y < _last; ++y)
+        {
+          k.threshold(_s.row(int(y)), bright + y * std::size_t(w), std::size_t(w), _level);
+        }
+      });
+    // the glow is soft, so halve it, blur it and scale it back up
+    auto half_w = std::max(1, w / 2);
+    auto half_h = std::max(1, h / 2);
+    auto half   = arena_.take<uint32_t>(std::size_t(half_w) * std::size_t(half_h));
+    auto box    = [](float _x) { return _x > -0.5f && _x <= 0.5f? 1.0f : 0.0f; };
+    build_taps(x_taps_, w, half_w, 0.5f, box);
+    build_taps(y_taps_, h, half_h, 0.5f, box);
+    convolve(bright, w, h, w * 4, half, half_w * 4);
+    auto sigma  = std::max(_sigma / 2.0f, 0.5f);
+    auto gauss  = [&](float _x) { return std::exp(-_x * _x / (2.0f * sigma * sigma)); };
+    build_taps(x_taps_, half_w, half_w, 3.0f * sigma, gauss);
+    build_taps(y_taps_, half_h, half_h, 3.0f * sigma, gauss);
+    convolve(half, half_w, half_h, half_w * 4, half, half_w * 4);
+    auto tent   = [](float _x) { return std::max(0.0f, 1.0f - std::fabs(_x)); };
+    build_taps(x_taps_, half_w, w, 1.0f, tent);
+    build_taps(y_taps_, half_h, h, 1.0f, tent);
+    convolve(half, half_w, half_h, half_w * 4, bright, w * 4);
+    auto scale  = int(std::lround(std::min(_strength, 16.0f) * 256.0f));
+    pool_.parallel_for(0, std::size_t(h), grain, [&](std::size_t _first, std::size_t _last)
+      {
+        for(auto y = _first; y < _last; ++y)
+        {
+          k.add_scaled(_s.row(int(y)), bright + y * std::size_t(w), std::size_t(w), scale);
+        }
+      });
+  }
+auto FilterPipeline::resample(const Surface& _src, Surface& _dst, resample_filter _f) -> void
+  {
+    KT_TRACE_ZONE("resample", "gfx");
+    if(_src.width() == 0 || _src.height() == 0 || _dst.width() == 0 || _dst.height() == 0)
+    {
+      return;
+    }
+    arena_.rewind();
+    auto build = [&](auto&& _fn, float _support)
+      {
+        build_taps(x_taps_, _src.width(), _dst.width(), _support, _fn);
+        build_taps(y_taps_, _src.height(), _dst.height(), _support, _fn);
+      };
+    switch(_f)
+    {
+      case resample_filter::box:
+        build([](float _x) { return _x > -0.5f && _x <= 0.5f? 1.0f : 0.0f; }, 0.5f);
+        break;
+      case resample_filter::bilinear:
+        build([](float _x) { return std::max(0.0f, 1.0f - std::fabs(_x)); }, 1.0f);
+        break;
+      case resample_filter::lanczos:
+        build([](float _x) { return std::fabs(_x) < 3.0f? sinc(_x) * sinc(_x / 3.0f) : 0.0f; }, 3.0f);
+        break;
+    }
+    convolve(_src.pixels(), _src.width(), _src.height(), _src.pitch(), _dst.pixels(), _dst.pitch());
+  }
+auto FilterPipeline::scratch() const -> const ScratchArena&
+  {
+    return arena_;
+  }
+} /* namespace gfx */
+} /* namespace kt */
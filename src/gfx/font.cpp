@@ -0,0 +1,268 @@
+#include <kt/gfx/font.hpp>
+#include <kt/gfx/renderer.hpp>
+#include <kt/string/wrap.hpp>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+namespace kt {
+namespace gfx {
+namespace {
+auto check_size(int _size) -> void
+  {
+    if(_size <= 0)
+    {
+      throw std::runtime_error("font size must be positive");
+    }
+  }
+} /* namespace */
+Font::Font(Surface _sheet, const sheet_layout& _layout)
+    : sheet_(std::move(_sheet))
+    , layout_(_layout)
+  {
+    if(layout_.cell_w <= 0 || layout_.cell_h <= 0 || layout_.count <= 0)
+    {
+      throw std::runtime_error("font sheet cells must have a positive size");
+    }
+    auto columns = sheet_.width() / layout_.cell_w;
+    auto rows    = columns > 0? (layout_.count + columns - 1) / columns : 0;
+    if(columns == 0 || rows * layout_.cell_h > sheet_.height())
+    {
+      throw std::runtime_error("font sheet is too small for its layout");
+    }
+    auto coverage = [&](uint32_t _pixel)
+      {
+        auto c = Color::from_pixel(_pixel);
+        return layout_.luminance_alpha? std::max({ c.r(), c.g(), c.b() }) : c.a();
+      };
+    // bake coverage into white pixels once, so scaling only reads alpha
+    for(int y = 0; y < sheet_.height(); ++y)
+    {
+      auto row = sheet_.row(y);
+      for(int x = 0; x < sheet_.width(); ++x)
+      {
+        row[x] = Color { 0xFF, 0xFF, 0xFF, coverage(row[x]) }.pixel();
+      }
+    }
+    ink_.resize(std::size_t(layout_.count));
+    for(int i = 0; i < layout_.count; ++i)
+    {
+      auto cx = (i % columns) * layout_.cell_w;
+      auto cy = (i / columns) * layout_.cell_h;
+      auto left  = layout_.cell_w;
+      auto right = -1;
+      for(int y = cy; y < cy + layout_.cell_h; ++y)
+      {
+        auto row = sheet_.row(y);
+        for(int x = 0; x < layout_.cell_w; ++x)
+        {
+          if(Color::from_pixel(row[cx + x]).a() != 0)
+          {
+            left  = std::min(left, x);
+            right = std::max(right, x);
+          }
+        }
+      }
+      ink_[std::size_t(i)] = right < 0? ink { 0, 0 } : ink { left, right - left + 1 };
+    }
+  }
+auto Font::load_bmp(const std::string& _path, const sheet_layout& _layout) -> Font
+  {
+    return Font(Surface::load_bmp(_path), _layout);
+  }
+auto Font::advance(unsigned char _c, int _size) const -> int
+  {
+    auto index = int(_c) - int(layout_.first);
+    auto src   = layout_.cell_w / 2;
+    if(index >= 0 && index < layout_.count)
+    {
+      const auto& i = ink_[std::size_t(index)];
+      src = !layout_.proportional? layout_.cell_w : i.width == 0? layout_.cell_w / 2 : i.width + 1;
+    }
+    return std::max(1, int(std::lround(double(src) * _size / layout_.cell_h)));
+  }
+auto Font::glyph_for(unsigned char _c, int _size) -> const glyph&
+  {
+    auto key   = (uint64_t(_size) << 8) | _c;
+    auto found = glyphs_.find(key);
+    if(found != glyphs_.end())
+    {
+      return found->second;
+    }
+    auto index = int(_c) - int(layout_.first);
+    if(index < 0 || index >= layout_.count)
+    {
+      return glyphs_.emplace(key, glyph { 0, SDL_Rect {}, false }).first->second;
+    }
+    const auto& i = ink_[std::size_t(index)];
+    auto columns  = sheet_.width() / layout_.cell_w;
+    auto src_x    = (index % columns) * layout_.cell_w + (layout_.proportional? i.left : 0);
+    auto src_y    = (index / columns) * layout_.cell_h;
+    auto src_w    = layout_.proportional? i.width : layout_.cell_w;
+    if(src_w == 0)
+    {
+      return glyphs_.emplace(key, glyph { 0, SDL_Rect {}, false }).first->second;
+    }
+    // box filter by supersampling; enough samples that shrinking never
+    // skips source pixels
+    auto scale   = double(_size) / layout_.cell_h;
+    auto w       = std::max(1, int(std::lround(src_w * scale)));
+    auto h       = _size;
+    auto samples = std::max(1, int(std::ceil(1.0 / scale)));
+    Surface image(w, h);
+    for(int y = 0; y < h; ++y)
+    {
+      for(int x = 0; x < w; ++x)
+      {
+        unsigned total = 0;
+        for(int sy = 0; sy < samples; ++sy)
+        {
+          auto py = std::min(layout_.cell_h - 1, int((y + (sy + 0.5) / samples) / scale));
+          auto row = sheet_.row(src_y + py);
+          for(int sx = 0; sx < samples; ++sx)
+          {
+            auto px = std::min(src_w - 1, int((x + (sx + 0.5) / samples) / scale));
+            total += Color::from_pixel(row[src_x + px]).a();
+          }
+        }
+        image.row(y)[x] = Color { 0xFF, 0xFF, 0xFF, uint8_t(total / unsigned(samples * samples)) }.pixel();
+      }
+    }
+    auto placed_at = atlas_.add(image);
+    ++stats_.glyphs;
+    return glyphs_.emplace(key, glyph { placed_at.page, placed_at.rect, true }).first->second;
+  }
+auto Font::layout(std::string_view _text, int _size) -> const run&
+  {
+    // everything sized goes through here, so glyph_for and advance can
+    // rely on a positive size
+    check_size(_size);
+    key_.assign(_text);
+    key_.push_back('\0');
+    key_.append(reinterpret_cast<const char*>(&_size), sizeof(_size));
+    auto found = runs_.find(key_);
+    if(found != runs_.end())
+    {
+      ++stats_.run_hits;
+      return found->second;
+    }
+    ++stats_.run_misses;
+    if(runs_.size() >= run_cache_)
+    {
+      runs_.clear();
+    }
+    auto page = atlas_.page_size();
+    run result;
+    for(auto ch : _text)
+    {
+      auto c = static_cast<unsigned char>(ch);
+      const auto& g = glyph_for(c, _size);
+      if(g.visible)
+      {
+        result.glyphs.push_back(placed
+          { g.page
+          , SDL_FRect { float(result.width), 0.0f, float(g.rect.w), float(g.rect.h) }
+          , SDL_FRect { float(g.rect.x) / page.w, float(g.rect.y) / page.h, float(g.rect.w) / page.w, float(g.rect.h) / page.h }
+          });
+      }
+      result.width += advance(c, _size);
+    }
+    return runs_.emplace(key_, std::move(result)).first->second;
+  }
+auto Font::measure(std::string_view _text, int _size) -> int
+  {
+    return layout(_text, _size).width;
+  }
+auto Font::draw(std::string_view _text, float _x, float _y, int _size, Color _c) -> void
+  {
+    const auto& r = layout(_text, _size);
+    SDL_Color tint { _c.r(), _c.g(), _c.b(), _c.a() };
+    for(const auto& p : r.glyphs)
+    {
+      if(batches_.size() <= p.page)
+      {
+        batches_.resize(p.page + 1);
+      }
+      auto& b    = batches_[p.page];
+      auto base  = int(b.vertices.size());
+      auto x1    = _x + p.dest.x;
+      auto y1    = _y + p.dest.y;
+      auto x2    = x1 + p.dest.w;
+      auto y2    = y1 + p.dest.h;
+      auto u2    = p.uv.x + p.uv.w;
+      auto v2    = p.uv.y + p.uv.h;
+      b.vertices.push_back(SDL_Vertex { SDL_FPoint { x1, y1 }, tint, SDL_FPoint { p.uv.x, p.uv.y } });
+      b.vertices.push_back(SDL_Vertex { SDL_FPoint { x2, y1 }, tint, SDL_FPoint { u2,     p.uv.y } });
+      b.vertices.push_back(SDL_Vertex { SDL_FPoint { x2, y2 }, tint, SDL_FPoint { u2,     v2     } });
+      b.vertices.push_back(SDL_Vertex { SDL_FPoint { x1, y2 }, tint, SDL_FPoint { p.uv.x, v2     } });
+      for(auto i : { 0, 1, 2, 0, 2, 3 })
+      {
+        b.indices.push_back(base + i);
+      }
+    }
+  }
+auto Font::draw_paragraph(std::string_view _text, std::size_t _columns, float _x, float _y, int _size, Color _c) -> int
+  {
+    check_size(_size);
+    _columns = std::max<std::size_t>(_columns, 1);
+    auto y = _y;
+    while(true)
+    {
+      auto end  = _text.find('\n');
+      auto para = _text.substr(0, end);
+      if(para.empty())
+      {
+        y += float(_size);
+      }
+      for(auto line : word_wrap(para, _columns))
+      {
+        draw(line, _x, y, _size, _c);
+        y += float(_size);
+      }
+      if(end == std::string_view::npos)
+      {
+        break;
+      }
+      _text.remove_prefix(end + 1);
+    }
+    return int(y - _y);
+  }
+auto Font::flush(Renderer& _r) -> void
+  {
+    atlas_.upload(_r);
+    stats_.last_batches = 0;
+    for(std::size_t i = 0; i < batches_.size(); ++i)
+    {
+      auto& b = batches_[i];
+      if(b.indices.empty())
+      {
+        continue;
+      }
+      _r.geometry(&atlas_.page(i), b.vertices.data(), int(b.vertices.size()), b.indices.data(), int(b.indices.size()));
+      ++stats_.last_batches;
+    }
+    clear();
+  }
+auto Font::clear() -> void
+  {
+    for(auto& b : batches_)
+    {
+      b.vertices.clear();
+      b.indices.clear();
+    }
+  }
+auto Font::set_run_cache(std::size_t _runs) -> void
+  {
+    run_cache_ = std::max<std::size_t>(_runs, 1);
+    if(runs_.size() > run_cache_)
+    {
+      runs_.clear();
+    }
+  }
+auto Font::stats() const -> counters
+  {
+    auto result = stats_;
+    result.runs = runs_.size();
+    return result;
+  }
+} /* namespace gfx */
+} /* namespace kt */
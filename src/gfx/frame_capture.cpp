@@ -0,0 +1,267 @@
+#include <kt/gfx/frame_capture.hpp>
+#include <kt/trace.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+namespace kt {
+namespace gfx {
+namespace {
+auto crc_table() -> const std::array<uint32_t, 256>&
+  {
+    static const auto table = []
+      {
+        std::array<uint32_t, 256> t {};
+        for(uint32_t n = 0; n < 256; ++n)
+        {
+          auto c = n;
+          for(int k = 0; k < 8; ++k)
+          {
+            c = c & 1? 0xedb88320u ^ (c >> 1) : c >> 1;
+          }
+          t[n] = c;
+        }
+        return t;
+      }();
+    return table;
+  }
+auto crc32(uint32_t _crc, const uint8_t* _data, std::size_t _n) -> uint32_t
+  {
+    const auto& table = crc_table();
+    auto c = ~_crc;
+    for(std::size_t i = 0; i < _n; ++i)
+    {
+      c = table[(c ^ _data[i]) & 0xff] ^ (c >> 8);
+    }
+    return ~c;
+  }
+auto put_u32(std::vector<uint8_t>& _out, uint32_t _v) -> void
+  {
+    _out.push_back(uint8_t(_v >> 24));
+    _out.push_back(uint8_t(_v >> 16));
+    _out.push_back(uint8_t(_v >> 8));
+    _out.push_back(uint8_t(_v));
+  }
+// length, type, data, and a CRC over type and data
+auto put_chunk(std::vector<uint8_t>& _out, const char* _type, const uint8_t* _data, std::size_t _n) -> void
+  {
+    put_u32(_out, uint32_t(_n));
+    auto type_at = _out.size();
+    _out.insert(_out.end(), _type, _type + 4);
+    _out.insert(_out.end(), _data, _data + _n);
+    put_u32(_out, crc32(0, _out.data() + type_at, _n + 4));
+  }
+auto encode_png(const Surface& _s, std::vector<uint8_t>& _out) -> void
+  {
+    constexpr std::size_t max_block = 65535;
+    auto w         = std::size_t(_s.width());
+    auto h         = std::size_t(_s.height());
+    auto row_bytes = w * 4 + 1;   // filter type, then RGBA
+    auto raw_bytes = row_bytes * h;
+    auto blocks    = std::max<std::size_t>(1, (raw_bytes + max_block - 1) / max_block);
+
+    _out.clear();
+    _out.reserve(raw_bytes + blocks * 5 + 128);
+    static constexpr uint8_t signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+    _out.insert(_out.end(), std::begin(signature), std::end(signature));
+    std::vector<uint8_t> header;
+    put_u32(header, uint32_t(w));
+    put_u32(header, uint32_t(h));
+    header.insert(header.end(), { 8, 6, 0, 0, 0 });   // 8 bit RGBA, no interlace
+    put_chunk(_out, "IHDR", header.data(), header.size());
+
+    // IDAT is written in place: zlib header, stored blocks, Adler-32
+    auto length_at = _out.size();
+    put_u32(_out, 0);
+    auto type_at = _out.size();
+    _out.insert(_out.end(), { 'I', 'D', 'A', 'T', 0x78, 0x01 });
+    uint32_t a = 1;
+    uint32_t b = 0;
+    std::size_t block_left = 0;
+    std::size_t remaining  = raw_bytes;
+    auto emit = [&](const uint8_t* _data, std::size_t _n)
+      {
+        while(_n > 0)
+        {
+          if(block_left == 0)
+          {
+            block_left = std::min(max_block, remaining);
+            remaining -= block_left;
+            auto len = uint16_t(block_left);
+            _out.insert(_out.end(),
+              { uint8_t(remaining == 0? 1 : 0)
+              , uint8_t(len), uint8_t(len >> 8)
+              , uint8_t(~len), uint8_t(uint16_t(~len) >> 8)
+              });
+          }
+          auto n = std::min(_n, block_left);
+          _out.insert(_out.end(), _data, _data + n);
+          // Adler-32 sums stay below 2^32 for 5552 bytes between reductions
+          for(std::size_t i = 0; i < n; )
+          {
+            auto end = std::min(n, i + 5552);
+            for(; i < end; ++i)
+            {
+              a += _data[i];
+              b += a;
+            }
+            a %= 65521;
+            b %= 65521;
+          }
+          block_left -= n;
+          _data      += n;
+          _n         -= n;
+        }
+      };
+    const uint8_t filter_none = 0;
+    for(std::size_t y = 0; y < h; ++y)
+    {
+      emit(&filter_none, 1);
+      emit(reinterpret_cast<const uint8_t*>(_s.row(int(y))), w * 4);
+    }
+    if(raw_bytes == 0)
+    {
+      _out.insert(_out.end(), { 1, 0, 0, 0xff, 0xff });
+    }
+    put_u32(_out, (b << 16) | a);
+    auto idat_bytes = _out.size() - type_at - 4;
+    for(int i = 0; i < 4; ++i)
+    {
+      _out[length_at + std::size_t(i)] = uint8_t(idat_bytes >> (24 - 8 * i));
+    }
+    put_u32(_out, crc32(0, _out.data() + type_at, idat_bytes + 4));
+    put_chunk(_out, "IEND", nullptr, 0);
+  }
+auto open_for_write(const std::string& _filename) -> std::ofstream
+  {
+    std::ofstream out(_filename, std::ios::binary);
+    if(!out)
+    {
+      throw std::runtime_error("could not open \"" + _filename + "\" for writing");
+    }
+    return out;
+  }
+} /* namespace */
+
+FrameCapture::FrameCapture(View& _view)
+    : view_(_view)
+  {
+  }
+FrameCapture::~FrameCapture()
+  {
+    if(pipe_)
+    {
+      pclose(pipe_);
+    }
+  }
+auto FrameCapture::grab() -> const Surface&
+  {
+    KT_TRACE_ZONE("grab", "gfx");
+    view_.read_frame(frame_);
+    ++grabbed_;
+    return frame_;
+  }
+auto FrameCapture::frame() const -> const Surface&
+  {
+    return frame_;
+  }
+auto FrameCapture::frames_grabbed() const -> std::size_t
+  {
+    return grabbed_;
+  }
+auto FrameCapture::save_ppm(const std::string& _filename) -> void
+  {
+    auto out = open_for_write(_filename);
+    write_ppm(grab(), out);
+  }
+auto FrameCapture::save_png(const std::string& _filename) -> void
+  {
+    auto out = open_for_write(_filename);
+    grab();
+    encode_png(frame_, encoded_);
+    out.write(reinterpret_cast<const char*>(encoded_.data()), std::streamsize(encoded_.size()));
+  }
+auto FrameCapture::open_pipe(const std::string& _command) -> void
+  {
+    close_pipe();
+    pipe_ = popen(_command.c_str(), "w");
+    if(!pipe_)
+    {
+      throw std::runtime_error("could not start \"" + _command + "\"");
+    }
+  }
+auto FrameCapture::pipe_frame() -> void
+  {
+    if(!pipe_)
+    {
+      throw std::runtime_error("no capture pipe is open");
+    }
+    grab();
+    auto bytes = std::size_t(frame_.width()) * std::size_t(frame_.height()) * sizeof(uint32_t);
+    if(std::fwrite(frame_.pixels(), 1, bytes, pipe_) != bytes)
+    {
+      throw std::runtime_error("capture pipe closed");
+    }
+  }
+auto FrameCapture::close_pipe() -> void
+  {
+    if(pipe_)
+    {
+      auto status = pclose(pipe_);
+      pipe_ = nullptr;
+      if(status != 0)
+      {
+        throw std::runtime_error("capture command failed");
+      }
+    }
+  }
+auto FrameCapture::write_ppm(const Surface& _s, std::ostream& _out) -> void
+  {
+    _out << "P6\n" << _s.width() << ' ' << _s.height() << "\n255\n";
+    std::vector<char> rgb(std::size_t(_s.width()) * 3);
+    for(int y = 0; y < _s.height(); ++y)
+    {
+      auto src = reinterpret_cast<const uint8_t*>(_s.row(y));
+      for(std::size_t x = 0; x < std::size_t(_s.width()); ++x)
+      {
+        rgb[x * 3 + 0] = char(src[x * 4 + 0]);
+        rgb[x * 3 + 1] = char(src[x * 4 + 1]);
+        rgb[x * 3 + 2] = char(src[x * 4 + 2]);
+      }
+      _out.write(rgb.data(), std::streamsize(rgb.size()));
+    }
+  }
+auto FrameCapture::write_png(const Surface& _s, std::ostream& _out) -> void
+  {
+    std::vector<uint8_t> encoded;
+    encode_png(_s, encoded);
+    _out.write(reinterpret_cast<const char*>(encoded.data()), std::streamsize(encoded.size()));
+  }
+auto FrameCapture::diff(const Surface& _a, const Surface& _b, int _tolerance) -> std::size_t
+  {
+    if(_a.width() != _b.width() || _a.height() != _b.height())
+    {
+      return std::size_t(std::max(_a.width(), _b.width())) * std::size_t(std::max(_a.height(), _b.height()));
+    }
+    std::size_t result = 0;
+    for(int y = 0; y < _a.height(); ++y)
+    {
+      auto pa = reinterpret_cast<const uint8_t*>(_a.row(y));
+      auto pb = reinterpret_cast<const uint8_t*>(_b.row(y));
+      for(std::size_t x = 0; x < std::size_t(_a.width()); ++x)
+      {
+        for(std::size_t c = 0; c < 4; ++c)
+        {
+          if(std::abs(int(pa[x * 4 + c]) - int(pb[x * 4 + c])) > _tolerance)
+          {
+            ++result;
+            break;
+          }
+        }
+      }
+    }
+    return result;
+  }
+} /* namespace gfx */
+} /* namespace kt */
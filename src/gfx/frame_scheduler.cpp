@@ -0,0 +1,120 @@
+#include <kt/gfx/frame_scheduler.hpp>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+namespace kt {
+namespace gfx {
+FrameScheduler::FrameScheduler(double _update_rate, double _target_fps)
+    : last_frame_(clock::now())
+    , next_frame_(last_frame_)
+  {
+    set_update_rate(_update_rate);
+    set_target_fps(_target_fps);
+  }
+auto FrameScheduler::set_update_rate(double _hz) -> void
+  {
+    if(!(_hz > 0.0))
+    {
+      throw std::runtime_error("update rate must be positive");
+    }
+    step_ = 1.0 / _hz;
+  }
+auto FrameScheduler::set_target_fps(double _fps) -> void
+  {
+    frame_period_ = _fps > 0.0
+      ? std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / _fps))
+      : clock::duration::zero();
+    next_frame_ = clock::now();
+  }
+auto FrameScheduler::set_max_updates(int _n) -> void
+  {
+    max_updates_ = std::max(1, _n);
+  }
+auto FrameScheduler::begin_frame() -> int
+  {
+    auto now      = clock::now();
+    auto elapsed  = std::chrono::duration<double>(now - last_frame_).count();
+    last_frame_   = now;
+    intervals_[recorded_ % window] = elapsed;
+    ++recorded_;
+
+    accumulator_ += elapsed;
+    auto limit = max_updates_ * step_;
+    if(accumulator_ > limit)
+    {
+      dropped_     += accumulator_ - limit;
+      accumulator_  = limit;
+    }
+    auto updates = int(accumulator_ / step_);
+    accumulator_ -= updates * step_;
+    return updates;
+  }
+auto FrameScheduler::end_frame() -> void
+  {
+    if(frame_period_ == clock::duration::zero())
+    {
+      return;
+    }
+    next_frame_ += frame_period_;
+    auto now = clock::now();
+    if(next_frame_ <= now)
+    {
+      // running late; don't try to make the time up
+      next_frame_ = now;
+      return;
+    }
+    // the OS may oversleep by a scheduler tick, so sleep short and yield
+    // through the rest
+    constexpr auto slack = std::chrono::milliseconds(1);
+    if(next_frame_ - now > slack)
+    {
+      std::this_thread::sleep_until(next_frame_ - slack);
+    }
+    while(clock::now() < next_frame_)
+    {
+      std::this_thread::yield();
+    }
+  }
+auto FrameScheduler::resync() -> void
+  {
+    last_frame_ = clock::now();
+    next_frame_ = last_frame_;
+  }
+auto FrameScheduler::step() const -> double
+  {
+    return step_;
+  }
+auto FrameScheduler::alpha() const -> double
+  {
+    return accumulator_ / step_;
+  }
+auto FrameScheduler::dropped_time() const -> double
+  {
+    return dropped_;
+  }
+auto FrameScheduler::frame_timing() const -> timing
+  {
+    timing result;
+    result.frames = std::min(recorded_, window);
+    if(result.frames == 0)
+    {
+      return result;
+    }
+    for(std::size_t i = 0; i < result.frames; ++i)
+    {
+      result.mean += intervals_[i];
+      result.max   = std::max(result.max, intervals_[i]);
+    }
+    result.mean /= double(result.frames);
+    auto variance = 0.0;
+    for(std::size_t i = 0; i < result.frames; ++i)
+    {
+      auto d = intervals_[i] - result.mean;
+      variance += d * d;
+    }
+    result.jitter = std::sqrt(variance / double(result.frames));
+    return result;
+  }
+} /* namespace gfx */
+} /* namespace kt */
@@ -0,0 +1,109 @@
+#include <kt/gfx/frame_stats.hpp>
+#include <algorithm>
+#include <vector>
+namespace kt {
+namespace gfx {
+auto FrameStats::bin(double _t) -> std::size_t
+  {
+    return std::min(bins, std::size_t(std::max(0.0, _t) / bin_width));
+  }
+auto FrameStats::record(const sample& _s) -> void
+  {
+    auto& slot = frame_times_[recorded_ % window];
+    if(recorded_ >= window)
+    {
+      --histogram_[bin(slot)];
+    }
+    slot = _s.frame;
+    ++histogram_[bin(slot)];
+    ++recorded_;
+    last_ = _s;
+  }
+auto FrameStats::last() const -> const sample&
+  {
+    return last_;
+  }
+auto FrameStats::frames() const -> std::size_t
+  {
+    return std::min(recorded_, window);
+  }
+auto FrameStats::percentile(double _p) const -> double
+  {
+    auto n = frames();
+    if(n == 0)
+    {
+      return 0.0;
+    }
+    auto wanted = std::size_t(std::clamp(_p, 0.0, 1.0) * double(n - 1)) + 1;
+    std::size_t seen = 0;
+    for(std::size_t i = 0; i < bins; ++i)
+    {
+      seen += histogram_[i];
+      if(seen >= wanted)
+      {
+        return double(i + 1) * bin_width;
+      }
+    }
+    return max();
+  }
+auto FrameStats::p50() const -> double
+  {
+    return percentile(0.50);
+  }
+auto FrameStats::p99() const -> double
+  {
+    return percentile(0.99);
+  }
+auto FrameStats::max() const -> double
+  {
+    auto n = frames();
+    return n == 0? 0.0 : *std::max_element(frame_times_.begin(), frame_times_.begin() + n);
+  }
+auto FrameStats::draw(Renderer& _r, int _x, int _y, int _height) const -> void
+  {
+    constexpr double full_scale = 0.050;
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int>        indices;
+    vertices.reserve((window + 4) * 4);
+    indices.reserve((window + 4) * 6);
+    auto quad = [&](float _x1, float _y1, float _x2, float _y2, Color _c)
+      {
+        auto base = int(vertices.size());
+        SDL_Color c { _c.r(), _c.g(), _c.b(), _c.a() };
+        vertices.push_back(SDL_Vertex { SDL_FPoint { _x1, _y1 }, c, SDL_FPoint { 0, 0 } });
+        vertices.push_back(SDL_Vertex { SDL_FPoint { _x2, _y1 }, c, SDL_FPoint { 0, 0 } });
+        vertices.push_back(SDL_Vertex { SDL_FPoint { _x2, _y2 }, c, SDL_FPoint { 0, 0 } });
+        vertices.push_back(SDL_Vertex { SDL_FPoint { _x1, _y2 }, c, SDL_FPoint { 0, 0 } });
+        for(auto i : { 0, 1, 2, 0, 2, 3 })
+        {
+          indices.push_back(base + i);
+        }
+      };
+    auto bottom = float(_y + _height);
+    auto level = [&](double _t)
+      {
+        return bottom - float(std::min(1.0, _t / full_scale) * _height);
+      };
+    quad(float(_x), float(_y), float(_x + int(window)), bottom, Color { 0, 0, 0, 160 });
+    auto n      = frames();
+    auto oldest = recorded_ - n;
+    for(std::size_t i = 0; i < n; ++i)
+    {
+      auto t = frame_times_[(oldest + i) % window];
+      auto c = t <= 1.0 / 60.0? Color::green() : t <= 1.0 / 30.0? Color::yellow() : Color::red();
+      auto x = float(_x + int(window - n + i));
+      quad(x, level(t), x + 1.0f, bottom, c);
+    }
+    auto mark = [&](double _t, Color _c)
+      {
+        auto y = level(_t);
+        quad(float(_x), y, float(_x + int(window)), y + 1.0f, _c);
+      };
+    mark(1.0 / 60.0, Color::gray());
+    mark(p50(), Color::white());
+    mark(p99(), Color::magenta());
+    _r.set_draw_blend(SDL_BLENDMODE_BLEND);
+    _r.geometry(nullptr, vertices.data(), int(vertices.size()), indices.data(), int(indices.size()));
+  }
+} /* namespace gfx */
+} /* namespace kt */
@@ -0,0 +1,261 @@
+#include <kt/gfx/indexed_surface.hpp>
+#include <kt/gfx/streaming_texture.hpp>
+#include <kt/thread_pool.hpp>
+#include <kt/trace.hpp>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define KT_GFX_X86 1
+#endif
+namespace kt {
+namespace gfx {
+namespace {
+auto expand_scalar(const uint8_t* _src, uint32_t* _dst, std::size_t _n, const uint32_t* _lut) -> void
+  {
+    std::size_t i = 0;
+    for(; i + 4 <= _n; i += 4)
+    {
+      _dst[i]     = _lut[_src[i]];
+      _dst[i + 1] = _lut[_src[i + 1]];
+      _dst[i + 2] = _lut[_src[i + 2]];
+      _dst[i + 3] = _lut[_src[i + 3]];
+    }
+    for(; i < _n; ++i)
+    {
+      _dst[i] = _lut[_src[i]];
+    }
+  }
+#if defined(KT_GFX_X86)
+#define KT_AVX2 __attribute__((target("avx2")))
+KT_AVX2 auto expand_avx2(const uint8_t* _src, uint32_t* _dst, std::size_t _n, const uint32_t* _lut) -> void
+  {
+    auto table = reinterpret_cast<const int*>(_lut);
+    std::size_t i = 0;
+    for(; i + 16 <= _n; i += 16)
+    {
+      auto bytes  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_src + i));
+      auto lo     = _mm256_i32gather_epi32(table, _mm256_cvtepu8_epi32(bytes), 4);
+      auto hi     = _mm256_i32gather_epi32(table, _mm256_cvtepu8_epi32(_mm_srli_si128(bytes, 8)), 4);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(_dst + i), lo);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(_dst + i + 8), hi);
+    }
+    expand_scalar(_src + i, _dst + i, _n - i, _lut);
+  }
+#undef KT_AVX2
+#endif
+struct kernel_table
+{
+  void (*expand)(const uint8_t*, uint32_t*, std::size_t, const uint32_t*);
+};
+auto select_kernels() -> kernel_table
+  {
+#if defined(KT_GFX_X86)
+    if(__builtin_cpu_supports("avx2"))
+    {
+      return kernel_table { expand_avx2 };
+    }
+#endif
+    return kernel_table { expand_scalar };
+  }
+auto kernels() -> const kernel_table&
+  {
+    static const kernel_table table = select_kernels();
+    return table;
+  }
+// run `_fn(first_row, last_row)` over `[_y1, _y2)`, in parallel when the
+// area is big enough to pay for waking the pool
+template<typename FnT>
+auto for_rows(int _y1, int _y2, int _w, FnT&& _fn) -> void
+  {
+    constexpr std::size_t parallel_pixels = 1 << 16;
+    if(_y2 <= _y1 || _w <= 0)
+    {
+      return;
+    }
+    auto area = std::size_t(_y2 - _y1) * std::size_t(_w);
+    if(area < parallel_pixels)
+    {
+      _fn(_y1, _y2);
+      return;
+    }
+    auto grain = std::max<std::size_t>(1, (parallel_pixels / 4) / std::size_t(_w));
+    thread_pool::shared().parallel_for(_y1, _y2, grain, [&](std::size_t _a, std::size_t _b)
+      {
+        _fn(int(_a), int(_b));
+      });
+  }
+} /* namespace */
+IndexedSurface::IndexedSurface(int _w, int _h, uint8_t _index)
+  {
+    reset(_w, _h, _index);
+  }
+auto IndexedSurface::reset(int _w, int _h, uint8_t _index) -> void
+  {
+    if(_w < 0 || _h < 0)
+    {
+      throw std::runtime_error("IndexedSurface size must not be negative");
+    }
+    pixels_.assign(std::size_t(_w) * std::size_t(_h), _index);
+    width_  = _w;
+    height_ = _h;
+  }
+auto IndexedSurface::width() const -> int
+  {
+    return width_;
+  }
+auto IndexedSurface::height() const -> int
+  {
+    return height_;
+  }
+auto IndexedSurface::get_size() const -> Texture::size
+  {
+    return Texture::size { width_, height_ };
+  }
+auto IndexedSurface::pitch() const -> int
+  {
+    return width_;
+  }
+auto IndexedSurface::pixels() const -> const uint8_t*
+  {
+    return pixels_.data();
+  }
+auto IndexedSurface::pixels() -> uint8_t*
+  {
+    return pixels_.data();
+  }
+auto IndexedSurface::row(int _y) const -> const uint8_t*
+  {
+    return pixels_.data() + std::size_t(_y) * std::size_t(width_);
+  }
+auto IndexedSurface::row(int _y) -> uint8_t*
+  {
+    return pixels_.data() + std::size_t(_y) * std::size_t(width_);
+  }
+auto IndexedSurface::get(int _x, int _y) const -> uint8_t
+  {
+    return row(_y)[_x];
+  }
+auto IndexedSurface::set(int _x, int _y, uint8_t _index) -> void
+  {
+    if(_x >= 0 && _y >= 0 && _x < width_ && _y < height_)
+    {
+      row(_y)[_x] = _index;
+    }
+  }
+auto IndexedSurface::bounds() const -> SDL_Rect
+  {
+    return SDL_Rect { 0, 0, width_, height_ };
+  }
+auto IndexedSurface::area_or_bounds(const SDL_Rect* _area) const -> SDL_Rect
+  {
+    auto whole = bounds();
+    if(!_area)
+    {
+      return whole;
+    }
+    SDL_Rect result;
+    if(!SDL_IntersectRect(_area, &whole, &result))
+    {
+      return SDL_Rect { 0, 0, 0, 0 };
+    }
+    return result;
+  }
+auto IndexedSurface::fill_rect(const SDL_Rect& _r, uint8_t _index) -> void
+  {
+    auto area = area_or_bounds(&_r);
+    for(auto y = area.y; y < area.y + area.h; ++y)
+    {
+      std::memset(row(y) + area.x, _index, std::size_t(area.w));
+    }
+  }
+auto IndexedSurface::clear(uint8_t _index) -> void
+  {
+    std::fill(pixels_.begin(), pixels_.end(), _index);
+  }
+auto IndexedSurface::palette(uint8_t _index) const -> Color
+  {
+    return Color::from_pixel(palette_[_index]);
+  }
+auto IndexedSurface::set_palette(uint8_t _index, Color _c) -> void
+  {
+    palette_[_index] = _c.pixel();
+  }
+auto IndexedSurface::set_palette(std::span<const Color> _colors, uint8_t _first) -> void
+  {
+    auto n = std::min(_colors.size(), palette_size - _first);
+    for(std::size_t i = 0; i < n; ++i)
+    {
+      palette_[_first + i] = _colors[i].pixel();
+    }
+  }
+auto IndexedSurface::cycle(uint8_t _first, uint8_t _last, int _steps) -> void
+  {
+    if(_last <= _first)
+    {
+      return;
+    }
+    auto span_size  = int(_last) - int(_first) + 1;
+    auto shift      = ((_steps % span_size) + span_size) % span_size;
+    auto begin      = palette_.begin() + _first;
+    std::rotate(begin, begin + (span_size - shift), begin + span_size);
+  }
+auto IndexedSurface::expand(uint32_t* _out, int _pitch, const SDL_Rect* _area) const -> void
+  {
+    KT_TRACE_ZONE("expand palette", "gfx");
+    auto area = area_or_bounds(_area);
+    auto out  = reinterpret_cast<unsigned char*>(_out);
+    for_rows(area.y, area.y + area.h, area.w, [&](int _y1, int _y2)
+      {
+        for(auto y = _y1; y < _y2; ++y)
+        {
+          auto dst = reinterpret_cast<uint32_t*>(out + std::size_t(y - area.y) * std::size_t(_pitch));
+          kernels().expand(row(y) + area.x, dst, std::size_t(area.w), palette_.data());
+        }
+      });
+  }
+auto IndexedSurface::expand(Surface& _into) const -> void
+  {
+    if(_into.width() != width_ || _into.height() != height_)
+    {
+      _into.reset(width_, height_);
+    }
+    expand(_into.pixels(), _into.pitch());
+  }
+auto IndexedSurface::upload(Texture& _t, const SDL_Rect* _area) const -> void
+  {
+    constexpr std::size_t band_pixels = 1 << 14;
+    auto area = area_or_bounds(_area);
+    if(area.w <= 0 || area.h <= 0)
+    {
+      return;
+    }
+    // a band at a time keeps the expanded copy small and in cache
+    auto band_rows  = int(std::max<std::size_t>(1, band_pixels / std::size_t(area.w)));
+    auto scratch    = std::vector<uint32_t>(std::size_t(area.w) * std::size_t(std::min(band_rows, area.h)));
+    auto pitch      = area.w * int(sizeof(uint32_t));
+    for(auto y = area.y; y < area.y + area.h; y += band_rows)
+    {
+      auto band = SDL_Rect { area.x, y, area.w, std::min(band_rows, area.y + area.h - y) };
+      expand(scratch.data(), pitch, &band);
+      _t.update(scratch.data(), pitch, &band);
+    }
+  }
+auto IndexedSurface::upload(StreamingTexture& _t, const SDL_Rect* _area) const -> void
+  {
+    auto l = _t.lock(_area);
+    if(l.pixels)
+    {
+      expand(l.pixels, l.pitch, &l.area);
+    }
+    _t.unlock();
+  }
+auto IndexedSurface::make_texture(Renderer& _r) const -> Texture
+  {
+    Texture result(_r, width_, height_);
+    upload(result);
+    return result;
+  }
+} /* namespace gfx */
+} /* namespace kt */
@@ -0,0 +1,280 @@
+#include <kt/gfx/input_record.hpp>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <thread>
+namespace kt {
+namespace gfx {
+namespace {
+constexpr char    magic[4] = { 'K', 'T', 'I', 'N' };
+constexpr uint8_t version  = 1;
+
+enum record : uint8_t
+{
+  end_of_frame  = 0
+, key           = 1
+, window        = 2
+, axis          = 3
+, button        = 4
+};
+
+auto put(std::vector<uint8_t>& _out, uint64_t _v) -> void
+  {
+    while(_v >= 0x80)
+    {
+      _out.push_back(uint8_t(_v | 0x80));
+      _v >>= 7;
+    }
+    _out.push_back(uint8_t(_v));
+  }
+auto put_signed(std::vector<uint8_t>& _out, int64_t _v) -> void
+  {
+    put(_out, (uint64_t(_v) << 1) ^ uint64_t(_v >> 63));
+  }
+
+class reader
+{
+public:
+  reader(const std::vector<uint8_t>& _data, std::size_t& _position)
+      : data_(_data)
+      , position_(_position)
+    {
+    }
+  auto byte() -> uint8_t
+    {
+      if(position_ >= data_.size())
+      {
+        throw std::runtime_error("input recording is truncated");
+      }
+      return data_[position_++];
+    }
+  auto get() -> uint64_t
+    {
+      uint64_t result = 0;
+      for(int shift = 0; shift < 64; shift += 7)
+      {
+        auto b = byte();
+        result |= uint64_t(b & 0x7f) << shift;
+        if(!(b & 0x80))
+        {
+          return result;
+        }
+      }
+      throw std::runtime_error("input recording is corrupt");
+    }
+  auto get_signed() -> int64_t
+    {
+      auto v = get();
+      return int64_t(v >> 1) ^ -int64_t(v & 1);
+    }
+private:
+  const std::vector<uint8_t>& data_;
+  std::size_t&                position_;
+};
+} /* namespace */
+
+InputRecorder::InputRecorder(const std::string& _filename)
+    : out_(_filename, std::ios::binary)
+    , last_frame_(clock::now())
+  {
+    if(!out_)
+    {
+      throw std::runtime_error("could not open \"" + _filename + "\" for recording");
+    }
+    out_.write(magic, sizeof(magic));
+    out_.put(char(version));
+  }
+InputRecorder::~InputRecorder()
+  {
+    close();
+  }
+auto InputRecorder::records(const SDL_Event& _event) -> bool
+  {
+    switch(_event.type)
+    {
+    case SDL_WINDOWEVENT:
+    case SDL_CONTROLLERAXISMOTION:
+    case SDL_CONTROLLERBUTTONDOWN:
+    case SDL_CONTROLLERBUTTONUP:
+    case SDL_KEYDOWN:
+    case SDL_KEYUP:
+      return true;
+    }
+    return false;
+  }
+auto InputRecorder::event(const SDL_Event& _event) -> void
+  {
+    if(!records(_event))
+    {
+      return;
+    }
+    if(_event.type == SDL_CONTROLLERAXISMOTION)
+    {
+      for(auto& e : pending_)
+      {
+        if(e.type == SDL_CONTROLLERAXISMOTION && e.caxis.which == _event.caxis.which && e.caxis.axis == _event.caxis.axis)
+        {
+          e.caxis.value = _event.caxis.value;
+          return;
+        }
+      }
+    }
+    pending_.push_back(_event);
+  }
+auto InputRecorder::end_frame(int _updates) -> void
+  {
+    if(!out_.is_open())
+    {
+      return;
+    }
+    buffer_.clear();
+    for(const auto& e : pending_)
+    {
+      switch(e.type)
+      {
+      case SDL_KEYDOWN:
+      case SDL_KEYUP:
+        buffer_.push_back(key);
+        buffer_.push_back(uint8_t((e.type == SDL_KEYDOWN? 1 : 0) | (e.key.repeat? 2 : 0)));
+        put(buffer_, e.key.windowID);
+        put(buffer_, uint32_t(e.key.keysym.scancode));
+        put_signed(buffer_, e.key.keysym.sym);
+        put(buffer_, e.key.keysym.mod);
+        break;
+      case SDL_WINDOWEVENT:
+        buffer_.push_back(window);
+        buffer_.push_back(e.window.event);
+        put(buffer_, e.window.windowID);
+        put_signed(buffer_, e.window.data1);
+        put_signed(buffer_, e.window.data2);
+        break;
+      case SDL_CONTROLLERAXISMOTION:
+        buffer_.push_back(axis);
+        put_signed(buffer_, e.caxis.which);
+        buffer_.push_back(e.caxis.axis);
+        put_signed(buffer_, e.caxis.value);
+        break;
+      case SDL_CONTROLLERBUTTONDOWN:
+      case SDL_CONTROLLERBUTTONUP:
+        buffer_.push_back(button);
+        buffer_.push_back(uint8_t(e.type == SDL_CONTROLLERBUTTONDOWN? 1 : 0));
+        put_signed(buffer_, e.cbutton.which);
+        buffer_.push_back(e.cbutton.button);
+        break;
+      }
+    }
+    auto now = clock::now();
+    buffer_.push_back(end_of_frame);
+    put(buffer_, uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(now - last_frame_).count()));
+    put(buffer_, uint64_t(std::max(_updates, 0)));
+    out_.write(reinterpret_cast<const char*>(buffer_.data()), std::streamsize(buffer_.size()));
+    last_frame_ = now;
+    pending_.clear();
+    ++frames_;
+  }
+auto InputRecorder::close() -> void
+  {
+    if(out_.is_open())
+    {
+      out_.close();
+    }
+  }
+auto InputRecorder::frames() const -> std::size_t
+  {
+    return frames_;
+  }
+
+InputReplay::InputReplay(const std::string& _filename, pace _pace)
+    : pace_(_pace)
+  {
+    std::ifstream in(_filename, std::ios::binary);
+    if(!in)
+    {
+      throw std::runtime_error("could not open input recording \"" + _filename + "\"");
+    }
+    data_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    if(data_.size() < sizeof(magic) + 1 || !std::equal(std::begin(magic), std::end(magic), data_.begin()))
+    {
+      throw std::runtime_error("\"" + _filename + "\" is not an input recording");
+    }
+    if(data_[sizeof(magic)] != version)
+    {
+      throw std::runtime_error("\"" + _filename + "\" has an unsupported input recording version");
+    }
+    position_ = sizeof(magic) + 1;
+  }
+auto InputReplay::next(frame& _f) -> bool
+  {
+    if(position_ >= data_.size())
+    {
+      return false;
+    }
+    if(frames_ == 0)
+    {
+      start_ = clock::now();
+    }
+    _f.events.clear();
+    reader in(data_, position_);
+    while(true)
+    {
+      SDL_Event e {};
+      auto kind = in.byte();
+      switch(kind)
+      {
+      case end_of_frame:
+        _f.duration_us = in.get();
+        _f.updates     = int(in.get());
+        elapsed_us_   += _f.duration_us;
+        ++frames_;
+        if(pace_ == pace::recorded)
+        {
+          std::this_thread::sleep_until(start_ + std::chrono::microseconds(elapsed_us_));
+        }
+        return true;
+      case key:
+        {
+          auto state = in.byte();
+          e.type                = state & 1? SDL_KEYDOWN : SDL_KEYUP;
+          e.key.state           = state & 1? SDL_PRESSED : SDL_RELEASED;
+          e.key.repeat          = state & 2? 1 : 0;
+          e.key.windowID        = uint32_t(in.get());
+          e.key.keysym.scancode = SDL_Scancode(in.get());
+          e.key.keysym.sym      = SDL_Keycode(in.get_signed());
+          e.key.keysym.mod      = uint16_t(in.get());
+        }
+        break;
+      case window:
+        e.type            = SDL_WINDOWEVENT;
+        e.window.event    = in.byte();
+        e.window.windowID = uint32_t(in.get());
+        e.window.data1    = int32_t(in.get_signed());
+        e.window.data2    = int32_t(in.get_signed());
+        break;
+      case axis:
+        e.type          = SDL_CONTROLLERAXISMOTION;
+        e.caxis.which   = SDL_JoystickID(in.get_signed());
+        e.caxis.axis    = in.byte();
+        e.caxis.value   = int16_t(in.get_signed());
+        break;
+      case button:
+        {
+          auto down = in.byte();
+          e.type            = down? SDL_CONTROLLERBUTTONDOWN : SDL_CONTROLLERBUTTONUP;
+          e.cbutton.state   = down? SDL_PRESSED : SDL_RELEASED;
+          e.cbutton.which   = SDL_JoystickID(in.get_signed());
+          e.cbutton.button  = in.byte();
+        }
+        break;
+      default:
+        throw std::runtime_error("input recording is corrupt");
+      }
+      e.common.timestamp = uint32_t(elapsed_us_ / 1000);
+      _f.events.push_back(e);
+    }
+  }
+auto InputReplay::frames() const -> std::size_t
+  {
+    return frames_;
+  }
+} /* namespace gfx */
+} /* namespace kt */
@@ -0,0 +1,37 @@
+#include <kt/gfx/layer.hpp>
+namespace kt {
+namespace gfx {
+Layer::Layer(render_fn _fn)
+    : render_(std::move(_fn))
+  {
+  }
+auto Layer::invalidate() -> void
+  {
+    whole_ = true;
+    damage_.clear();
+  }
+auto Layer::invalidate(const SDL_Rect& _area) -> void
+  {
+    if(!whole_ && _area.w > 0 && _area.h > 0)
+    {
+      damage_.push_back(_area);
+    }
+  }
+auto Layer::set_visible(bool _visible) -> void
+  {
+    if(_visible != visible_)
+    {
+      visible_            = _visible;
+      visibility_changed_ = true;
+    }
+  }
+auto Layer::visible() const -> bool
+  {
+    return visible_;
+  }
+auto Layer::is_dirty() const -> bool
+  {
+    return whole_ || !damage_.empty() || visibility_changed_;
+  }
+} /* namespace gfx */
+} /* namespace kt */
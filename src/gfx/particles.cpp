@@ -0,0 +1,314 @@
+#include <kt/gfx/particles.hpp>
+#include <kt/gfx/renderer.hpp>
+#include <kt/trace.hpp>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define KT_GFX_X86 1
+#endif
+namespace kt {
+namespace gfx {
+namespace {
+constexpr std::size_t column_align = 64;
+
+auto integrate_scalar(float* _x, float* _y, float* _vx, float* _vy, float* _life, std::size_t _n, float _dt, float _damping, float _gx, float _gy) -> void
+  {
+    for(std::size_t i = 0; i < _n; ++i)
+    {
+      _vx[i]    = _vx[i] * _damping + _gx;
+      _vy[i]    = _vy[i] * _damping + _gy;
+      _x[i]    += _vx[i] * _dt;
+      _y[i]    += _vy[i] * _dt;
+      _life[i] -= _dt;
+    }
+  }
+#if defined(KT_GFX_X86) && defined(__SSE2__)
+auto integrate_sse2(float* _x, float* _y, float* _vx, float* _vy, float* _life, std::size_t _n, float _dt, float _damping, float _gx, float _gy) -> void
+  {
+    auto dt   = _mm_set1_ps(_dt);
+    auto damp = _mm_set1_ps(_damping);
+    auto gx   = _mm_set1_ps(_gx);
+    auto gy   = _mm_set1_ps(_gy);
+    std::size_t i = 0;
+    for(; i + 4 <= _n; i += 4)
+    {
+      auto vx = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(_vx + i), damp), gx);
+      auto vy = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(_vy + i), damp), gy);
+      _mm_storeu_ps(_vx + i, vx);
+      _mm_storeu_ps(_vy + i, vy);
+      _mm_storeu_ps(_x + i, _mm_add_ps(_mm_loadu_ps(_x + i), _mm_mul_ps(vx, dt)));
+      _mm_storeu_ps(_y + i, _mm_add_ps(_mm_loadu_ps(_y + i), _mm_mul_ps(vy, dt)));
+      _mm_storeu_ps(_life + i, _mm_sub_ps(_mm_loadu_ps(_life + i), dt));
+    }
+    integrate_scalar(_x + i, _y + i, _vx + i, _vy + i, _life + i, _n - i, _dt, _damping, _gx, _gy);
+  }
+#endif
+#if defined(KT_GFX_X86)
+#define KT_AVX2 __attribute__((target("avx2")))
+KT_AVX2 auto integrate_avx2(float* _x, float* _y, float* _vx, float* _vy, float* _life, std::size_t _n, float _dt, float _damping, float _gx, float _gy) -> void
+  {
+    auto dt   = _mm256_set1_ps(_dt);
+    auto damp = _mm256_set1_ps(_damping);
+    auto gx   = _mm256_set1_ps(_gx);
+    auto gy   = _mm256_set1_ps(_gy);
+    std::size_t i = 0;
+    for(; i + 8 <= _n; i += 8)
+    {
+      auto vx = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(_vx + i), damp), gx);
+      auto vy = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(_vy + i), damp), gy);
+      _mm256_storeu_ps(_vx + i, vx);
+      _mm256_storeu_ps(_vy + i, vy);
+      _mm256_storeu_ps(_x + i, _mm256_add_ps(_mm256_loadu_ps(_x + i), _mm256_mul_ps(vx, dt)));
+      _mm256_storeu_ps(_y + i, _mm256_add_ps(_mm256_loadu_ps(_y + i), _mm256_mul_ps(vy, dt)));
+      _mm256_storeu_ps(_life + i, _mm256_sub_ps(_mm256_loadu_ps(_life + i), dt));
+    }
+    integrate_scalar(_x + i, _y + i, _vx + i, _vy + i, _life + i, _n - i, _dt, _damping, _gx, _gy);
+  }
+#undef KT_AVX2
+#endif
+struct kernel_table
+{
+  void (*integrate)(float*, float*, float*, float*, float*, std::size_t, float, float, float, float);
+};
+auto select_kernels() -> kernel_table
+  {
+#if defined(KT_GFX_X86)
+    if(__builtin_cpu_supports("avx2"))
+    {
+      return kernel_table { integrate_avx2 };
+    }
+#endif
+#if defined(KT_GFX_X86) && defined(__SSE2__)
+    return kernel_table { integrate_sse2 };
+#else
+    return kernel_table { integrate_scalar };
+#endif
+  }
+auto kernels() -> const kernel_table&
+  {
+    static const kernel_table table = select_kernels();
+    return table;
+  }
+} /* namespace */
+ParticleSystem::ParticleSystem(std::size_t _capacity, thread_pool& _pool)
+    : pool_(_pool)
+    , capacity_(_capacity)
+  {
+    if(_capacity > std::size_t(INT_MAX / 6))
+    {
+      throw std::runtime_error("particle capacity too large for one geometry call");
+    }
+    // one allocation, each column starting on a cache line
+    auto stride = (std::max<std::size_t>(_capacity, 1) + 15) & ~std::size_t(15);
+    auto block  = static_cast<float*>(std::aligned_alloc(column_align, 6 * stride * sizeof(float)));
+    if(!block)
+    {
+      throw std::bad_alloc();
+    }
+    storage_.reset(block);
+    x_      = block;
+    y_      = block + stride;
+    vx_     = block + 2 * stride;
+    vy_     = block + 3 * stride;
+    life_   = block + 4 * stride;
+    color_  = reinterpret_cast<uint32_t*>(block + 5 * stride);
+  }
+auto ParticleSystem::emit(const particle& _p) -> bool
+  {
+    if(size_ == capacity_)
+    {
+      ++stats_.dropped;
+      return false;
+    }
+    x_[size_]     = _p.x;
+    y_[size_]     = _p.y;
+    vx_[size_]    = _p.vx;
+    vy_[size_]    = _p.vy;
+    life_[size_]  = _p.life;
+    color_[size_] = _p.color.pixel();
+    ++size_;
+    ++stats_.emitted;
+    return true;
+  }
+auto ParticleSystem::emit(std::span<const particle> _ps) -> std::size_t
+  {
+    auto n = std::min(_ps.size(), capacity_ - size_);
+    for(std::size_t i = 0; i < n; ++i)
+    {
+      emit(_ps[i]);
+    }
+    stats_.dropped += _ps.size() - n;
+    return n;
+  }
+auto ParticleSystem::clear() -> void
+  {
+    size_ = 0;
+  }
+auto ParticleSystem::set_gravity(float _x, float _y) -> void
+  {
+    gravity_x_ = _x;
+    gravity_y_ = _y;
+  }
+auto ParticleSystem::set_drag(float _drag) -> void
+  {
+    drag_ = std::max(0.0f, _drag);
+  }
+auto ParticleSystem::set_fade(float _seconds) -> void
+  {
+    fade_ = std::max(0.0f, _seconds);
+  }
+auto ParticleSystem::set_size(float _w, float _h) -> void
+  {
+    half_w_ = _w / 2;
+    half_h_ = _h / 2;
+  }
+auto ParticleSystem::set_texture(const Texture* _t, const SDL_Rect* _src) -> void
+  {
+    texture_  = _t;
+    uv_       = SDL_FRect { 0.0f, 0.0f, 1.0f, 1.0f };
+    if(_t && _src)
+    {
+      auto sz = _t->get_size();
+      if(sz.w > 0 && sz.h > 0)
+      {
+        uv_ = SDL_FRect { float(_src->x) / sz.w, float(_src->y) / sz.h, float(_src->w) / sz.w, float(_src->h) / sz.h };
+      }
+    }
+  }
+auto ParticleSystem::set_parallel(bool _parallel) -> void
+  {
+    parallel_ = _parallel;
+  }
+auto ParticleSystem::chunks() const -> std::size_t
+  {
+    return (size_ + grain - 1) / grain;
+  }
+auto ParticleSystem::for_chunks(std::size_t _count, const std::function<void(std::size_t, std::size_t)>& _fn) -> void
+  {
+    if(parallel_ && _count > 1)
+    {
+      pool_.parallel_for(0, _count, 1, _fn);
+    }
+    else if(_count > 0)
+    {
+      _fn(0, _count);
+    }
+  }
+auto ParticleSystem::step(std::size_t _begin, std::size_t _end, const motion& _m) -> std::size_t
+  {
+    kernels().integrate(x_ + _begin, y_ + _begin, vx_ + _begin, vy_ + _begin, life_ + _begin, _end - _begin, _m.dt, _m.damping, _m.gx, _m.gy);
+    // every particle is copied to the write cursor, which only advances past
+    // the live ones; the cursor never passes the read position
+    auto w = _begin;
+    for(auto i = _begin; i < _end; ++i)
+    {
+      x_[w]     = x_[i];
+      y_[w]     = y_[i];
+      vx_[w]    = vx_[i];
+      vy_[w]    = vy_[i];
+      life_[w]  = life_[i];
+      color_[w] = color_[i];
+      w += std::size_t(life_[i] > 0.0f);
+    }
+    return w - _begin;
+  }
+auto ParticleSystem::move(std::size_t _from, std::size_t _to, std::size_t _n) -> void
+  {
+    auto bytes = _n * sizeof(float);
+    std::memmove(x_ + _to, x_ + _from, bytes);
+    std::memmove(y_ + _to, y_ + _from, bytes);
+    std::memmove(vx_ + _to, vx_ + _from, bytes);
+    std::memmove(vy_ + _to, vy_ + _from, bytes);
+    std::memmove(life_ + _to, life_ + _from, bytes);
+    std::memmove(color_ + _to, color_ + _from, _n * sizeof(uint32_t));
+  }
+auto ParticleSystem::update(float _dt) -> void
+  {
+    KT_TRACE_ZONE("particles update", "gfx");
+    motion m { _dt, std::max(0.0f, 1.0f - drag_ * _dt), gravity_x_ * _dt, gravity_y_ * _dt };
+    auto count = chunks();
+    kept_.resize(count);
+    for_chunks(count, [&](std::size_t _first, std::size_t _last)
+      {
+        for(auto c = _first; c < _last; ++c)
+        {
+          auto b    = c * grain;
+          kept_[c]  = step(b, std::min(b + grain, size_), m);
+        }
+      });
+    // close the gaps each chunk left behind
+    std::size_t alive = 0;
+    for(std::size_t c = 0; c < count; ++c)
+    {
+      if(alive != c * grain && kept_[c] > 0)
+      {
+        move(c * grain, alive, kept_[c]);
+      }
+      alive += kept_[c];
+    }
+    stats_.expired += size_ - alive;
+    size_ = alive;
+  }
+auto ParticleSystem::draw(Renderer& _r, float _x, float _y) -> void
+  {
+    KT_TRACE_ZONE("particles draw", "gfx");
+    if(size_ == 0)
+    {
+      return;
+    }
+    vertices_.resize(4 * size_);
+    // the index pattern only depends on the slot, so it is built once
+    for(auto i = indices_.size() / 6; i < size_; ++i)
+    {
+      auto base = int(4 * i);
+      for(auto k : { 0, 1, 2, 0, 2, 3 })
+      {
+        indices_.push_back(base + k);
+      }
+    }
+    // alpha follows the life left over the fade time, clamped to [0, 1];
+    // with no fade the bias holds it at 1
+    auto fade_rate  = fade_ > 0.0f? 1.0f / fade_ : 0.0f;
+    auto fade_bias  = fade_ > 0.0f? 0.0f : 1.0f;
+    auto u1 = uv_.x;
+    auto v1 = uv_.y;
+    auto u2 = uv_.x + uv_.w;
+    auto v2 = uv_.y + uv_.h;
+    for_chunks(chunks(), [&](std::size_t _first, std::size_t _last)
+      {
+        auto end = std::min(_last * grain, size_);
+        for(auto i = _first * grain; i < end; ++i)
+        {
+          auto c      = Color::from_pixel(color_[i]);
+          auto alpha  = std::clamp(life_[i] * fade_rate + fade_bias, 0.0f, 1.0f);
+          SDL_Color tint { c.r(), c.g(), c.b(), uint8_t(float(c.a()) * alpha + 0.5f) };
+          auto x  = x_[i] + _x;
+          auto y  = y_[i] + _y;
+          auto v  = vertices_.data() + 4 * i;
+          v[0] = SDL_Vertex { SDL_FPoint { x - half_w_, y - half_h_ }, tint, SDL_FPoint { u1, v1 } };
+          v[1] = SDL_Vertex { SDL_FPoint { x + half_w_, y - half_h_ }, tint, SDL_FPoint { u2, v1 } };
+          v[2] = SDL_Vertex { SDL_FPoint { x + half_w_, y + half_h_ }, tint, SDL_FPoint { u2, v2 } };
+          v[3] = SDL_Vertex { SDL_FPoint { x - half_w_, y + half_h_ }, tint, SDL_FPoint { u1, v2 } };
+        }
+      });
+    _r.geometry(texture_, vertices_.data(), int(vertices_.size()), indices_.data(), int(6 * size_));
+  }
+auto ParticleSystem::size() const -> std::size_t
+  {
+    return size_;
+  }
+auto ParticleSystem::capacity() const -> std::size_t
+  {
+    return capacity_;
+  }
+auto ParticleSystem::stats() const -> counters
+  {
+    auto result  = stats_;
+    result.alive = size_;
+    return result;
+  }
+} /* namespace gfx */
+} /* namespace kt */
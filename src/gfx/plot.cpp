@@ -0,0 +1,180 @@
+#include <kt/gfx/plot.hpp>
+#include <kt/gfx/renderer.hpp>
+#include <kt/trace.hpp>
+#include <algorithm>
+#include <limits>
+namespace kt {
+namespace gfx {
+Plot::Plot(std::span<const float> _samples)
+  {
+    assign(_samples);
+  }
+auto Plot::assign(std::span<const float> _samples) -> void
+  {
+    samples_.assign(_samples.begin(), _samples.end());
+    levels_.clear();
+    rebuild_from(0);
+  }
+auto Plot::append(std::span<const float> _samples) -> void
+  {
+    auto first = samples_.size();
+    samples_.insert(samples_.end(), _samples.begin(), _samples.end());
+    rebuild_from(first);
+  }
+auto Plot::clear() -> void
+  {
+    samples_.clear();
+    levels_.clear();
+  }
+auto Plot::size() const -> std::size_t
+  {
+    return samples_.size();
+  }
+auto Plot::samples() const -> const std::vector<float>&
+  {
+    return samples_;
+  }
+// level 0 is the samples themselves; level k + 1 is levels_[k]
+auto Plot::entries(std::size_t _level) const -> std::size_t
+  {
+    return _level == 0? samples_.size() : levels_[_level - 1].lo.size();
+  }
+auto Plot::low(std::size_t _level, std::size_t _i) const -> float
+  {
+    return _level == 0? samples_[_i] : levels_[_level - 1].lo[_i];
+  }
+auto Plot::high(std::size_t _level, std::size_t _i) const -> float
+  {
+    return _level == 0? samples_[_i] : levels_[_level - 1].hi[_i];
+  }
+auto Plot::rebuild_from(std::size_t _first_sample) -> void
+  {
+    // on each level redo the block the first new entry fell in and any
+    // after it; everything before is unchanged
+    auto first = _first_sample;
+    for(std::size_t k = 1; entries(k - 1) > 1; ++k)
+    {
+      if(levels_.size() < k)
+      {
+        levels_.emplace_back();
+        first = 0;
+      }
+      auto below = entries(k - 1);
+      auto count = (below + fanout - 1) / fanout;
+      first /= fanout;
+      auto& l = levels_[k - 1];
+      l.lo.resize(count);
+      l.hi.resize(count);
+      for(auto i = first; i < count; ++i)
+      {
+        auto b  = i * fanout;
+        auto e  = std::min(b + fanout, below);
+        auto lo = low(k - 1, b);
+        auto hi = high(k - 1, b);
+        for(auto j = b + 1; j < e; ++j)
+        {
+          lo = std::min(lo, low(k - 1, j));
+          hi = std::max(hi, high(k - 1, j));
+        }
+        l.lo[i] = lo;
+        l.hi[i] = hi;
+      }
+    }
+  }
+auto Plot::envelope(std::size_t _first, std::size_t _last) const -> range
+  {
+    _last = std::min(_last, samples_.size());
+    range result { std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity() };
+    auto take = [&](std::size_t _k, std::size_t _i)
+      {
+        result.lo = std::min(result.lo, low(_k, _i));
+        result.hi = std::max(result.hi, high(_k, _i));
+      };
+    // peel unaligned entries off both ends, then climb a level
+    auto a = _first;
+    auto b = _last;
+    for(std::size_t k = 0; a < b; ++k)
+    {
+      if(k == levels_.size() || b - a < fanout)
+      {
+        for(auto i = a; i < b; ++i)
+        {
+          take(k, i);
+        }
+        break;
+      }
+      for(; a % fanout != 0 && a < b; ++a)
+      {
+        take(k, a);
+      }
+      for(; b % fanout != 0 && a < b; --b)
+      {
+        take(k, b - 1);
+      }
+      a /= fanout;
+      b /= fanout;
+    }
+    return result;
+  }
+auto Plot::draw(Renderer& _r, const SDL_FRect& _area, std::size_t _first, std::size_t _last, range _y) -> void
+  {
+    KT_TRACE_ZONE("plot", "gfx");
+    _last = std::min(_last, samples_.size());
+    if(_first >= _last || _area.w <= 0.0f || _area.h <= 0.0f)
+    {
+      return;
+    }
+    auto count   = _last - _first;
+    auto scale   = _y.hi > _y.lo? _area.h / (_y.hi - _y.lo) : 0.0f;
+    auto bottom  = _area.y + _area.h;
+    auto to_y    = [&](float _v) { return bottom - (_v - _y.lo) * scale; };
+    auto columns = std::max<std::size_t>(1, std::size_t(_area.w));
+    points_.clear();
+    if(count <= columns)
+    {
+      auto step = count > 1? (_area.w - 1.0f) / float(count - 1) : 0.0f;
+      for(std::size_t i = 0; i < count; ++i)
+      {
+        points_.push_back(SDL_FPoint { _area.x + float(i) * step, to_y(samples_[_first + i]) });
+      }
+    }
+    else
+    {
+      // a vertical stroke per column, alternating direction so the joins
+      // between columns stay short; each column is widened to meet the one
+      // before, so the line never breaks
+      range prev { 0.0f, 0.0f };
+      for(std::size_t c = 0; c < columns; ++c)
+      {
+        auto env = envelope(_first + c * count / columns, _first + (c + 1) * count / columns);
+        if(c > 0)
+        {
+          env.lo = std::min(env.lo, prev.hi);
+          env.hi = std::max(env.hi, prev.lo);
+        }
+        prev   = env;
+        auto x = _area.x + float(c);
+        if(c % 2 == 0)
+        {
+          points_.push_back(SDL_FPoint { x, to_y(env.lo) });
+          points_.push_back(SDL_FPoint { x, to_y(env.hi) });
+        }
+        else
+        {
+          points_.push_back(SDL_FPoint { x, to_y(env.hi) });
+          points_.push_back(SDL_FPoint { x, to_y(env.lo) });
+        }
+      }
+    }
+    if(points_.size() == 1)
+    {
+      points_.push_back(points_.front());
+    }
+    _r.lines_f(points_.data(), int(points_.size()));
+  }
+auto Plot::draw(Renderer& _r, const SDL_FRect& _area) -> void
+  {
+    draw(_r, _area, 0, samples_.size(), envelope(0, samples_.size()));
+  }
+} /* namespace gfx */
+} /* namespace kt */
@@ -1,4 +1,5 @@
 #include <kt/gfx/renderer.hpp>
+#include <kt/trace.hpp>
 #include <functional>
 namespace kt {
 namespace gfx {
@@ -6,6 +7,10 @@ Renderer::Renderer(SDL_Window* _w, int _index, uint32_t _flags)
   {
     renderer_ = sdl_assert(SDL_CreateRenderer(_w, _index, _flags));
   }
+Renderer::Renderer(SDL_Surface* _target)
+  {
+    renderer_ = sdl_assert(SDL_CreateSoftwareRenderer(_target));
+  }
 Renderer::~Renderer()
   {
     release();
@@ -28,28 +33,52 @@ auto Renderer::color(uint8_t _r, uint8_t _g, uint8_t _b) -> void
   }
 auto Renderer::color(uint8_t _r, uint8_t _g, uint8_t _b, uint8_t _a) -> void
   {
-    sdl_assert(SDL_SetRenderDrawColor(renderer_, _r, _g, _b, _a));
+    apply(state_.color, Color { _r, _g, _b, _a }, [&]
+      {
+        sdl_assert(SDL_SetRenderDrawColor(renderer_, _r, _g, _b, _a));
+      });
   }
 auto Renderer::clear() -> void
   {
+    count_draw();
     sdl_assert(SDL_RenderClear(renderer_));
   }
 auto Renderer::present() -> void
   {
+    KT_TRACE_ZONE("present", "gfx");
     SDL_RenderPresent(renderer_);
+    last_frame_ = frame_;
+    frame_      = frame_counters {};
   }
 auto Renderer::point(int _x, int _y) -> void
   {
+    count_draw();
     sdl_assert(SDL_RenderDrawPoint(renderer_, _x, _y));
   }
 auto Renderer::line(int _x1, int _y1, int _x2, int _y2) -> void
   {
+    count_draw();
     sdl_assert(SDL_RenderDrawLine(renderer_, _x1, _y1, _x2, _y2));
   }
 auto Renderer::line_f(float _x1, float _y1, float _x2, float _y2) -> void
   {
+    count_draw();
     sdl_assert(SDL_RenderDrawLineF(renderer_, _x1, _y1, _x2, _y2));
   }
+auto Renderer::lines_f(const SDL_FPoint* _points, int _count) -> void
+  {
+    if(_count < 2)
+    {
+      return;
+    }
+    count_draw(std::size_t(_count - 1));
+    sdl_assert(SDL_RenderDrawLinesF(renderer_, _points, _count));
+  }
+auto Renderer::fill_rect(const SDL_Rect& _r) -> void
+  {
+    count_draw();
+    sdl_assert(SDL_RenderFillRect(renderer_, &_r));
+  }
 auto Renderer::color(const Color&  c) -> void
   {
     color(c.r(), c.g(), c.b(), c.a());
@@ -120,51 +149,142 @@ auto Renderer::circle_fill(int _cx, int _cy, int _radius) -> void
   }
 auto Renderer::set_target(Texture& _t) -> void
   {
-    SDL_SetRenderTarget(renderer_, _t.get());
+    bind_target(_t.get());
   }
 auto Renderer::set_default_target() -> void
   {
-    SDL_SetRenderTarget(renderer_, NULL);
+    bind_target(NULL);
+  }
+auto Renderer::bind_target(SDL_Texture* _t) -> void
+  {
+    apply(state_.target, _t, [&]
+      {
+        sdl_assert(SDL_SetRenderTarget(renderer_, _t));
+        // binding a texture gives it a fresh clip and scale; the window's
+        // are saved and come back when it's bound again
+        if(_t)
+        {
+          state_.texture.clip   = clip_state { false, SDL_Rect {} };
+          state_.texture.scale  = std::make_pair(1.0f, 1.0f);
+        }
+      });
+  }
+auto Renderer::current_target_state() -> target_state&
+  {
+    // until the first bind we can't know which set SDL is using, so treat
+    // both as unknown
+    if(!state_.target)
+    {
+      state_.window   = target_state {};
+      state_.texture  = target_state {};
+    }
+    return state_.target && *state_.target? state_.texture : state_.window;
+  }
+auto Renderer::set_clip(const SDL_Rect& _clip) -> void
+  {
+    apply(current_target_state().clip, clip_state { true, _clip }, [&]
+      {
+        sdl_assert(SDL_RenderSetClipRect(renderer_, &_clip));
+      });
+  }
+auto Renderer::clear_clip() -> void
+  {
+    apply(current_target_state().clip, clip_state { false, SDL_Rect {} }, [&]
+      {
+        sdl_assert(SDL_RenderSetClipRect(renderer_, NULL));
+      });
+  }
+auto Renderer::set_scale(float _sx, float _sy) -> void
+  {
+    apply(current_target_state().scale, std::make_pair(_sx, _sy), [&]
+      {
+        sdl_assert(SDL_RenderSetScale(renderer_, _sx, _sy));
+      });
   }
 auto Renderer::copy(const Texture& _t) -> void
   {
+    count_copy();
     sdl_assert(SDL_RenderCopy(renderer_, _t.get(), NULL, NULL));
   }
 auto Renderer::copy(const Texture& _t, SDL_Rect& _dest) -> void
   {
+    count_copy();
     sdl_assert(SDL_RenderCopy(renderer_, _t.get(), NULL, &_dest));
   }
 auto Renderer::copy(const Texture& _t, SDL_Rect& _src, SDL_Rect& _dest, double _angle) -> void
   {
+    count_copy();
     sdl_assert(SDL_RenderCopyEx(renderer_, _t.get(), &_src, &_dest, _angle, NULL, SDL_FLIP_NONE));
   }
 auto Renderer::copy(const Texture& _t, SDL_Rect& _src, SDL_Rect& _dest) -> void
   {
+    count_copy();
     sdl_assert(SDL_RenderCopy(renderer_, _t.get(), &_src, &_dest));
   }
 auto Renderer::copy(const Texture& _t, int _x, int _y) -> void
   {
-    int w, h;
-    sdl_assert(SDL_QueryTexture(_t.get(), NULL, NULL, &w, &h));
-    SDL_Rect dest { _x, _y, w, h };
+    auto sz = _t.get_size();
+    SDL_Rect dest { _x, _y, sz.w, sz.h };
+    count_copy();
     sdl_assert(SDL_RenderCopy(renderer_, _t.get(), NULL, &dest));
   }
 auto Renderer::copy(const Texture& _t, int _x, int _y, double _angle) -> void
   {
-    int w, h;
-    sdl_assert(SDL_QueryTexture(_t.get(), NULL, NULL, &w, &h));
-    SDL_Rect dest { _x, _y, w, h };
+    auto sz = _t.get_size();
+    SDL_Rect dest { _x, _y, sz.w, sz.h };
+    count_copy();
     sdl_assert(SDL_RenderCopyEx(renderer_, _t.get(), NULL, &dest, _angle, NULL, SDL_FLIP_NONE));
   }
+auto Renderer::geometry(const Texture* _t, const SDL_Vertex* _vertices, int _num_vertices, const int* _indices, int _num_indices) -> void
+  {
+    KT_TRACE_ZONE("geometry", "gfx");
+    count_draw(std::size_t(_indices? _num_indices : _num_vertices) / 3);
+    sdl_assert(SDL_RenderGeometry(renderer_, _t? _t->get() : NULL, _vertices, _num_vertices, _indices, _num_indices));
+  }
 auto Renderer::set_draw_blend(SDL_BlendMode _m) -> void
   {
-    SDL_SetRenderDrawBlendMode(renderer_, _m);
+    apply(state_.blend, _m, [&]
+      {
+        sdl_assert(SDL_SetRenderDrawBlendMode(renderer_, _m));
+      });
   }
 auto Renderer::get_color() -> Color
   {
+    if(state_.color)
+    {
+      return *state_.color;
+    }
     uint8_t _r, _g, _b, _a;
     sdl_assert(SDL_GetRenderDrawColor(renderer_, &_r, &_g, &_b, &_a));
-    return Color { _r, _g, _b, _a };
+    state_.color = Color { _r, _g, _b, _a };
+    return *state_.color;
+  }
+auto Renderer::state_changes() const -> state_counters
+  {
+    return last_frame_.state;
+  }
+auto Renderer::frame_stats() const -> const frame_counters&
+  {
+    return last_frame_;
+  }
+auto Renderer::count_texture_created() -> void
+  {
+    ++frame_.textures_created;
+  }
+auto Renderer::count_upload(std::size_t _bytes) -> void
+  {
+    frame_.bytes_uploaded += _bytes;
+  }
+auto Renderer::invalidate_state() -> void
+  {
+    state_ = render_state {};
+  }
+auto Renderer::forget(SDL_Texture* _t) -> void
+  {
+    if(state_.target && *state_.target == _t)
+    {
+      state_.target = static_cast<SDL_Texture*>(NULL);
+    }
   }
 } /* namespace gfx */
 } /* namespace kt */
@@ -0,0 +1,256 @@
+#include <kt/gfx/scene.hpp>
+#include <kt/gfx/renderer.hpp>
+#include <kt/trace.hpp>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+namespace kt {
+namespace gfx {
+namespace {
+auto key(int _x, int _y) -> uint64_t
+  {
+    return (uint64_t(uint32_t(_x)) << 32) | uint64_t(uint32_t(_y));
+  }
+auto touches(const SDL_FRect& _a, const SDL_FRect& _b) -> bool
+  {
+    return _a.x <= _b.x + _b.w && _b.x <= _a.x + _a.w
+        && _a.y <= _b.y + _b.h && _b.y <= _a.y + _a.h;
+  }
+auto erase_one(std::vector<Scene::id>& _ids, Scene::id _item) -> void
+  {
+    auto it = std::find(_ids.begin(), _ids.end(), _item);
+    if(it != _ids.end())
+    {
+      *it = _ids.back();
+      _ids.pop_back();
+    }
+  }
+} /* namespace */
+Scene::Scene(float _cell_size)
+    : cell_size_(_cell_size)
+  {
+    if(!(_cell_size > 0.0f))
+    {
+      throw std::runtime_error("scene cell size must be positive");
+    }
+  }
+auto Scene::cells_of(const SDL_FRect& _bounds) const -> span
+  {
+    auto x1 = std::floor(_bounds.x / cell_size_);
+    auto y1 = std::floor(_bounds.y / cell_size_);
+    auto x2 = std::floor((_bounds.x + _bounds.w) / cell_size_);
+    auto y2 = std::floor((_bounds.y + _bounds.h) / cell_size_);
+    // also catches NaN and bounds too far out for an int
+    if(!(std::fabs(x1) < 1e9f && std::fabs(y1) < 1e9f && std::fabs(x2) < 1e9f && std::fabs(y2) < 1e9f))
+    {
+      return span { 1, 0, 0, 0 };
+    }
+    return span { int(x1), int(y1), int(x2), int(y2) };
+  }
+auto Scene::filed_cells(const SDL_FRect& _bounds) const -> span
+  {
+    auto cells = cells_of(_bounds);
+    if(cells.x2 - cells.x1 >= max_cell_span || cells.y2 - cells.y1 >= max_cell_span)
+    {
+      return span { 1, 0, 0, 0 };
+    }
+    return cells;
+  }
+auto Scene::file(id _item, const span& _cells) -> void
+  {
+    if(_cells.x1 > _cells.x2)
+    {
+      large_.push_back(_item);
+      return;
+    }
+    for(auto y = _cells.y1; y <= _cells.y2; ++y)
+    {
+      for(auto x = _cells.x1; x <= _cells.x2; ++x)
+      {
+        cells_[key(x, y)].push_back(_item);
+      }
+    }
+  }
+auto Scene::unfile(id _item, const span& _cells) -> void
+  {
+    if(_cells.x1 > _cells.x2)
+    {
+      erase_one(large_, _item);
+      return;
+    }
+    for(auto y = _cells.y1; y <= _cells.y2; ++y)
+    {
+      for(auto x = _cells.x1; x <= _cells.x2; ++x)
+      {
+        auto it = cells_.find(key(x, y));
+        if(it == cells_.end())
+        {
+          continue;
+        }
+        erase_one(it->second, _item);
+        if(it->second.empty())
+        {
+          cells_.erase(it);
+        }
+      }
+    }
+  }
+auto Scene::insert(const SDL_FRect& _bounds, draw_fn _draw, int _z) -> id
+  {
+    id handle;
+    if(free_.empty())
+    {
+      handle = id(items_.size());
+      items_.emplace_back();
+    }
+    else
+    {
+      handle = free_.back();
+      free_.pop_back();
+    }
+    auto& i   = items_[handle];
+    i.bounds  = _bounds;
+    i.cells   = filed_cells(_bounds);
+    i.draw    = std::move(_draw);
+    i.z       = _z;
+    i.order   = next_order_++;
+    i.stamp   = 0;
+    i.live    = true;
+    file(handle, i.cells);
+    return handle;
+  }
+auto Scene::move(id _item, const SDL_FRect& _bounds) -> void
+  {
+    auto& i = items_.at(_item);
+    if(!i.live)
+    {
+      return;
+    }
+    auto cells  = filed_cells(_bounds);
+    i.bounds    = _bounds;
+    if(cells.x1 == i.cells.x1 && cells.y1 == i.cells.y1 && cells.x2 == i.cells.x2 && cells.y2 == i.cells.y2)
+    {
+      return;
+    }
+    unfile(_item, i.cells);
+    file(_item, cells);
+    i.cells = cells;
+  }
+auto Scene::remove(id _item) -> void
+  {
+    auto& i = items_.at(_item);
+    if(!i.live)
+    {
+      return;
+    }
+    unfile(_item, i.cells);
+    i.draw  = nullptr;
+    i.live  = false;
+    free_.push_back(_item);
+  }
+auto Scene::clear() -> void
+  {
+    items_.clear();
+    free_.clear();
+    cells_.clear();
+    large_.clear();
+  }
+auto Scene::bounds(id _item) const -> const SDL_FRect&
+  {
+    return items_.at(_item).bounds;
+  }
+auto Scene::query(const SDL_FRect& _area, std::vector<id>& _out) -> void
+  {
+    KT_TRACE_ZONE("scene query", "gfx");
+    _out.clear();
+    stats_.visited = 0;
+    // items spanning several cells are met once per cell; the stamp makes
+    // each one count once
+    if(++stamp_ == 0)
+    {
+      for(auto& i : items_)
+      {
+        i.stamp = 0;
+      }
+      stamp_ = 1;
+    }
+    auto take = [&](id _item)
+      {
+        ++stats_.visited;
+        auto& i = items_[_item];
+        if(i.stamp != stamp_)
+        {
+          i.stamp = stamp_;
+          if(touches(i.bounds, _area))
+          {
+            _out.push_back(_item);
+          }
+        }
+      };
+    auto area = cells_of(_area);
+    if(area.x1 > area.x2
+      || std::size_t(area.x2 - area.x1 + 1) * std::size_t(area.y2 - area.y1 + 1) > cells_.size())
+    {
+      // the area covers more cells than are occupied; walk those instead
+      for(auto& [k, ids] : cells_)
+      {
+        for(auto item : ids)
+        {
+          take(item);
+        }
+      }
+    }
+    else
+    {
+      for(auto y = area.y1; y <= area.y2; ++y)
+      {
+        for(auto x = area.x1; x <= area.x2; ++x)
+        {
+          auto it = cells_.find(key(x, y));
+          if(it == cells_.end())
+          {
+            continue;
+          }
+          for(auto item : it->second)
+          {
+            take(item);
+          }
+        }
+      }
+    }
+    for(auto item : large_)
+    {
+      take(item);
+    }
+    std::sort(_out.begin(), _out.end(), [&](id _a, id _b)
+      {
+        auto& a = items_[_a];
+        auto& b = items_[_b];
+        return a.z != b.z? a.z < b.z : a.order < b.order;
+      });
+    stats_.visible = _out.size();
+  }
+auto Scene::draw(Renderer& _r, const SDL_FRect& _camera, float _x, float _y) -> void
+  {
+    KT_TRACE_ZONE("scene draw", "gfx");
+    query(_camera, visible_);
+    auto dx = _x - _camera.x;
+    auto dy = _y - _camera.y;
+    for(auto handle : visible_)
+    {
+      auto& i = items_[handle];
+      if(i.draw)
+      {
+        i.draw(_r, SDL_FRect { i.bounds.x + dx, i.bounds.y + dy, i.bounds.w, i.bounds.h });
+      }
+    }
+  }
+auto Scene::stats() const -> counters
+  {
+    auto result   = stats_;
+    result.items  = items_.size() - free_.size();
+    result.cells  = cells_.size();
+    return result;
+  }
+} /* namespace gfx */
+} /* namespace kt */
@@ -0,0 +1,89 @@
+#include <kt/gfx/sprite_batch.hpp>
+#include <kt/gfx/renderer.hpp>
+#include <cmath>
+#include <numbers>
+namespace kt {
+namespace gfx {
+auto SpriteBatch::draw(const Texture& _t, const SDL_Rect& _src, const SDL_FRect& _dest, double _angle, Color _tint) -> void
+  {
+    auto sz = _t.get_size();
+    if(sz.w <= 0 || sz.h <= 0)
+    {
+      return;
+    }
+    auto u1 = float(_src.x) / sz.w;
+    auto v1 = float(_src.y) / sz.h;
+    auto u2 = float(_src.x + _src.w) / sz.w;
+    auto v2 = float(_src.y + _src.h) / sz.h;
+    auto hw = _dest.w / 2;
+    auto hh = _dest.h / 2;
+    auto cx = _dest.x + hw;
+    auto cy = _dest.y + hh;
+    auto c  = 1.0f;
+    auto s  = 0.0f;
+    if(_angle != 0.0)
+    {
+      auto radians = _angle * std::numbers::pi / 180.0;
+      c = float(std::cos(radians));
+      s = float(std::sin(radians));
+    }
+    SDL_Color tint { _tint.r(), _tint.g(), _tint.b(), _tint.a() };
+    auto corner = [&](float _x, float _y, float _u, float _v)
+      {
+        return SDL_Vertex
+          { SDL_FPoint { cx + _x * c - _y * s, cy + _x * s + _y * c }
+          , tint
+          , SDL_FPoint { _u, _v }
+          };
+      };
+    if(runs_.empty() || runs_.back().texture != &_t)
+    {
+      runs_.push_back(run { &_t, indices_.size(), 0 });
+    }
+    auto base = int(vertices_.size());
+    vertices_.push_back(corner(-hw, -hh, u1, v1));
+    vertices_.push_back(corner( hw, -hh, u2, v1));
+    vertices_.push_back(corner( hw,  hh, u2, v2));
+    vertices_.push_back(corner(-hw,  hh, u1, v2));
+    for(auto i : { 0, 1, 2, 0, 2, 3 })
+    {
+      indices_.push_back(base + i);
+    }
+    runs_.back().index_count += 6;
+  }
+auto SpriteBatch::draw(const Atlas& _atlas, const Atlas::region& _region, float _x, float _y, double _angle, Color _tint) -> void
+  {
+    SDL_FRect dest { _x, _y, float(_region.rect.w), float(_region.rect.h) };
+    draw(_atlas.page(_region.page), _region.rect, dest, _angle, _tint);
+  }
+auto SpriteBatch::flush(Renderer& _r) -> void
+  {
+    for(const auto& r : runs_)
+    {
+      _r.geometry
+        ( r.texture
+        , vertices_.data()
+        , int(vertices_.size())
+        , indices_.data() + r.first_index
+        , int(r.index_count)
+        );
+    }
+    last_batches_ = runs_.size();
+    clear();
+  }
+auto SpriteBatch::clear() -> void
+  {
+    vertices_.clear();
+    indices_.clear();
+    runs_.clear();
+  }
+auto SpriteBatch::sprites() const -> std::size_t
+  {
+    return vertices_.size() / 4;
+  }
+auto SpriteBatch::last_batches() const -> std::size_t
+  {
+    return last_batches_;
+  }
+} /* namespace gfx */
+} /* namespace kt */
@@ -0,0 +1,149 @@
+#include <kt/gfx/streaming_texture.hpp>
+#include <kt/gfx/renderer.hpp>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+namespace kt {
+namespace gfx {
+namespace {
+auto bytes_of(const SDL_Rect& _r) -> std::size_t
+  {
+    return std::size_t(_r.w) * std::size_t(_r.h) * SDL_BYTESPERPIXEL(default_pixel_format);
+  }
+} /* namespace */
+StreamingTexture::StreamingTexture(Renderer& _r, int _w, int _h, int _buffers)
+    : renderer_(&_r)
+    , ring_(std::size_t(std::max(_buffers, 1)))
+  {
+    for(auto& b : ring_)
+    {
+      b.texture.reset(_r, _w, _h, SDL_TEXTUREACCESS_STREAMING);
+      b.texture.set(SDL_BLENDMODE_BLEND);
+      // streaming textures start with undefined contents
+      b.stale = SDL_Rect { 0, 0, _w, _h };
+    }
+  }
+StreamingTexture::~StreamingTexture()
+  {
+    if(locked_)
+    {
+      SDL_UnlockTexture(ring_[next_].texture.get());
+    }
+  }
+auto StreamingTexture::lock(const SDL_Rect* _area) -> locked
+  {
+    if(locked_)
+    {
+      throw std::runtime_error("streaming texture is already locked");
+    }
+    auto& b     = ring_[next_];
+    auto  size  = b.texture.get_size();
+    auto  whole = SDL_Rect { 0, 0, size.w, size.h };
+    auto  asked = whole;
+    if(_area && !SDL_IntersectRect(_area, &whole, &asked))
+    {
+      asked = SDL_Rect { 0, 0, 0, 0 };
+    }
+    auto area = asked;
+    if(b.stale)
+    {
+      if(area.w > 0 && area.h > 0)
+      {
+        SDL_UnionRect(&asked, &*b.stale, &area);
+      }
+      else
+      {
+        area = *b.stale;
+      }
+    }
+    locked result { nullptr, 0, area };
+    if(area.w > 0 && area.h > 0)
+    {
+      void* pixels = nullptr;
+      sdl_assert(SDL_LockTexture(b.texture.get(), &area, &pixels, &result.pitch));
+      result.pixels = static_cast<uint32_t*>(pixels);
+    }
+    locked_ = lock_state { area, asked };
+    return result;
+  }
+auto StreamingTexture::unlock() -> void
+  {
+    if(!locked_)
+    {
+      return;
+    }
+    auto [area, asked] = *locked_;
+    locked_.reset();
+    auto& b = ring_[next_];
+    if(area.w > 0 && area.h > 0)
+    {
+      SDL_UnlockTexture(b.texture.get());
+      renderer_->count_upload(bytes_of(area));
+      stats_.bytes_uploaded += bytes_of(area);
+      stats_.bytes_extra    += bytes_of(area) - bytes_of(asked);
+    }
+    b.stale.reset();
+    // only what was asked for is news to the others; the rest of the area
+    // caught this texture up with what they already have or still owe
+    if(asked.w > 0 && asked.h > 0)
+    {
+      for(auto& other : ring_)
+      {
+        if(&other == &b)
+        {
+          continue;
+        }
+        if(other.stale)
+        {
+          SDL_UnionRect(&*other.stale, &asked, &*other.stale);
+        }
+        else
+        {
+          other.stale = asked;
+        }
+      }
+    }
+    front_ = next_;
+    next_  = (next_ + 1) % ring_.size();
+    ++stats_.frames;
+  }
+auto StreamingTexture::upload(const uint32_t* _frame, int _pitch, const SDL_Rect* _dirty) -> void
+  {
+    auto l = lock(_dirty);
+    if(l.pixels)
+    {
+      auto src  = reinterpret_cast<const unsigned char*>(_frame);
+      auto line = std::size_t(l.area.w) * sizeof(uint32_t);
+      for(int y = 0; y < l.area.h; ++y)
+      {
+        auto from = src + std::size_t(l.area.y + y) * std::size_t(_pitch) + std::size_t(l.area.x) * sizeof(uint32_t);
+        std::memcpy(l.row(y), from, line);
+      }
+    }
+    unlock();
+  }
+auto StreamingTexture::front() const -> const Texture&
+  {
+    return ring_[front_].texture;
+  }
+auto StreamingTexture::set(SDL_BlendMode _bm) -> void
+  {
+    for(auto& b : ring_)
+    {
+      b.texture.set(_bm);
+    }
+  }
+auto StreamingTexture::get_size() const -> Texture::size
+  {
+    return ring_.front().texture.get_size();
+  }
+auto StreamingTexture::buffers() const -> int
+  {
+    return int(ring_.size());
+  }
+auto StreamingTexture::stats() const -> counters
+  {
+    return stats_;
+  }
+} /* namespace gfx */
+} /* namespace kt */
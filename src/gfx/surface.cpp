@@ -0,0 +1,722 @@
+#include <kt/gfx/surface.hpp>
+#include <kt/gfx/renderer.hpp>
+#include <kt/thread_pool.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define KT_GFX_X86 1
+#endif
+namespace kt {
+namespace gfx {
+namespace {
+// rounded x / 255 for x <= 255 * 255
+constexpr auto div255(uint32_t _x) -> uint32_t
+  {
+    _x += 128;
+    return (_x + (_x >> 8)) >> 8;
+  }
+auto blend_pixel(uint32_t _src, uint32_t _dst, SDL_BlendMode _m) -> uint32_t
+  {
+    auto s  = Color::from_pixel(_src);
+    auto d  = Color::from_pixel(_dst);
+    auto a  = uint32_t(s.a());
+    auto ia = 255 - a;
+    switch(_m)
+    {
+    case SDL_BLENDMODE_NONE:
+      return _src;
+    case SDL_BLENDMODE_ADD:
+      return Color
+        { uint8_t(std::min<uint32_t>(255, d.r() + div255(s.r() * a)))
+        , uint8_t(std::min<uint32_t>(255, d.g() + div255(s.g() * a)))
+        , uint8_t(std::min<uint32_t>(255, d.b() + div255(s.b() * a)))
+        , d.a()
+        }.pixel();
+    case SDL_BLENDMODE_MOD:
+      return Color
+        { uint8_t(div255(s.r() * d.r()))
+        , uint8_t(div255(s.g() * d.g()))
+        , uint8_t(div255(s.b() * d.b()))
+        , d.a()
+        }.pixel();
+    default:
+      // the alpha channel blends as a + d.a * (1 - a), which is the colour
+      // formula with the source weight fixed at 255
+      return Color
+        { uint8_t(div255(s.r() * a + d.r() * ia))
+        , uint8_t(div255(s.g() * a + d.g() * ia))
+        , uint8_t(div255(s.b() * a + d.b() * ia))
+        , uint8_t(div255(s.a() * 255 + d.a() * ia))
+        }.pixel();
+    }
+  }
+auto fill_scalar(uint32_t* _dst, std::size_t _n, uint32_t _px) -> void
+  {
+    std::fill_n(_dst, _n, _px);
+  }
+auto blend_fill_scalar(uint32_t* _dst, std::size_t _n, uint32_t _px) -> void
+  {
+    for(std::size_t i = 0; i < _n; ++i)
+    {
+      _dst[i] = blend_pixel(_px, _dst[i], SDL_BLENDMODE_BLEND);
+    }
+  }
+auto blend_scalar(uint32_t* _dst, const uint32_t* _src, std::size_t _n) -> void
+  {
+    for(std::size_t i = 0; i < _n; ++i)
+    {
+      _dst[i] = blend_pixel(_src[i], _dst[i], SDL_BLENDMODE_BLEND);
+    }
+  }
+#if defined(KT_GFX_X86) && defined(__SSE2__)
+inline auto div255_sse2(__m128i _x) -> __m128i
+  {
+    _x = _mm_add_epi16(_x, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(_x, _mm_srli_epi16(_x, 8)), 8);
+  }
+// blend two pixels held as 16-bit lanes
+inline auto blend2_sse2(__m128i _s, __m128i _d) -> __m128i
+  {
+    const auto alpha_lanes  = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+    const auto full         = _mm_set1_epi16(255);
+    auto a  = _mm_shufflehi_epi16(_mm_shufflelo_epi16(_s, 0xFF), 0xFF);
+    auto fa = _mm_or_si128(_mm_andnot_si128(alpha_lanes, a), _mm_and_si128(alpha_lanes, full));
+    auto ia = _mm_sub_epi16(full, a);
+    return div255_sse2(_mm_add_epi16(_mm_mullo_epi16(_s, fa), _mm_mullo_epi16(_d, ia)));
+  }
+inline auto blend4_sse2(__m128i _s, __m128i _d) -> __m128i
+  {
+    auto zero = _mm_setzero_si128();
+    auto lo   = blend2_sse2(_mm_unpacklo_epi8(_s, zero), _mm_unpacklo_epi8(_d, zero));
+    auto hi   = blend2_sse2(_mm_unpackhi_epi8(_s, zero), _mm_unpackhi_epi8(_d, zero));
+    return _mm_packus_epi16(lo, hi);
+  }
+auto fill_sse2(uint32_t* _dst, std::size_t _n, uint32_t _px) -> void
+  {
+    auto v = _mm_set1_epi32(int(_px));
+    std::size_t i = 0;
+    for(; i + 4 <= _n; i += 4)
+    {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(_dst + i), v);
+    }
+    fill_scalar(_dst + i, _n - i, _px);
+  }
+auto blend_fill_sse2(uint32_t* _dst, std::size_t _n, uint32_t _px) -> void
+  {
+    auto s = _mm_set1_epi32(int(_px));
+    std::size_t i = 0;
+    for(; i + 4 <= _n; i += 4)
+    {
+      auto p = reinterpret_cast<__m128i*>(_dst + i);
+      _mm_storeu_si128(p, blend4_sse2(s, _mm_loadu_si128(p)));
+    }
+    blend_fill_scalar(_dst + i, _n - i, _px);
+  }
+auto blend_sse2(uint32_t* _dst, const uint32_t* _src, std::size_t _n) -> void
+  {
+    std::size_t i = 0;
+    for(; i + 4 <= _n; i += 4)
+    {
+      auto p = reinterpret_cast<__m128i*>(_dst + i);
+      auto s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_src + i));
+      _mm_storeu_si128(p, blend4_sse2(s, _mm_loadu_si128(p)));
+    }
+    blend_scalar(_dst + i, _src + i, _n - i);
+  }
+#endif
+#if defined(KT_GFX_X86)
+#define KT_AVX2 __attribute__((target("avx2")))
+KT_AVX2 inline auto div255_avx2(__m256i _x) -> __m256i
+  {
+    _x = _mm256_add_epi16(_x, _mm256_set1_epi16(128));
+    return _mm256_srli_epi16(_mm256_add_epi16(_x, _mm256_srli_epi16(_x, 8)), 8);
+  }
+KT_AVX2 inline auto blend4_avx2(__m256i _s, __m256i _d) -> __m256i
+  {
+    const auto alpha_lanes  = _mm256_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0);
+    const auto full         = _mm256_set1_epi16(255);
+    auto a  = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(_s, 0xFF), 0xFF);
+    auto fa = _mm256_blendv_epi8(a, full, alpha_lanes);
+    auto ia = _mm256_sub_epi16(full, a);
+    return div255_avx2(_mm256_add_epi16(_mm256_mullo_epi16(_s, fa), _mm256_mullo_epi16(_d, ia)));
+  }
+// unpack/pack work within 128-bit halves, so pixel order survives the trip
+KT_AVX2 inline auto blend8_avx2(__m256i _s, __m256i _d) -> __m256i
+  {
+    auto zero = _mm256_setzero_si256();
+    auto lo   = blend4_avx2(_mm256_unpacklo_epi8(_s, zero), _mm256_unpacklo_epi8(_d, zero));
+    auto hi   = blend4_avx2(_mm256_unpackhi_epi8(_s, zero), _mm256_unpackhi_epi8(_d, zero));
+    return _mm256_packus_epi16(lo, hi);
+  }
+KT_AVX2 auto fill_avx2(uint32_t* _dst, std::size_t _n, uint32_t _px) -> void
+  {
+    auto v = _mm256_set1_epi32(int(_px));
+    std::size_t i = 0;
+    for(; i + 8 <= _n; i += 8)
+    {
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(_dst + i), v);
+    }
+    fill_scalar(_dst + i, _n - i, _px);
+  }
+KT_AVX2 auto blend_fill_avx2(uint32_t* _dst, std::size_t _n, uint32_t _px) -> void
+  {
+    auto s = _mm256_set1_epi32(int(_px));
+    std::size_t i = 0;
+    for(; i + 8 <= _n; i += 8)
+    {
+      auto p = reinterpret_cast<__m256i*>(_dst + i);
+      _mm256_storeu_si256(p, blend8_avx2(s, _mm256_loadu_si256(p)));
+    }
+    blend_fill_scalar(_dst + i, _n - i, _px);
+  }
+KT_AVX2 auto blend_avx2(uint32_t* _dst, const uint32_t* _src, std::size_t _n) -> void
+  {
+    std::size_t i = 0;
+    for(; i + 8 <= _n; i += 8)
+    {
+      auto p = reinterpret_cast<__m256i*>(_dst + i);
+      auto s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(_src + i));
+      _mm256_storeu_si256(p, blend8_avx2(s, _mm256_loadu_si256(p)));
+    }
+    blend_scalar(_dst + i, _src + i, _n - i);
+  }
+#undef KT_AVX2
+#endif
+struct kernel_table
+{
+  void (*fill)(uint32_t*, std::size_t, uint32_t);
+  void (*blend_fill)(uint32_t*, std::size_t, uint32_t);
+  void (*blend)(uint32_t*, const uint32_t*, std::size_t);
+};
+auto select_kernels() -> kernel_table
+  {
+#if defined(KT_GFX_X86)
+    if(__builtin_cpu_supports("avx2"))
+    {
+      return kernel_table { fill_avx2, blend_fill_avx2, blend_avx2 };
+    }
+#endif
+#if defined(KT_GFX_X86) && defined(__SSE2__)
+    return kernel_table { fill_sse2, blend_fill_sse2, blend_sse2 };
+#else
+    return kernel_table { fill_scalar, blend_fill_scalar, blend_scalar };
+#endif
+  }
+auto kernels() -> const kernel_table&
+  {
+    static const kernel_table table = select_kernels();
+    return table;
+  }
+auto fill_run(uint32_t* _dst, std::size_t _n, uint32_t _px, SDL_BlendMode _m) -> void
+  {
+    auto alpha = Color::from_pixel(_px).a();
+    if(_m == SDL_BLENDMODE_NONE || (_m == SDL_BLENDMODE_BLEND && alpha == SDL_ALPHA_OPAQUE))
+    {
+      kernels().fill(_dst, _n, _px);
+    }
+    else if(_m == SDL_BLENDMODE_BLEND)
+    {
+      if(alpha != SDL_ALPHA_TRANSPARENT)
+      {
+        kernels().blend_fill(_dst, _n, _px);
+      }
+    }
+    else
+    {
+      for(std::size_t i = 0; i < _n; ++i)
+      {
+        _dst[i] = blend_pixel(_px, _dst[i], _m);
+      }
+    }
+  }
+auto copy_run(uint32_t* _dst, const uint32_t* _src, std::size_t _n, SDL_BlendMode _m) -> void
+  {
+    if(_m == SDL_BLENDMODE_NONE)
+    {
+      std::memmove(_dst, _src, _n * sizeof(uint32_t));
+    }
+    else if(_m == SDL_BLENDMODE_BLEND)
+    {
+      kernels().blend(_dst, _src, _n);
+    }
+    else
+    {
+      for(std::size_t i = 0; i < _n; ++i)
+      {
+        _dst[i] = blend_pixel(_src[i], _dst[i], _m);
+      }
+    }
+  }
+// run `_fn(first_row, last_row)` over `[_y1, _y2)`, in parallel when the
+// area is big enough to pay for waking the pool
+template<typename FnT>
+auto for_rows(int _y1, int _y2, int _w, FnT&& _fn) -> void
+  {
+    constexpr std::size_t parallel_pixels = 1 << 16;
+    if(_y2 <= _y1 || _w <= 0)
+    {
+      return;
+    }
+    auto area = std::size_t(_y2 - _y1) * std::size_t(_w);
+    if(area < parallel_pixels)
+    {
+      _fn(_y1, _y2);
+      return;
+    }
+    auto grain = std::max<std::size_t>(1, (parallel_pixels / 4) / std::size_t(_w));
+    thread_pool::shared().parallel_for(_y1, _y2, grain, [&](std::size_t _a, std::size_t _b)
+      {
+        _fn(int(_a), int(_b));
+      });
+  }
+auto intersect(const SDL_Rect& _a, const SDL_Rect& _b, SDL_Rect& _result) -> bool
+  {
+    auto x1 = std::max(_a.x, _b.x);
+    auto y1 = std::max(_a.y, _b.y);
+    auto x2 = std::min(_a.x + _a.w, _b.x + _b.w);
+    auto y2 = std::min(_a.y + _a.h, _b.y + _b.h);
+    _result = SDL_Rect { x1, y1, x2 - x1, y2 - y1 };
+    return x2 > x1 && y2 > y1;
+  }
+} /* namespace */
+
+Surface::Surface(Texture::size _size)
+    : Surface(_size.w, _size.h)
+  {
+  }
+Surface::Surface(int _w, int _h)
+    : Surface(_w, _h, Color::transparent())
+  {
+  }
+Surface::Surface(int _w, int _h, Color _c)
+  {
+    reset(_w, _h);
+    std::fill(pixels_.begin(), pixels_.end(), _c.pixel());
+  }
+auto Surface::load_bmp(const std::string& _path) -> Surface
+  {
+    SDL_Surface* loaded     = nullptr;
+    SDL_Surface* converted  = nullptr;
+    Surface result;
+    try
+    {
+      loaded    = sdl_assert(SDL_LoadBMP(_path.c_str()));
+      converted = sdl_assert(SDL_ConvertSurfaceFormat(loaded, default_pixel_format, 0));
+      result.reset(converted->w, converted->h);
+      auto src = static_cast<const uint8_t*>(converted->pixels);
+      for(int y = 0; y < converted->h; ++y)
+      {
+        std::memcpy(result.row(y), src + std::size_t(y) * converted->pitch, std::size_t(result.pitch()));
+      }
+    }
+    catch(...)
+    {
+      if(converted) { SDL_FreeSurface(converted); }
+      if(loaded)    { SDL_FreeSurface(loaded);    }
+      throw;
+    }
+    SDL_FreeSurface(converted);
+    SDL_FreeSurface(loaded);
+    return result;
+  }
+auto Surface::reset(int _w, int _h) -> void
+  {
+    if(_w < 0 || _h < 0)
+    {
+      throw std::runtime_error("Surface size must not be negative");
+    }
+    pixels_.assign(std::size_t(_w) * std::size_t(_h), 0);
+    width_  = _w;
+    height_ = _h;
+    clip_.reset();
+  }
+auto Surface::width() const -> int
+  {
+    return width_;
+  }
+auto Surface::height() const -> int
+  {
+    return height_;
+  }
+auto Surface::get_size() const -> Texture::size
+  {
+    return Texture::size { width_, height_ };
+  }
+auto Surface::pitch() const -> int
+  {
+    return width_ * int(sizeof(uint32_t));
+  }
+auto Surface::pixels() const -> const uint32_t*
+  {
+    return pixels_.data();
+  }
+auto Surface::pixels() -> uint32_t*
+  {
+    return pixels_.data();
+  }
+auto Surface::row(int _y) const -> const uint32_t*
+  {
+    return pixels_.data() + std::size_t(_y) * std::size_t(width_);
+  }
+auto Surface::row(int _y) -> uint32_t*
+  {
+    return pixels_.data() + std::size_t(_y) * std::size_t(width_);
+  }
+auto Surface::bounds() const -> SDL_Rect
+  {
+    SDL_Rect all { 0, 0, width_, height_ };
+    SDL_Rect result { 0, 0, 0, 0 };
+    if(clip_)
+    {
+      intersect(all, *clip_, result);
+      return result;
+    }
+    return all;
+  }
+auto Surface::clear() -> void
+  {
+    // like SDL_RenderClear, this ignores the blend mode but honours the clip
+    auto b  = bounds();
+    auto px = color_.pixel();
+    for_rows(b.y, b.y + b.h, b.w, [&](int _y1, int _y2)
+      {
+        for(int y = _y1; y < _y2; ++y)
+        {
+          kernels().fill(row(y) + b.x, std::size_t(b.w), px);
+        }
+      });
+  }
+auto Surface::color(uint8_t _c) -> void
+  {
+    color(_c, _c, _c);
+  }
+auto Surface::color(uint8_t _r, uint8_t _g, uint8_t _b) -> void
+  {
+    color(_r, _g, _b, SDL_ALPHA_OPAQUE);
+  }
+auto Surface::color(uint8_t _r, uint8_t _g, uint8_t _b, uint8_t _a) -> void
+  {
+    color_ = Color { _r, _g, _b, _a };
+  }
+auto Surface::color(const Color& _c) -> void
+  {
+    color_ = _c;
+  }
+auto Surface::get_color() -> Color
+  {
+    return color_;
+  }
+auto Surface::point(int _x, int _y) -> void
+  {
+    auto b = bounds();
+    if(_x >= b.x && _x < b.x + b.w && _y >= b.y && _y < b.y + b.h)
+    {
+      auto& px = row(_y)[_x];
+      px = blend_pixel(color_.pixel(), px, draw_blend_);
+    }
+  }
+auto Surface::span(int _x1, int _x2, int _y) -> void
+  {
+    auto b = bounds();
+    if(_x1 > _x2)
+    {
+      std::swap(_x1, _x2);
+    }
+    _x1 = std::max(_x1, b.x);
+    _x2 = std::min(_x2, b.x + b.w - 1);
+    if(_y < b.y || _y >= b.y + b.h || _x1 > _x2)
+    {
+      return;
+    }
+    fill_run(row(_y) + _x1, std::size_t(_x2 - _x1 + 1), color_.pixel(), draw_blend_);
+  }
+auto Surface::line(int _x1, int _y1, int _x2, int _y2) -> void
+  {
+    if(_y1 == _y2)
+    {
+      span(_x1, _x2, _y1);
+      return;
+    }
+    auto dx = std::abs(_x2 - _x1);
+    auto dy = -std::abs(_y2 - _y1);
+    auto sx = _x1 < _x2? 1 : -1;
+    auto sy = _y1 < _y2? 1 : -1;
+    auto err = dx + dy;
+    while(true)
+    {
+      point(_x1, _y1);
+      if(_x1 == _x2 && _y1 == _y2)
+      {
+        break;
+      }
+      auto e2 = 2 * err;
+      if(e2 >= dy)
+      {
+        err += dy;
+        _x1 += sx;
+      }
+      if(e2 <= dx)
+      {
+        err += dx;
+        _y1 += sy;
+      }
+    }
+  }
+auto Surface::line_f(float _x1, float _y1, float _x2, float _y2) -> void
+  {
+    line(int(std::lround(_x1)), int(std::lround(_y1)), int(std::lround(_x2)), int(std::lround(_y2)));
+  }
+auto Surface::fill_rect(const SDL_Rect& _r) -> void
+  {
+    SDL_Rect area;
+    if(!intersect(_r, bounds(), area))
+    {
+      return;
+    }
+    auto px = color_.pixel();
+    for_rows(area.y, area.y + area.h, area.w, [&](int _y1, int _y2)
+      {
+        for(int y = _y1; y < _y2; ++y)
+        {
+          fill_run(row(y) + area.x, std::size_t(area.w), px, draw_blend_);
+        }
+      });
+  }
+auto Surface::circle(int _cx, int _cy, int _radius, bool _fill) -> void
+  {
+    // same midpoint walk as Renderer::circle, so both produce the same pixels
+    auto x = _radius;
+    auto x_sq = x * x;
+    auto x_trigger = x_sq - 2 * x - 1;
+    auto y = 0;
+    set_draw_blend(SDL_BLENDMODE_NONE);
+    auto plot_circle = [&](int x, int y)
+      {
+        point(_cx - x, _cy + y);
+        point(_cx + x, _cy + y);
+        point(_cx - x, _cy - y);
+        point(_cx + x, _cy - y);
+        point(_cx - y, _cy + x);
+        point(_cx + y, _cy + x);
+        point(_cx - y, _cy - x);
+        point(_cx + y, _cy - x);
+      };
+    auto plot_fill = [&](int x, int y)
+      {
+        span(_cx - x, _cx + x, _cy + y);
+        span(_cx - x, _cx + x, _cy - y);
+        span(_cx - y, _cx + y, _cy + x);
+        span(_cx - y, _cx + y, _cy - x);
+      };
+    while(x > y)
+    {
+      if(x_sq <= x_trigger)
+      {
+        --x;
+        x_trigger -= 2 * x - 1;
+      }
+      x_sq -= 2 * y + 1;
+      if(_fill)
+      {
+        plot_fill(x, y);
+      }
+      else
+      {
+        plot_circle(x, y);
+      }
+      ++y;
+    }
+  }
+auto Surface::circle_fill(int _cx, int _cy, int _radius) -> void
+  {
+    circle(_cx, _cy, _radius, true);
+  }
+auto Surface::set_clip(const SDL_Rect& _clip) -> void
+  {
+    clip_ = _clip;
+  }
+auto Surface::clear_clip() -> void
+  {
+    clip_.reset();
+  }
+auto Surface::set_draw_blend(SDL_BlendMode _m) -> void
+  {
+    draw_blend_ = _m;
+  }
+auto Surface::set(SDL_BlendMode _m) -> void
+  {
+    blend_ = _m;
+  }
+auto Surface::copy(const Surface& _s) -> void
+  {
+    SDL_Rect src  { 0, 0, _s.width_, _s.height_ };
+    SDL_Rect dest { 0, 0, width_, height_ };
+    copy(_s, src, dest);
+  }
+auto Surface::copy(const Surface& _s, SDL_Rect& _dest) -> void
+  {
+    SDL_Rect src { 0, 0, _s.width_, _s.height_ };
+    copy(_s, src, _dest);
+  }
+auto Surface::copy(const Surface& _s, int _x, int _y) -> void
+  {
+    SDL_Rect src  { 0, 0, _s.width_, _s.height_ };
+    SDL_Rect dest { _x, _y, _s.width_, _s.height_ };
+    copy(_s, src, dest);
+  }
+auto Surface::copy(const Surface& _s, int _x, int _y, double _angle) -> void
+  {
+    SDL_Rect src  { 0, 0, _s.width_, _s.height_ };
+    SDL_Rect dest { _x, _y, _s.width_, _s.height_ };
+    copy(_s, src, dest, _angle);
+  }
+auto Surface::copy(const Surface& _s, SDL_Rect& _src, SDL_Rect& _dest) -> void
+  {
+    if(&_s == this)
+    {
+      Surface snapshot(width_, height_);
+      snapshot.pixels_ = pixels_;
+      snapshot.blend_  = blend_;
+      copy(snapshot, _src, _dest);
+      return;
+    }
+    // clip the source to the image and shrink the destination to match, as
+    // SDL_RenderCopy does
+    SDL_Rect src, dest = _dest;
+    if(_src.w <= 0 || _src.h <= 0 || !intersect(_src, SDL_Rect { 0, 0, _s.width_, _s.height_ }, src))
+    {
+      return;
+    }
+    dest.x += (src.x - _src.x) * _dest.w / _src.w;
+    dest.y += (src.y - _src.y) * _dest.h / _src.h;
+    dest.w  = src.w * _dest.w / _src.w;
+    dest.h  = src.h * _dest.h / _src.h;
+    SDL_Rect area;
+    if(!intersect(dest, bounds(), area))
+    {
+      return;
+    }
+    auto blend = _s.blend_;
+    if(src.w == dest.w && src.h == dest.h)
+    {
+      for_rows(area.y, area.y + area.h, area.w, [&](int _y1, int _y2)
+        {
+          for(int y = _y1; y < _y2; ++y)
+          {
+            auto from = _s.row(src.y + y - dest.y) + src.x + area.x - dest.x;
+            copy_run(row(y) + area.x, from, std::size_t(area.w), blend);
+          }
+        });
+      return;
+    }
+    // nearest-neighbour scaling: gather each source row into a scratch row
+    // and push it through the same run kernels
+    std::vector<int> columns(std::size_t(area.w));
+    for(int x = 0; x < area.w; ++x)
+    {
+      columns[std::size_t(x)] = src.x + (area.x + x - dest.x) * src.w / dest.w;
+    }
+    for_rows(area.y, area.y + area.h, area.w, [&](int _y1, int _y2)
+      {
+        std::vector<uint32_t> scratch(std::size_t(area.w));
+        for(int y = _y1; y < _y2; ++y)
+        {
+          auto from = _s.row(src.y + (y - dest.y) * src.h / dest.h);
+          for(std::size_t x = 0; x < scratch.size(); ++x)
+          {
+            scratch[x] = from[columns[x]];
+          }
+          copy_run(row(y) + area.x, scratch.data(), scratch.size(), blend);
+        }
+      });
+  }
+auto Surface::write(const Surface& _s, int _x, int _y) -> void
+  {
+    SDL_Rect area;
+    if(!intersect(SDL_Rect { _x, _y, _s.width_, _s.height_ }, SDL_Rect { 0, 0, width_, height_ }, area))
+    {
+      return;
+    }
+    for_rows(area.y, area.y + area.h, area.w, [&](int _y1, int _y2)
+      {
+        for(int y = _y1; y < _y2; ++y)
+        {
+          copy_run(row(y) + area.x, _s.row(y - _y) + area.x - _x, std::size_t(area.w), SDL_BLENDMODE_NONE);
+        }
+      });
+  }
+auto Surface::copy(const Surface& _s, SDL_Rect& _src, SDL_Rect& _dest, double _angle) -> void
+  {
+    if(std::fmod(_angle, 360.0) == 0.0)
+    {
+      copy(_s, _src, _dest);
+      return;
+    }
+    if(_dest.w <= 0 || _dest.h <= 0 || _src.w <= 0 || _src.h <= 0)
+    {
+      return;
+    }
+    // rotate clockwise about the centre of `_dest`, like SDL_RenderCopyEx;
+    // walk the rotated bounding box and map each pixel back into the source
+    auto radians  = _angle * std::numbers::pi / 180.0;
+    auto c        = std::cos(radians);
+    auto s        = std::sin(radians);
+    auto half_w   = _dest.w / 2.0;
+    auto half_h   = _dest.h / 2.0;
+    auto cx       = _dest.x + half_w;
+    auto cy       = _dest.y + half_h;
+    auto extent_x = std::abs(half_w * c) + std::abs(half_h * s);
+    auto extent_y = std::abs(half_w * s) + std::abs(half_h * c);
+    SDL_Rect box
+      { int(std::floor(cx - extent_x))
+      , int(std::floor(cy - extent_y))
+      , int(std::ceil(2 * extent_x)) + 1
+      , int(std::ceil(2 * extent_y)) + 1
+      };
+    SDL_Rect area;
+    if(!intersect(box, bounds(), area))
+    {
+      return;
+    }
+    auto blend = _s.blend_;
+    for_rows(area.y, area.y + area.h, area.w, [&](int _y1, int _y2)
+      {
+        for(int y = _y1; y < _y2; ++y)
+        {
+          auto dst = row(y);
+          for(int x = area.x; x < area.x + area.w; ++x)
+          {
+            auto dx = x + 0.5 - cx;
+            auto dy = y + 0.5 - cy;
+            auto lx = dx * c + dy * s + half_w;
+            auto ly = -dx * s + dy * c + half_h;
+            if(lx < 0 || ly < 0 || lx >= _dest.w || ly >= _dest.h)
+            {
+              continue;
+            }
+            auto sx = _src.x + int(lx * _src.w / _dest.w);
+            auto sy = _src.y + int(ly * _src.h / _dest.h);
+            if(sx < 0 || sy < 0 || sx >= _s.width_ || sy >= _s.height_)
+            {
+              continue;
+            }
+            dst[x] = blend_pixel(_s.row(sy)[sx], dst[x], blend);
+          }
+        }
+      });
+  }
+auto Surface::upload(Texture& _t) const -> void
+  {
+    _t.update(pixels_.data(), pitch());
+  }
+auto Surface::make_texture(Renderer& _r) const -> Texture
+  {
+    Texture result(_r, width_, height_);
+    upload(result);
+    return result;
+  }
+} /* namespace gfx */
+} /* namespace kt */
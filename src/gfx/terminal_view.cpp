@@ -0,0 +1,467 @@
+#include <kt/gfx/terminal_view.hpp>
+#include <kt/gfx/renderer.hpp>
+#include <kt/terminal.hpp>
+#include <kt/trace.hpp>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+namespace kt {
+namespace gfx {
+namespace {
+constexpr uint64_t    unknown         = ~uint64_t(0);
+constexpr int         default_columns = 80;
+constexpr int         default_rows    = 24;
+// sixel pixels per cell when the terminal doesn't say
+constexpr int         cell_width      = 8;
+constexpr int         cell_height     = 16;
+constexpr int         sixel_colors    = 216;
+
+auto rgb(uint32_t _p) -> uint32_t
+  {
+    auto c = Color::from_pixel(_p);
+    return uint32_t(c.r()) << 16 | uint32_t(c.g()) << 8 | uint32_t(c.b());
+  }
+auto close(uint64_t _a, uint64_t _b, int _tolerance) -> bool
+  {
+    if(_a == unknown || _b == unknown)
+    {
+      return _a == _b;
+    }
+    for(int shift = 0; shift < 64; shift += 8)
+    {
+      auto d = int((_a >> shift) & 0xFF) - int((_b >> shift) & 0xFF);
+      if(d > _tolerance || -d > _tolerance)
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+auto append_color(std::string& _out, int _layer, uint32_t _rgb) -> void
+  {
+    char code[32];
+    auto n = std::snprintf(code, sizeof(code), "\x1b[%d;2;%u;%u;%um", _layer, (_rgb >> 16) & 0xFF, (_rgb >> 8) & 0xFF, _rgb & 0xFF);
+    _out.append(code, std::size_t(n));
+  }
+auto append_run(std::string& _out, char _c, int _n) -> void
+  {
+    if(_n > 3)
+    {
+      _out += '!';
+      _out += std::to_string(_n);
+      _out += _c;
+    }
+    else
+    {
+      _out.append(std::size_t(_n), _c);
+    }
+  }
+} /* namespace */
+TerminalView::TerminalView(std::FILE* _out, mode _mode)
+    : out_(_out)
+    , mode_(_mode)
+    , refilled_(clock::now())
+  {
+  }
+TerminalView::~TerminalView()
+  {
+    if(started_)
+    {
+      buffer_ += "\x1b[0m\x1b[?25h\n";
+      write();
+    }
+  }
+auto TerminalView::probe_sixel(int _timeout_ms) -> bool
+  {
+    if(!isatty(STDIN_FILENO) || !isatty(STDOUT_FILENO))
+    {
+      return false;
+    }
+    termios saved;
+    if(tcgetattr(STDIN_FILENO, &saved) != 0)
+    {
+      return false;
+    }
+    auto raw = saved;
+    raw.c_lflag &= tcflag_t(~(ICANON | ECHO));
+    tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+    // primary device attributes: the reply lists feature codes, 4 is sixel
+    constexpr char query[] = "\x1b[c";
+    auto sent   = ::write(STDOUT_FILENO, query, sizeof(query) - 1) == ssize_t(sizeof(query) - 1);
+    auto reply  = std::string {};
+    while(sent && reply.size() < 128 && (reply.empty() || reply.back() != 'c'))
+    {
+      pollfd in { STDIN_FILENO, POLLIN, 0 };
+      char   c;
+      if(poll(&in, 1, _timeout_ms) <= 0 || ::read(STDIN_FILENO, &c, 1) != 1)
+      {
+        break;
+      }
+      reply += c;
+    }
+    tcsetattr(STDIN_FILENO, TCSANOW, &saved);
+    auto start = reply.find("\x1b[?");
+    if(start == std::string::npos || reply.empty() || reply.back() != 'c')
+    {
+      return false;
+    }
+    auto codes = reply.substr(start + 3, reply.size() - start - 4);
+    for(std::size_t i = 0; i < codes.size(); )
+    {
+      auto end = codes.find(';', i);
+      if(codes.compare(i, end == std::string::npos? std::string::npos : end - i, "4") == 0)
+      {
+        return true;
+      }
+      if(end == std::string::npos)
+      {
+        break;
+      }
+      i = end + 1;
+    }
+    return false;
+  }
+auto TerminalView::set_mode(mode _mode) -> void
+  {
+    if(_mode != mode_)
+    {
+      mode_ = _mode;
+      invalidate();
+    }
+  }
+auto TerminalView::set_size(int _columns, int _rows) -> void
+  {
+    columns_  = std::max(0, _columns);
+    rows_     = std::max(0, _rows);
+  }
+auto TerminalView::set_bandwidth(std::size_t _bytes_per_second) -> void
+  {
+    bandwidth_  = _bytes_per_second;
+    budget_     = double(_bytes_per_second);
+    refilled_   = clock::now();
+  }
+auto TerminalView::set_tolerance(int _tolerance) -> void
+  {
+    tolerance_ = std::clamp(_tolerance, 0, 255);
+  }
+auto TerminalView::invalidate() -> void
+  {
+    clear_ = true;
+  }
+auto TerminalView::terminal_size() const -> std::pair<int, int>
+  {
+    if(columns_ > 0 && rows_ > 0)
+    {
+      return { columns_, rows_ };
+    }
+    // get_size falls back to COLUMNS/LINES or 80x24 off a terminal; this
+    // only guards against nonsense
+    auto [columns, rows] = terminal::get_size(fileno(out_));
+    if(columns == 0 || rows == 0 || columns > 10000 || rows > 10000)
+    {
+      return { default_columns, default_rows };
+    }
+    return { int(columns), int(rows) };
+  }
+auto TerminalView::refill() -> void
+  {
+    auto now  = clock::now();
+    auto dt   = std::chrono::duration<double>(now - refilled_).count();
+    refilled_ = now;
+    if(bandwidth_ > 0)
+    {
+      // at most a second's worth saved up
+      budget_ = std::min(budget_ + dt * double(bandwidth_), double(bandwidth_));
+    }
+  }
+auto TerminalView::scale(const uint32_t* _pixels, int _w, int _h, int _pitch, int _max_w, int _max_h) -> void
+  {
+    auto s  = std::min(double(_max_w) / _w, double(_max_h) / _h);
+    auto ow = std::clamp(int(_w * s), 1, _max_w);
+    auto oh = std::clamp(int(_h * s), 1, _max_h);
+    if(scaled_.width() != ow || scaled_.height() != oh)
+    {
+      scaled_.reset(ow, oh);
+    }
+    // average each output pixel's source area, composited over black
+    auto src = reinterpret_cast<const unsigned char*>(_pixels);
+    for(int y = 0; y < oh; ++y)
+    {
+      auto y1 = int(int64_t(y) * _h / oh);
+      auto y2 = std::max(y1 + 1, int(int64_t(y + 1) * _h / oh));
+      auto out = scaled_.row(y);
+      for(int x = 0; x < ow; ++x)
+      {
+        auto x1 = int(int64_t(x) * _w / ow);
+        auto x2 = std::max(x1 + 1, int(int64_t(x + 1) * _w / ow));
+        uint64_t r = 0, g = 0, b = 0;
+        for(auto sy = y1; sy < y2; ++sy)
+        {
+          auto line = reinterpret_cast<const uint32_t*>(src + std::size_t(sy) * std::size_t(_pitch));
+          for(auto sx = x1; sx < x2; ++sx)
+          {
+            auto c = Color::from_pixel(line[sx]);
+            r += uint64_t(c.r()) * c.a();
+            g += uint64_t(c.g()) * c.a();
+            b += uint64_t(c.b()) * c.a();
+          }
+        }
+        auto n = uint64_t(y2 - y1) * uint64_t(x2 - x1) * 255;
+        out[x] = Color { uint8_t(r / n), uint8_t(g / n), uint8_t(b / n) }.pixel();
+      }
+    }
+  }
+auto TerminalView::present(const uint32_t* _pixels, int _w, int _h, int _pitch) -> void
+  {
+    KT_TRACE_ZONE("terminal present", "gfx");
+    if(_w <= 0 || _h <= 0)
+    {
+      return;
+    }
+    refill();
+    auto [columns, rows] = terminal_size();
+    // the last line is left alone so drawing never scrolls the screen
+    rows = std::max(1, rows - 1);
+    if(mode_ == mode::half_block)
+    {
+      scale(_pixels, _w, _h, _pitch, columns, 2 * rows);
+      present_cells(scaled_.width(), (scaled_.height() + 1) / 2);
+    }
+    else
+    {
+      auto [px_w, px_h] = terminal::get_pixel_size(fileno(out_));
+      auto [all_columns, all_rows] = terminal_size();
+      auto cw = px_w > 0 && all_columns > 0? int(px_w) / all_columns : cell_width;
+      auto ch = px_h > 0 && all_rows > 0? int(px_h) / all_rows : cell_height;
+      scale(_pixels, _w, _h, _pitch, columns * std::max(cw, 1), rows * std::max(ch, 1));
+      present_sixel();
+    }
+    ++stats_.frames;
+  }
+auto TerminalView::present(const Surface& _s) -> void
+  {
+    present(_s.pixels(), _s.width(), _s.height(), _s.pitch());
+  }
+auto TerminalView::present(Renderer& _r, Texture& _t) -> void
+  {
+    auto size = _t.get_size();
+    if(readback_.width() != size.w || readback_.height() != size.h)
+    {
+      readback_.reset(size.w, size.h);
+    }
+    _r.set_target(_t);
+    sdl_assert(SDL_RenderReadPixels(_r.get(), NULL, SDL_PIXELFORMAT_RGBA32, readback_.pixels(), readback_.pitch()));
+    _r.set_default_target();
+    present(readback_);
+  }
+auto TerminalView::present_cells(int _columns, int _rows) -> void
+  {
+    if(clear_ || _columns != shown_columns_ || _rows != shown_rows_)
+    {
+      buffer_ += "\x1b[2J";
+      shown_.assign(std::size_t(_columns) * std::size_t(_rows), unknown);
+      shown_columns_  = _columns;
+      shown_rows_     = _rows;
+      resume_         = 0;
+      clear_          = false;
+    }
+    if(!started_)
+    {
+      buffer_ += "\x1b[?25l";
+      started_ = true;
+    }
+    auto cells  = shown_.size();
+    auto limit  = bandwidth_ > 0? std::size_t(std::max(0.0, budget_)) : std::size_t(-1);
+    auto fg     = unknown;
+    auto bg     = unknown;
+    auto last   = std::size_t(-1);
+    auto piece  = std::string {};
+    stats_.cells    = 0;
+    stats_.deferred = 0;
+    // start where the last capped frame stopped, so every part of the
+    // screen gets its turn
+    auto start  = resume_ < cells? resume_ : 0;
+    auto full   = false;
+    for(std::size_t n = 0; n < cells; ++n)
+    {
+      auto i      = (start + n) % cells;
+      auto x      = int(i % std::size_t(_columns));
+      auto y      = int(i / std::size_t(_columns));
+      auto top    = rgb(scaled_.row(2 * y)[x]);
+      auto bottom = 2 * y + 1 < scaled_.height()? rgb(scaled_.row(2 * y + 1)[x]) : 0u;
+      auto cell   = uint64_t(top) << 32 | bottom;
+      if(close(shown_[i], cell, tolerance_))
+      {
+        continue;
+      }
+      if(full)
+      {
+        ++stats_.deferred;
+        continue;
+      }
+      piece.clear();
+      if(i != last + 1 || x == 0)
+      {
+        piece += "\x1b[" + std::to_string(y + 1) + ';' + std::to_string(x + 1) + 'H';
+      }
+      if(top != fg)
+      {
+        append_color(piece, 38, top);
+      }
+      if(bottom != bg)
+      {
+        append_color(piece, 48, bottom);
+      }
+      piece += "▀";
+      if(buffer_.size() + piece.size() > limit)
+      {
+        full    = true;
+        resume_ = i;
+        ++stats_.deferred;
+        continue;
+      }
+      buffer_  += piece;
+      shown_[i] = cell;
+      fg        = top;
+      bg        = bottom;
+      last      = i;
+      ++stats_.cells;
+    }
+    if(stats_.cells > 0)
+    {
+      buffer_ += "\x1b[0m\x1b[" + std::to_string(_rows + 1) + ";1H";
+    }
+    if(!full)
+    {
+      resume_ = 0;
+    }
+    write();
+  }
+auto TerminalView::present_sixel() -> void
+  {
+    auto w      = scaled_.width();
+    auto h      = scaled_.height();
+    auto count  = std::size_t(w) * std::size_t(h);
+    // a 6 x 6 x 6 colour cube: no palette to build, and the same colours
+    // from frame to frame
+    auto frame  = std::vector<uint8_t>(count);
+    for(int y = 0; y < h; ++y)
+    {
+      auto row = scaled_.row(y);
+      for(int x = 0; x < w; ++x)
+      {
+        auto c = Color::from_pixel(row[x]);
+        frame[std::size_t(y) * std::size_t(w) + std::size_t(x)] = uint8_t((c.r() * 5 + 127) / 255 * 36 + (c.g() * 5 + 127) / 255 * 6 + (c.b() * 5 + 127) / 255);
+      }
+    }
+    stats_.cells    = 0;
+    stats_.deferred = 0;
+    if(!clear_ && frame == sixel_frame_)
+    {
+      return;
+    }
+    if(bandwidth_ > 0 && budget_ <= 0.0)
+    {
+      ++stats_.skipped;
+      return;
+    }
+    if(clear_)
+    {
+      buffer_ += "\x1b[2J";
+      shown_.clear();
+      shown_columns_  = 0;
+      shown_rows_     = 0;
+      clear_          = false;
+    }
+    if(!started_)
+    {
+      buffer_ += "\x1b[?25l";
+      started_ = true;
+    }
+    buffer_ += "\x1b[H\x1bPq\"1;1;" + std::to_string(w) + ';' + std::to_string(h);
+    std::array<bool, sixel_colors> used {};
+    for(auto c : frame)
+    {
+      used[c] = true;
+    }
+    for(int c = 0; c < sixel_colors; ++c)
+    {
+      if(used[std::size_t(c)])
+      {
+        buffer_ += '#' + std::to_string(c) + ";2;" + std::to_string(c / 36 * 20) + ';' + std::to_string(c / 6 % 6 * 20) + ';' + std::to_string(c % 6 * 20);
+      }
+    }
+    // each band is six pixel rows: one line of sixels per colour in it,
+    // the bits saying which of the six rows have that colour
+    sixel_bits_.resize(std::size_t(sixel_colors) * std::size_t(w));
+    std::vector<int> band_colors;
+    for(int y0 = 0; y0 < h; y0 += 6)
+    {
+      band_colors.clear();
+      std::array<bool, sixel_colors> in_band {};
+      for(int r = 0; r < 6 && y0 + r < h; ++r)
+      {
+        auto line = frame.data() + std::size_t(y0 + r) * std::size_t(w);
+        for(int x = 0; x < w; ++x)
+        {
+          auto c = line[x];
+          if(!in_band[c])
+          {
+            in_band[c] = true;
+            band_colors.push_back(c);
+            std::fill_n(sixel_bits_.data() + std::size_t(c) * std::size_t(w), w, uint8_t(0));
+          }
+          sixel_bits_[std::size_t(c) * std::size_t(w) + std::size_t(x)] |= uint8_t(1 << r);
+        }
+      }
+      for(std::size_t k = 0; k < band_colors.size(); ++k)
+      {
+        auto bits = sixel_bits_.data() + std::size_t(band_colors[k]) * std::size_t(w);
+        auto end  = w;
+        while(end > 0 && bits[end - 1] == 0)
+        {
+          --end;
+        }
+        buffer_ += '#' + std::to_string(band_colors[k]);
+        for(int x = 0; x < end; )
+        {
+          auto run = 1;
+          while(x + run < end && bits[x + run] == bits[x])
+          {
+            ++run;
+          }
+          append_run(buffer_, char(63 + bits[x]), run);
+          x += run;
+        }
+        buffer_ += k + 1 < band_colors.size()? '$' : '-';
+      }
+    }
+    buffer_ += "\x1b\\";
+    sixel_frame_.swap(frame);
+    stats_.cells = count;
+    write();
+  }
+auto TerminalView::write() -> void
+  {
+    if(buffer_.empty())
+    {
+      return;
+    }
+    std::fwrite(buffer_.data(), 1, buffer_.size(), out_);
+    std::fflush(out_);
+    stats_.bytes += buffer_.size();
+    if(bandwidth_ > 0)
+    {
+      budget_ -= double(buffer_.size());
+    }
+    buffer_.clear();
+  }
+auto TerminalView::stats() const -> counters
+  {
+    return stats_;
+  }
+} /* namespace gfx */
+} /* namespace kt */
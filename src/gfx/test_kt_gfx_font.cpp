@@ -0,0 +1,33 @@
+#include <gtest/gtest.h>
+#include <kt/gfx/font.hpp>
+#include <stdexcept>
+
+namespace {
+using kt::gfx::Color;
+using kt::gfx::Font;
+using kt::gfx::Surface;
+
+// 16 x 6 cells of 8 x 8, every glyph a solid block
+auto make_font() -> Font
+  {
+    return Font(Surface(128, 48, Color { 255, 255, 255, 255 }), Font::sheet_layout { 8, 8 });
+  }
+} /* namespace */
+
+TEST(kt_gfx_font, positive_size_lays_out)
+{
+  auto font = make_font();
+  EXPECT_GT(font.measure("AB", 16), font.measure("A", 16));
+  EXPECT_EQ(font.measure("AB", 16), font.measure("AB", 16));
+}
+TEST(kt_gfx_font, rejects_non_positive_size)
+{
+  auto font = make_font();
+  for(auto size : { 0, -1, -16 })
+  {
+    EXPECT_THROW(font.measure("A", size), std::runtime_error);
+    EXPECT_THROW(font.draw("A", 0.0f, 0.0f, size), std::runtime_error);
+    EXPECT_THROW(font.draw_paragraph("A B", 4, 0.0f, 0.0f, size), std::runtime_error);
+  }
+  EXPECT_EQ(font.stats().glyphs, 0u);
+}
@@ -4,18 +4,40 @@ namespace gfx  {
 Texture::Texture(Renderer& _r, int _w, int _h, Color _c, int _access)
   {
     reset(_r, _w, _h, _access);
+    clear(_r, _c);
+    set(SDL_BLENDMODE_BLEND);
+  }
+auto Texture::clear(Renderer& _r, Color _c) -> void
+  {
     _r.set_target(*this);
     _r.color(_c);
     _r.set_draw_blend(SDL_BLENDMODE_NONE);
     _r.clear();
     _r.set_draw_blend(SDL_BLENDMODE_BLEND);
-    set(SDL_BLENDMODE_BLEND);
   }
 Texture::Texture(Texture&& _src)
     : texture_(_src.texture_)
+    , renderer_(_src.renderer_)
+    , size_(_src.size_)
+    , format_(_src.format_)
+    , access_(_src.access_)
   {
     _src.texture_ = nullptr;
   }
+auto Texture::operator=(Texture&& _src) -> Texture&
+  {
+    if(this != &_src)
+    {
+      release();
+      texture_      = _src.texture_;
+      renderer_     = _src.renderer_;
+      size_         = _src.size_;
+      format_       = _src.format_;
+      access_       = _src.access_;
+      _src.texture_ = nullptr;
+    }
+    return *this;
+  }
 Texture::Texture(Renderer& _r, size _size, int _access)
     : Texture(_r, _size.w, _size.h, _access)
   {
@@ -28,7 +50,11 @@ Texture::Texture(Renderer& _r, const std::string& _path)
   {
     auto surface  = sdl_assert(SDL_LoadBMP(_path.c_str()));
     texture_      = sdl_assert(SDL_CreateTextureFromSurface(_r.get(), surface));
+    renderer_     = &_r;
+    _r.count_texture_created();
+    _r.count_upload(std::size_t(surface->h) * std::size_t(surface->pitch));
     SDL_FreeSurface(surface);
+    sdl_assert(SDL_QueryTexture(texture_, &format_, &access_, &size_.w, &size_.h));
   }
 Texture::~Texture()
   {
@@ -38,28 +64,60 @@ auto Texture::get() const -> SDL_Texture*
   {
     return texture_;
   }
-auto Texture::reset(Renderer& _r, int _w, int _h, int _access) -> void
+auto Texture::reset(Renderer& _r, int _w, int _h, int _access, uint32_t _format) -> void
   {
+    if(texture_ && renderer_ == &_r && size_.w == _w && size_.h == _h && access_ == _access && format_ == _format)
+    {
+      return;
+    }
     release();
-    texture_ = sdl_assert(SDL_CreateTexture(_r.get(), default_pixel_format, _access, _w, _h));
+    texture_  = sdl_assert(SDL_CreateTexture(_r.get(), _format, _access, _w, _h));
+    renderer_ = &_r;
+    renderer_->count_texture_created();
+    size_     = size { _w, _h };
+    format_   = _format;
+    access_   = _access;
   }
 auto Texture::release() -> void
   {
     if(texture_)
     {
+      if(renderer_)
+      {
+        renderer_->forget(texture_);
+      }
       SDL_DestroyTexture(texture_);
     }
-    texture_ = nullptr;
+    texture_  = nullptr;
+    size_     = size { 0, 0 };
+    format_   = SDL_PIXELFORMAT_UNKNOWN;
+    access_   = 0;
   }
 auto Texture::set(SDL_BlendMode _bm) -> void
   {
     sdl_assert(SDL_SetTextureBlendMode(texture_, _bm));
   }
+auto Texture::update(const void* _pixels, int _pitch, const SDL_Rect* _area) -> void
+  {
+    sdl_assert(SDL_UpdateTexture(texture_, _area, _pixels, _pitch));
+    if(renderer_)
+    {
+      auto rows = _area? _area->h : size_.h;
+      auto cols = _area? _area->w : size_.w;
+      renderer_->count_upload(std::size_t(rows) * std::size_t(cols) * SDL_BYTESPERPIXEL(format_));
+    }
+  }
 auto Texture::get_size() const -> size
   {
-    size sz;
-    sdl_assert(SDL_QueryTexture(texture_, NULL, NULL, &sz.w, &sz.h));
-    return sz;
+    return size_;
+  }
+auto Texture::format() const -> uint32_t
+  {
+    return format_;
+  }
+auto Texture::access() const -> int
+  {
+    return access_;
   }
 } /* namespace gfx */
 } /* namespace kt */
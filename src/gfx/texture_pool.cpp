@@ -0,0 +1,139 @@
+#include <kt/gfx/texture_pool.hpp>
+#include <kt/gfx/renderer.hpp>
+#include <algorithm>
+namespace kt {
+namespace gfx {
+TexturePool::lease::lease(TexturePool& _pool, Texture&& _t)
+    : pool_(&_pool)
+    , texture_(std::move(_t))
+  {
+    pool_->stats_.bytes_leased += bytes(texture_);
+  }
+TexturePool::lease::lease(lease&& _src)
+    : pool_(_src.pool_)
+    , texture_(std::move(_src.texture_))
+  {
+    _src.pool_ = nullptr;
+  }
+TexturePool::lease::~lease()
+  {
+    give_back();
+  }
+auto TexturePool::lease::operator=(lease&& _src) -> lease&
+  {
+    if(this != &_src)
+    {
+      give_back();
+      pool_ = _src.pool_;
+      _src.pool_ = nullptr;
+      texture_ = std::move(_src.texture_);
+    }
+    return *this;
+  }
+auto TexturePool::lease::give_back() -> void
+  {
+    if(pool_ && texture_.get())
+    {
+      pool_->stats_.bytes_leased -= bytes(texture_);
+      pool_->release(std::move(texture_));
+    }
+    pool_ = nullptr;
+  }
+
+auto TexturePool::key_hash::operator()(const key& _k) const -> std::size_t
+  {
+    auto h = std::hash<uint64_t>{}((uint64_t(uint32_t(_k.w)) << 32) | uint32_t(_k.h));
+    return h ^ (std::hash<uint64_t>{}((uint64_t(_k.format) << 8) | uint32_t(_k.access)) * 31);
+  }
+
+TexturePool::TexturePool(Renderer& _r, std::size_t _budget_bytes)
+    : renderer_(&_r)
+    , budget_(_budget_bytes)
+  {
+  }
+auto TexturePool::bytes(const Texture& _t) -> std::size_t
+  {
+    auto sz = _t.get_size();
+    return std::size_t(sz.w) * std::size_t(sz.h) * SDL_BYTESPERPIXEL(_t.format());
+  }
+auto TexturePool::key_of(const Texture& _t) -> key
+  {
+    auto sz = _t.get_size();
+    return key { sz.w, sz.h, _t.format(), _t.access() };
+  }
+auto TexturePool::acquire(int _w, int _h, int _access, uint32_t _format) -> Texture
+  {
+    auto found = idle_.find(key { _w, _h, _format, _access });
+    if(found != idle_.end() && !found->second.empty())
+    {
+      auto it = found->second.back();
+      found->second.pop_back();
+      Texture result(std::move(it->texture));
+      lru_.erase(it);
+      stats_.bytes_idle -= bytes(result);
+      ++stats_.hits;
+      return result;
+    }
+    ++stats_.misses;
+    Texture result;
+    result.reset(*renderer_, _w, _h, _access, _format);
+    return result;
+  }
+auto TexturePool::release(Texture&& _t) -> void
+  {
+    if(_t.get() == nullptr)
+    {
+      return;
+    }
+    auto k = key_of(_t);
+    stats_.bytes_idle += bytes(_t);
+    lru_.push_front(slot { k, std::move(_t) });
+    idle_[k].push_back(lru_.begin());
+    trim();
+  }
+auto TexturePool::lease_texture(int _w, int _h, int _access, uint32_t _format) -> lease
+  {
+    return lease(*this, acquire(_w, _h, _access, _format));
+  }
+auto TexturePool::set_budget(std::size_t _bytes) -> void
+  {
+    budget_ = _bytes;
+    trim();
+  }
+auto TexturePool::budget() const -> std::size_t
+  {
+    return budget_;
+  }
+auto TexturePool::evict_oldest() -> void
+  {
+    auto it = std::prev(lru_.end());
+    auto& bucket = idle_[it->k];
+    bucket.erase(std::find(bucket.begin(), bucket.end(), it));
+    stats_.bytes_idle -= bytes(it->texture);
+    ++stats_.evictions;
+    lru_.erase(it);
+  }
+auto TexturePool::trim() -> void
+  {
+    while(!lru_.empty() && stats_.bytes_resident() > budget_)
+    {
+      evict_oldest();
+    }
+  }
+auto TexturePool::clear() -> void
+  {
+    while(!lru_.empty())
+    {
+      evict_oldest();
+    }
+  }
+auto TexturePool::stats() const -> const counters&
+  {
+    return stats_;
+  }
+auto TexturePool::idle() const -> std::size_t
+  {
+    return lru_.size();
+  }
+} /* namespace gfx */
+} /* namespace kt */
@@ -0,0 +1,236 @@
+#include <kt/gfx/tilemap.hpp>
+#include <kt/gfx/renderer.hpp>
+#include <kt/gfx/sprite_batch.hpp>
+#include <kt/trace.hpp>
+#include <algorithm>
+#include <stdexcept>
+namespace kt {
+namespace gfx {
+TileMap::TileMap(TexturePool& _pool, int _w, int _h, int _tile_w, int _tile_h, int _chunk_tiles)
+    : pool_(&_pool)
+    , width_(_w)
+    , height_(_h)
+    , tile_w_(_tile_w)
+    , tile_h_(_tile_h)
+    , chunk_tiles_(_chunk_tiles)
+  {
+    if(_w <= 0 || _h <= 0 || _tile_w <= 0 || _tile_h <= 0 || _chunk_tiles <= 0)
+    {
+      throw std::runtime_error("tile map dimensions must be positive");
+    }
+    chunks_x_ = (_w + _chunk_tiles - 1) / _chunk_tiles;
+    chunks_y_ = (_h + _chunk_tiles - 1) / _chunk_tiles;
+    tiles_.assign(std::size_t(_w) * std::size_t(_h), none);
+    chunks_.resize(std::size_t(chunks_x_) * std::size_t(chunks_y_));
+  }
+auto TileMap::set_tileset(const Texture& _sheet) -> void
+  {
+    sheet_ = &_sheet;
+    for(auto& c : chunks_)
+    {
+      c.dirty = true;
+    }
+  }
+auto TileMap::set(int _x, int _y, tile_t _tile) -> void
+  {
+    if(_x < 0 || _y < 0 || _x >= width_ || _y >= height_)
+    {
+      return;
+    }
+    auto& t = tiles_[std::size_t(_y) * std::size_t(width_) + std::size_t(_x)];
+    if(t != _tile)
+    {
+      t = _tile;
+      chunks_[std::size_t(_y / chunk_tiles_) * std::size_t(chunks_x_) + std::size_t(_x / chunk_tiles_)].dirty = true;
+    }
+  }
+auto TileMap::get(int _x, int _y) const -> tile_t
+  {
+    if(_x < 0 || _y < 0 || _x >= width_ || _y >= height_)
+    {
+      return none;
+    }
+    return tiles_[std::size_t(_y) * std::size_t(width_) + std::size_t(_x)];
+  }
+auto TileMap::fill(const SDL_Rect& _area, tile_t _tile) -> void
+  {
+    auto x1 = std::max(_area.x, 0);
+    auto y1 = std::max(_area.y, 0);
+    auto x2 = std::min(_area.x + _area.w, width_);
+    auto y2 = std::min(_area.y + _area.h, height_);
+    for(auto y = y1; y < y2; ++y)
+    {
+      for(auto x = x1; x < x2; ++x)
+      {
+        set(x, y, _tile);
+      }
+    }
+  }
+auto TileMap::set_budget(std::size_t _bytes) -> void
+  {
+    budget_ = _bytes;
+  }
+auto TileMap::set_prefetch(int _margin_chunks, int _per_frame) -> void
+  {
+    margin_     = std::max(0, _margin_chunks);
+    per_frame_  = std::max(0, _per_frame);
+  }
+auto TileMap::chunk_pixels_w() const -> int
+  {
+    return chunk_tiles_ * tile_w_;
+  }
+auto TileMap::chunk_pixels_h() const -> int
+  {
+    return chunk_tiles_ * tile_h_;
+  }
+auto TileMap::chunk_bytes() const -> std::size_t
+  {
+    return std::size_t(chunk_pixels_w()) * std::size_t(chunk_pixels_h()) * SDL_BYTESPERPIXEL(default_pixel_format);
+  }
+auto TileMap::chunk_range(const SDL_Rect& _camera, int _margin) const -> SDL_Rect
+  {
+    auto floor_div = [](int _a, int _b) { return _a >= 0? _a / _b : -((-_a + _b - 1) / _b); };
+    auto x1 = std::max(0, floor_div(_camera.x, chunk_pixels_w()) - _margin);
+    auto y1 = std::max(0, floor_div(_camera.y, chunk_pixels_h()) - _margin);
+    auto x2 = std::min(chunks_x_, floor_div(_camera.x + _camera.w - 1, chunk_pixels_w()) + 1 + _margin);
+    auto y2 = std::min(chunks_y_, floor_div(_camera.y + _camera.h - 1, chunk_pixels_h()) + 1 + _margin);
+    return SDL_Rect { x1, y1, std::max(0, x2 - x1), std::max(0, y2 - y1) };
+  }
+auto TileMap::bake(Renderer& _r, std::size_t _index) -> void
+  {
+    KT_TRACE_ZONE("bake chunk", "gfx");
+    auto& c = chunks_[_index];
+    if(!c.baked)
+    {
+      c.baked.emplace(pool_->lease_texture(chunk_pixels_w(), chunk_pixels_h(), SDL_TEXTUREACCESS_TARGET));
+      (*c.baked)->set(SDL_BLENDMODE_BLEND);
+      resident_.push_back(_index);
+    }
+    (*c.baked)->clear(_r, Color::transparent());
+    if(sheet_)
+    {
+      auto sheet   = sheet_->get_size();
+      auto columns = std::max(1, sheet.w / tile_w_);
+      auto cx      = int(_index % std::size_t(chunks_x_)) * chunk_tiles_;
+      auto cy      = int(_index / std::size_t(chunks_x_)) * chunk_tiles_;
+      // the whole chunk goes out in one geometry call
+      SpriteBatch batch;
+      for(int y = 0; y < chunk_tiles_ && cy + y < height_; ++y)
+      {
+        for(int x = 0; x < chunk_tiles_ && cx + x < width_; ++x)
+        {
+          auto t = get(cx + x, cy + y);
+          if(t == none)
+          {
+            continue;
+          }
+          auto cell = int(t) - 1;
+          SDL_Rect  src  { (cell % columns) * tile_w_, (cell / columns) * tile_h_, tile_w_, tile_h_ };
+          SDL_FRect dest { float(x * tile_w_), float(y * tile_h_), float(tile_w_), float(tile_h_) };
+          batch.draw(*sheet_, src, dest);
+        }
+      }
+      batch.flush(_r);
+    }
+    c.dirty = false;
+    ++stats_.baked;
+  }
+auto TileMap::evict(std::size_t _index) -> void
+  {
+    chunks_[_index].baked.reset();
+    chunks_[_index].dirty = true;
+    ++stats_.evicted;
+  }
+auto TileMap::prepare(Renderer& _r, const SDL_Rect& _camera) -> void
+  {
+    KT_TRACE_ZONE("tilemap prepare", "gfx");
+    ++frame_;
+    stats_.baked = 0;
+    auto visible = chunk_range(_camera, 0);
+    for(auto y = visible.y; y < visible.y + visible.h; ++y)
+    {
+      for(auto x = visible.x; x < visible.x + visible.w; ++x)
+      {
+        auto index = std::size_t(y) * std::size_t(chunks_x_) + std::size_t(x);
+        chunks_[index].last_seen = frame_;
+        if(chunks_[index].dirty || !chunks_[index].baked)
+        {
+          bake(_r, index);
+        }
+      }
+    }
+    // chunks just outside the view, a few per frame, nearest rows first
+    auto ahead  = chunk_range(_camera, margin_);
+    auto budget = per_frame_;
+    for(auto y = ahead.y; y < ahead.y + ahead.h && budget > 0; ++y)
+    {
+      for(auto x = ahead.x; x < ahead.x + ahead.w && budget > 0; ++x)
+      {
+        auto index = std::size_t(y) * std::size_t(chunks_x_) + std::size_t(x);
+        auto& c = chunks_[index];
+        if(c.last_seen != frame_ && (c.dirty || !c.baked))
+        {
+          c.last_seen = frame_;
+          bake(_r, index);
+          --budget;
+        }
+      }
+    }
+    // release what the camera saw least recently until under budget; chunks
+    // seen this frame always stay
+    resident_.erase(std::remove_if(resident_.begin(), resident_.end(), [&](auto _i) { return !chunks_[_i].baked; }), resident_.end());
+    if(resident_.size() * chunk_bytes() > budget_)
+    {
+      std::sort(resident_.begin(), resident_.end(), [&](auto _a, auto _b)
+        {
+          return chunks_[_a].last_seen > chunks_[_b].last_seen;
+        });
+      while(resident_.size() * chunk_bytes() > budget_ && chunks_[resident_.back()].last_seen != frame_)
+      {
+        evict(resident_.back());
+        resident_.pop_back();
+      }
+    }
+    stats_.resident = resident_.size();
+  }
+auto TileMap::draw(Renderer& _r, const SDL_Rect& _camera, int _x, int _y) -> void
+  {
+    KT_TRACE_ZONE("tilemap draw", "gfx");
+    stats_.visible = 0;
+    auto visible = chunk_range(_camera, 0);
+    for(auto y = visible.y; y < visible.y + visible.h; ++y)
+    {
+      for(auto x = visible.x; x < visible.x + visible.w; ++x)
+      {
+        auto& c = chunks_[std::size_t(y) * std::size_t(chunks_x_) + std::size_t(x)];
+        if(!c.baked)
+        {
+          continue;
+        }
+        // only the part of the chunk inside the camera, so drawing into a
+        // viewport doesn't spill past its edges
+        auto left   = std::max(x * chunk_pixels_w(), _camera.x);
+        auto top    = std::max(y * chunk_pixels_h(), _camera.y);
+        auto right  = std::min((x + 1) * chunk_pixels_w(), _camera.x + _camera.w);
+        auto bottom = std::min((y + 1) * chunk_pixels_h(), _camera.y + _camera.h);
+        SDL_Rect src  { left - x * chunk_pixels_w(), top - y * chunk_pixels_h(), right - left, bottom - top };
+        SDL_Rect dest { _x + left - _camera.x, _y + top - _camera.y, right - left, bottom - top };
+        _r.copy(c.baked->get(), src, dest);
+        ++stats_.visible;
+      }
+    }
+  }
+auto TileMap::width() const -> int
+  {
+    return width_;
+  }
+auto TileMap::height() const -> int
+  {
+    return height_;
+  }
+auto TileMap::stats() const -> counters
+  {
+    return stats_;
+  }
+} /* namespace gfx */
+} /* namespace kt */
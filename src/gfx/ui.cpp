@@ -1,4 +1,5 @@
 #include <kt/gfx/ui.hpp>
+#include <kt/trace.hpp>
 #include <stdexcept>
 
 namespace kt {
@@ -27,19 +28,141 @@ auto UserInterface::init_view(int _w, int _h) -> View
   }
 auto UserInterface::start() -> void
   {
+    using clock = std::chrono::steady_clock;
+    auto seconds = [](clock::duration _d)
+      {
+        return std::chrono::duration<double>(_d).count();
+      };
     SDL_Event event;
     quit_app_ = false;
+    scheduler_.resync();
+    auto frame_start = clock::now();
     while(quit_app_ == false)
     {
-      while(SDL_PollEvent(&event))
+      KT_TRACE_ZONE("frame", "ui");
+      if(idle_ && !redraw_requested_ && !input_replay_)
+      {
+        KT_TRACE_ZONE("idle", "ui");
+        if(SDL_WaitEventTimeout(&event, idle_timeout_ms_))
+        {
+          handle(event);
+          redraw_requested_ = true;
+        }
+        scheduler_.resync();
+        // time spent waiting for input isn't part of the frame
+        frame_start = clock::now();
+      }
+      auto events_start = clock::now();
+      {
+        KT_TRACE_ZONE("events", "ui");
+        while(SDL_PollEvent(&event))
+        {
+          if(input_replay_ && !(event.type == SDL_WINDOWEVENT && event.window.event == SDL_WINDOWEVENT_CLOSE))
+          {
+            continue;
+          }
+          handle(event);
+          redraw_requested_ = true;
+        }
+        if(input_replay_)
+        {
+          if(input_replay_->next(replay_frame_))
+          {
+            for(const auto& e : replay_frame_.events)
+            {
+              handle(e);
+              redraw_requested_ = true;
+            }
+          }
+          else
+          {
+            input_replay_.reset();
+            quit();
+          }
+        }
+      }
+      auto update_start = clock::now();
+      auto updates = scheduler_.begin_frame();
+      if(input_replay_)
+      {
+        updates = replay_frame_.updates;
+      }
       {
-        handle(event);
+        KT_TRACE_ZONE("update", "ui");
+        for(int i = 0; i < updates; ++i)
+        {
+          on_update(scheduler_.step());
+        }
       }
-      view().renderer().set_default_target();
-      do_render();
-      view().renderer().present();
+      if(!idle_ || redraw_requested_)
+      {
+        redraw_requested_ = false;
+        auto render_start = clock::now();
+        {
+          KT_TRACE_ZONE("render", "ui");
+          view().renderer().set_default_target();
+          do_render();
+          recorder_.submit(view().renderer());
+          if(show_frame_stats_)
+          {
+            view().renderer().set_default_target();
+            frame_stats_.draw(view().renderer(), 8, 8);
+          }
+        }
+        // the only present in the frame, so the renderer's counters cover
+        // everything drawn since the last one, overlay included
+        auto present_start = clock::now();
+        view().renderer().present();
+        auto present_end = clock::now();
+        FrameStats::sample s;
+        s.events    = seconds(update_start - events_start);
+        s.update    = seconds(render_start - update_start);
+        s.render    = seconds(present_start - render_start);
+        s.present   = seconds(present_end - present_start);
+        s.frame     = seconds(present_end - frame_start);
+        s.counters  = view().renderer().frame_stats();
+        frame_stats_.record(s);
+        frame_start = present_end;
+      }
+      if(input_recorder_)
+      {
+        input_recorder_->end_frame(updates);
+      }
+      KT_TRACE_ZONE("pace", "ui");
+      scheduler_.end_frame();
     }
   }
+auto UserInterface::set_idle(bool _idle, int _timeout_ms) -> void
+  {
+    idle_             = _idle;
+    idle_timeout_ms_  = _timeout_ms;
+    redraw_requested_ = true;
+  }
+auto UserInterface::request_redraw() -> void
+  {
+    redraw_requested_ = true;
+  }
+auto UserInterface::show_frame_stats(bool _show) -> void
+  {
+    show_frame_stats_ = _show;
+  }
+auto UserInterface::record_input(const std::string& _filename) -> void
+  {
+    input_recorder_ = std::make_unique<InputRecorder>(_filename);
+  }
+auto UserInterface::replay_input(const std::string& _filename, InputReplay::pace _pace) -> void
+  {
+    input_replay_ = std::make_unique<InputReplay>(_filename, _pace);
+  }
+auto UserInterface::stop_input() -> void
+  {
+    input_recorder_.reset();
+    input_replay_.reset();
+  }
+auto UserInterface::interpolation_alpha() const -> double
+  {
+    return scheduler_.alpha();
+  }
 auto UserInterface::init_sdl() -> void
   {
     if(SDL_Init(SDL_INIT_VIDEO | SDL_INIT_GAMECONTROLLER | SDL_INIT_JOYSTICK) != 0)
@@ -49,6 +172,10 @@ auto UserInterface::init_sdl() -> void
   }
 auto UserInterface::handle(const SDL_Event& _event) -> void
   {
+    if(input_recorder_)
+    {
+      input_recorder_->event(_event);
+    }
     switch(_event.type)
     {
     case SDL_WINDOWEVENT:
@@ -85,6 +212,9 @@ auto UserInterface::on_window_event(const SDL_WindowEvent& _event) -> void
       break;
     }
   }
+auto UserInterface::on_update(double _dt) -> void
+  {
+  }
 auto UserInterface::do_render() -> void
   {
   }
@@ -1,15 +1,79 @@
 #include <kt/gfx/view.hpp>
+#include <kt/gfx/surface.hpp>
+#include <cstring>
 #include <stdexcept>
 #include <functional>
+#include <algorithm>
 namespace kt {
 namespace gfx {
+namespace {
+constexpr std::size_t max_damage_rects = 16;
+
+auto touches(const SDL_Rect& _a, const SDL_Rect& _b) -> bool
+  {
+    return _a.x <= _b.x + _b.w && _b.x <= _a.x + _a.w
+        && _a.y <= _b.y + _b.h && _b.y <= _a.y + _a.h;
+  }
+auto merge(const SDL_Rect& _a, const SDL_Rect& _b) -> SDL_Rect
+  {
+    auto x1 = std::min(_a.x, _b.x);
+    auto y1 = std::min(_a.y, _b.y);
+    auto x2 = std::max(_a.x + _a.w, _b.x + _b.w);
+    auto y2 = std::max(_a.y + _a.h, _b.y + _b.h);
+    return SDL_Rect { x1, y1, x2 - x1, y2 - y1 };
+  }
+// clip to the screen and fold touching rectangles together; past a handful
+// of rectangles the per-rect overhead beats the saved fill, so use the
+// bounding box instead
+auto coalesce(std::vector<SDL_Rect>& _rects, const SDL_Rect& _screen) -> void
+  {
+    std::vector<SDL_Rect> result;
+    for(auto r : _rects)
+    {
+      auto x1 = std::max(r.x, _screen.x);
+      auto y1 = std::max(r.y, _screen.y);
+      auto x2 = std::min(r.x + r.w, _screen.x + _screen.w);
+      auto y2 = std::min(r.y + r.h, _screen.y + _screen.h);
+      if(x2 <= x1 || y2 <= y1)
+      {
+        continue;
+      }
+      r = SDL_Rect { x1, y1, x2 - x1, y2 - y1 };
+      for(auto i = result.begin(); i != result.end(); )
+      {
+        if(touches(*i, r))
+        {
+          r = merge(*i, r);
+          result.erase(i);
+          i = result.begin();
+        }
+        else
+        {
+          ++i;
+        }
+      }
+      result.push_back(r);
+    }
+    if(result.size() > max_damage_rects)
+    {
+      auto box = result.front();
+      for(const auto& r : result)
+      {
+        box = merge(box, r);
+      }
+      result.assign(1, box);
+    }
+    _rects.swap(result);
+  }
+} /* namespace */
 View::View(int _w, int _h)
-    : window_(init_window(_w, _h))
-    , renderer_(window_)
+    : window_(init_window(_w, _h), SDL_DestroyWindow)
+    , renderer_(std::make_unique<Renderer>(window_.get()))
+    , texture_pool_(*renderer_)
     , width_(_w)
     , height_(_h)
   {
-    presentation_texture_.reset(renderer_, _w, _h);
+    reset_presentation_texture();
     //color(Color::black());
     //clear();
     //present();
@@ -18,16 +82,26 @@ View::View()
     : View(default_width_, default_height_)
   {
   }
-View::~View()
+View::View(headless_t, int _w, int _h)
+    : surface_(sdl_assert(SDL_CreateRGBSurfaceWithFormat(0, _w, _h, 32, SDL_PIXELFORMAT_RGBA32)), SDL_FreeSurface)
+    , renderer_(std::make_unique<Renderer>(surface_.get()))
+    , texture_pool_(*renderer_)
+    , width_(_w)
+    , height_(_h)
   {
-    if(window_)               { SDL_DestroyWindow(window_);     }
+    reset_presentation_texture();
   }
+View::~View() = default;
 auto View::update_window_size() -> void
   {
+    if(!window_)
+    {
+      return;
+    }
     std::tuple<int, int> result;
     auto& x = std::get<0>(result);
     auto& y = std::get<1>(result);
-    SDL_GetWindowSize(window_, &x, &y);
+    SDL_GetWindowSize(window_.get(), &x, &y);
     width_  = x;
     height_ = y;
   }
@@ -48,17 +122,21 @@ auto View::reset_presentation_texture() -> void
   {
     auto window_sz = size();
     presentation_texture_.reset 
-        ( renderer_
+        ( *renderer_
         , std::get<0>(window_sz)
         , std::get<1>(window_sz)
         , SDL_TEXTUREACCESS_TARGET
         );
+    // compose() only redraws damage, so start from the background rather
+    // than whatever the new texture holds
+    presentation_texture_.clear(*renderer_, background_);
+    renderer_->set_default_target();
   }
 auto View::init_renderer() -> SDL_Renderer*
   {
     return sdl_assert
       ( SDL_CreateRenderer
-        ( window_
+        ( window_.get()
         , -1
         , SDL_RENDERER_TARGETTEXTURE | SDL_RENDERER_ACCELERATED
         )
@@ -66,11 +144,11 @@ auto View::init_renderer() -> SDL_Renderer*
   }
 auto View::renderer() const -> const Renderer& 
   {
-    return renderer_;
+    return *renderer_;
   }
 auto View::renderer() -> Renderer& 
   {
-    return renderer_;
+    return *renderer_;
   }
 auto View::right_bottom() -> std::tuple<int, int>
   {
@@ -108,13 +186,156 @@ auto View::start_scene() -> void
   }
 auto View::stop_scene() -> void
   {
-    renderer_.set_default_target();
-    renderer_.copy(presentation_texture_);
-    renderer().present();
+    renderer_->set_default_target();
+    renderer_->copy(presentation_texture_);
+  }
+auto View::add_layer(Layer::render_fn _fn) -> Layer&
+  {
+    layers_.push_back(std::make_unique<Layer>(std::move(_fn)));
+    layers_changed_ = true;
+    return *layers_.back();
+  }
+auto View::remove_layer(Layer& _layer) -> void
+  {
+    auto found = std::find_if(layers_.begin(), layers_.end(), [&](const auto& _l) { return _l.get() == &_layer; });
+    if(found != layers_.end())
+    {
+      layers_.erase(found);
+      layers_changed_ = true;
+    }
+  }
+auto View::layer_count() const -> std::size_t
+  {
+    return layers_.size();
+  }
+auto View::set_background(Color _c) -> void
+  {
+    if(!(_c == background_))
+    {
+      background_     = _c;
+      layers_changed_ = true;
+    }
+  }
+auto View::last_damage() const -> const std::vector<SDL_Rect>&
+  {
+    return damage_;
+  }
+auto View::compose() -> void
+  {
+    auto old_size = size();
+    update_window_size();
+    SDL_Rect screen { 0, 0, width_, height_ };
+    auto resized = size() != old_size;
+    if(resized)
+    {
+      reset_presentation_texture();
+    }
+    damage_.clear();
+    for(auto& layer : layers_)
+    {
+      if(resized || layer->cache_.get() == nullptr)
+      {
+        layer->cache_.reset(*renderer_, width_, height_, SDL_TEXTUREACCESS_TARGET);
+        layer->cache_.set(SDL_BLENDMODE_BLEND);
+        layer->invalidate();
+      }
+      if(!layer->is_dirty())
+      {
+        continue;
+      }
+      if(layer->whole_)
+      {
+        layer->damage_.assign(1, screen);
+      }
+      coalesce(layer->damage_, screen);
+      renderer_->set_target(layer->cache_);
+      for(const auto& area : layer->damage_)
+      {
+        // SDL_RenderClear ignores the clip rectangle, so wipe with a fill
+        renderer_->set_clip(area);
+        renderer_->set_draw_blend(SDL_BLENDMODE_NONE);
+        renderer_->color(Color::transparent());
+        renderer_->fill_rect(area);
+        renderer_->set_draw_blend(SDL_BLENDMODE_BLEND);
+        layer->render_(*renderer_, area);
+      }
+      renderer_->clear_clip();
+      damage_.insert(damage_.end(), layer->damage_.begin(), layer->damage_.end());
+      if(layer->visibility_changed_)
+      {
+        damage_.push_back(screen);
+      }
+      layer->damage_.clear();
+      layer->whole_               = false;
+      layer->visibility_changed_  = false;
+    }
+    if(layers_changed_ || resized)
+    {
+      damage_.assign(1, screen);
+      layers_changed_ = false;
+    }
+    coalesce(damage_, screen);
+    if(!damage_.empty())
+    {
+      renderer_->set_target(presentation_texture_);
+      for(auto& area : damage_)
+      {
+        renderer_->set_clip(area);
+        renderer_->set_draw_blend(SDL_BLENDMODE_NONE);
+        renderer_->color(background_);
+        renderer_->fill_rect(area);
+        for(auto& layer : layers_)
+        {
+          if(layer->visible_)
+          {
+            renderer_->copy(layer->cache_, area, area);
+          }
+        }
+      }
+      renderer_->clear_clip();
+    }
+    renderer_->set_default_target();
+    renderer_->copy(presentation_texture_);
   }
 auto View::make_texture(int _w, int _h, int _access) -> Texture
   {
-    return Texture(renderer_, _w, _h, _access);
+    // same initial state as a freshly constructed texture
+    auto result = texture_pool_.acquire(_w, _h, _access);
+    result.clear(*renderer_, Color::transparent());
+    result.set(SDL_BLENDMODE_BLEND);
+    return result;
+  }
+auto View::lease_texture(int _w, int _h, int _access) -> TexturePool::lease
+  {
+    return texture_pool_.lease_texture(_w, _h, _access);
+  }
+auto View::texture_pool() -> TexturePool&
+  {
+    return texture_pool_;
+  }
+auto View::is_headless() const -> bool
+  {
+    return surface_ != nullptr;
+  }
+auto View::read_frame(Surface& _into) -> void
+  {
+    if(_into.width() != width_ || _into.height() != height_)
+    {
+      _into.reset(width_, height_);
+    }
+    if(surface_)
+    {
+      // already RGBA32 in memory; only the pitch may differ
+      auto row_bytes = std::size_t(width_) * sizeof(uint32_t);
+      auto src       = static_cast<const uint8_t*>(surface_->pixels);
+      for(int y = 0; y < height_; ++y)
+      {
+        std::memcpy(_into.row(y), src + std::size_t(y) * std::size_t(surface_->pitch), row_bytes);
+      }
+      return;
+    }
+    renderer_->set_default_target();
+    sdl_assert(SDL_RenderReadPixels(renderer_->get(), NULL, SDL_PIXELFORMAT_RGBA32, _into.pixels(), _into.pitch()));
   }
 
 } /* namespace gfx */
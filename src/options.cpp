@@ -16,6 +16,7 @@
   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 */
 #include <kt/options.hpp>
+#include <kt/trace.hpp>
 
 extern char** environ;
 
@@ -31,12 +32,14 @@ auto decorated(key_t _k) -> std::string
 
 auto parse(const std::string& _filename) -> arg_store
   {
+    KT_TRACE_ZONE("parse file", "options");
     using namespace std;
     auto file = std::fstream(_filename, ios::in);
     return parse(file);
   }
 auto parse(int argc, char* argv[]) -> arg_store
   {
+    KT_TRACE_ZONE("parse", "options");
     using namespace std;
     arg_store opts;
     arg_t     arg;
@@ -140,6 +143,7 @@ auto parse(int argc, char* argv[]) -> arg_store
   }
 auto scan(const arg_store& _args, const table& _opts) -> jobs
   {
+    KT_TRACE_ZONE("scan", "options");
     jobs results;
     // skip the first arg, since it's just the executable name
     auto arg = _args.begin();
@@ -190,6 +194,7 @@ auto count(const jobs& _jobs, key_t _key) -> size_t
   }
 auto run(const jobs& _jobs) -> void
   {
+    KT_TRACE_ZONE("run", "options");
     for(const auto& job : _jobs)
     {
       auto& do_action = job.second;
@@ -1,13 +1,29 @@
 #include <kt/terminal.hpp>
+#include <cstdlib>
 #include <sys/ioctl.h>
 #include <unistd.h>
 
 namespace kt::terminal {
 auto get_size() -> std::pair<size_t, size_t>
   {
-    struct winsize w;
-    ioctl(STDOUT_FILENO, TIOCGWINSZ, &w);
-    return std::make_pair(w.ws_col, w.ws_row);
+    return get_size(STDOUT_FILENO);
+  }
+auto get_size(int _fd) -> std::pair<size_t, size_t>
+  {
+    struct winsize w {};
+    if(ioctl(_fd, TIOCGWINSZ, &w) == 0 && w.ws_col > 0 && w.ws_row > 0)
+    {
+      return std::make_pair(w.ws_col, w.ws_row);
+    }
+    // not a terminal (piped, redirected, run by CI): take what the shell
+    // exported, else the traditional 80 by 24
+    auto from_env = [](const char* _name, size_t _fallback)
+      {
+        auto value = std::getenv(_name);
+        auto n     = value? std::strtoul(value, nullptr, 10) : 0ul;
+        return n > 0? size_t(n) : _fallback;
+      };
+    return std::make_pair(from_env("COLUMNS", 80), from_env("LINES", 24));
   }
 auto get_columns() -> size_t
   {
@@ -17,4 +33,17 @@ auto get_rows() -> size_t
   {
     return get_size().second;
   }
+auto get_pixel_size() -> std::pair<size_t, size_t>
+  {
+    return get_pixel_size(STDOUT_FILENO);
+  }
+auto get_pixel_size(int _fd) -> std::pair<size_t, size_t>
+  {
+    struct winsize w {};
+    if(ioctl(_fd, TIOCGWINSZ, &w) != 0)
+    {
+      return std::make_pair(size_t(0), size_t(0));
+    }
+    return std::make_pair(w.ws_xpixel, w.ws_ypixel);
+  }
 } /* namespace kt::terminal */
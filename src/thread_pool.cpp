@@ -0,0 +1,128 @@
+#include <kt/thread_pool.hpp>
+
+namespace kt {
+namespace {
+// which pool, if any, the calling thread works for
+thread_local const void*  current_pool  = nullptr;
+thread_local std::size_t  current_index = 0;
+} /* namespace */
+thread_pool::thread_pool(std::size_t _threads)
+  {
+    if(_threads == 0)
+    {
+      _threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for(std::size_t i = 0; i < _threads; ++i)
+    {
+      queues_.push_back(std::make_unique<task_queue>());
+    }
+    for(std::size_t i = 0; i < _threads; ++i)
+    {
+      workers_.emplace_back([this, i] { worker_loop(i); });
+    }
+  }
+thread_pool::~thread_pool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    wake_.notify_all();
+    for(auto& worker : workers_)
+    {
+      worker.join();
+    }
+  }
+auto thread_pool::size() const -> std::size_t
+  {
+    return workers_.size();
+  }
+auto thread_pool::home() const -> std::size_t
+  {
+    return current_pool == this? current_index : npos;
+  }
+auto thread_pool::submit(task _t) -> void
+  {
+    auto index = home();
+    if(index == npos)
+    {
+      index = next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    }
+    // count first, so `pending_` never drops below the tasks queued
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++pending_;
+    }
+    {
+      auto& q = *queues_[index];
+      std::lock_guard<std::mutex> lock(q.mutex);
+      q.tasks.push_back(std::move(_t));
+    }
+    wake_.notify_one();
+  }
+auto thread_pool::take(std::size_t _home, task& _t) -> bool
+  {
+    auto n     = queues_.size();
+    auto start = _home == npos? 0 : _home;
+    for(std::size_t i = 0; i < n; ++i)
+    {
+      auto& q = *queues_[(start + i) % n];
+      std::lock_guard<std::mutex> lock(q.mutex);
+      if(q.tasks.empty())
+      {
+        continue;
+      }
+      if(i == 0 && _home != npos)
+      {
+        _t = std::move(q.tasks.back());
+        q.tasks.pop_back();
+      }
+      else
+      {
+        _t = std::move(q.tasks.front());
+        q.tasks.pop_front();
+      }
+      return true;
+    }
+    return false;
+  }
+auto thread_pool::run_pending() -> bool
+  {
+    task next;
+    if(!take(home(), next))
+    {
+      return false;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      --pending_;
+    }
+    next();
+    return true;
+  }
+auto thread_pool::worker_loop(std::size_t _index) -> void
+  {
+    current_pool  = this;
+    current_index = _index;
+    while(true)
+    {
+      if(run_pending())
+      {
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(mutex_);
+      // a task counted in `pending_` may not be pushed yet; it will be
+      // shortly, so another look is worthwhile
+      wake_.wait(lock, [&] { return stopping_ || pending_ > 0; });
+      if(stopping_ && pending_ == 0)
+      {
+        return;
+      }
+    }
+  }
+auto thread_pool::shared() -> thread_pool&
+  {
+    static thread_pool pool;
+    return pool;
+  }
+} /* namespace kt */
@@ -0,0 +1,182 @@
+#include <kt/trace.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <vector>
+
+namespace kt::trace {
+namespace {
+struct event
+{
+  const char* name;
+  const char* category;
+  uint64_t    begin;
+  uint64_t    end;
+};
+// written only by its own thread; `written` is published with release
+// order so a dump sees whole events up to it.  `clear` never touches the
+// events or `written`, it only moves `cleared`, where dumps start from
+struct ring
+{
+  std::unique_ptr<event[]>  events { new event[ring_capacity] };
+  std::atomic<uint64_t>     written { 0 };
+  std::atomic<uint64_t>     cleared { 0 };
+  std::size_t               tid;
+  std::string               name;
+};
+struct registry
+{
+  std::mutex                          mutex;
+  std::vector<std::shared_ptr<ring>>  rings;
+  uint64_t                            base_ticks = 0;   //!< `now()` when tracing was last enabled...
+  uint64_t                            base_ns    = 0;   //!< ...and the clock at the same moment.
+};
+auto rings() -> registry&
+  {
+    static registry r;
+    return r;
+  }
+auto this_thread_ring() -> ring&
+  {
+    // rings stay registered after their thread exits, so its zones still
+    // make it into the dump
+    thread_local std::shared_ptr<ring> mine = []
+      {
+        auto r = std::make_shared<ring>();
+        auto& reg = rings();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        r->tid = reg.rings.size() + 1;
+        reg.rings.push_back(r);
+        return r;
+      }();
+    return *mine;
+  }
+auto write_escaped(std::ostream& _out, const std::string& _s) -> void
+  {
+    _out << '"';
+    for(auto ch : _s)
+    {
+      switch(ch)
+      {
+      case '"':   _out << "\\\""; break;
+      case '\\':  _out << "\\\\"; break;
+      case '\n':  _out << "\\n";  break;
+      default:
+        if(static_cast<unsigned char>(ch) < 0x20)
+        {
+          _out << ' ';
+        }
+        else
+        {
+          _out << ch;
+        }
+      }
+    }
+    _out << '"';
+  }
+// Chrome wants microseconds; keep the nanoseconds as three decimals
+auto write_micros(std::ostream& _out, double _ns) -> void
+  {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.3f", _ns / 1000.0);
+    _out << buffer;
+  }
+} /* namespace */
+
+auto detail::record(const char* _name, const char* _category, uint64_t _begin, uint64_t _end) -> void
+  {
+    auto& r = this_thread_ring();
+    auto n  = r.written.load(std::memory_order_relaxed);
+    r.events[n % ring_capacity] = event { _name, _category, _begin, _end };
+    r.written.store(n + 1, std::memory_order_release);
+  }
+auto enable(bool _on) -> void
+  {
+    if(_on)
+    {
+      auto& reg = rings();
+      std::lock_guard<std::mutex> lock(reg.mutex);
+      reg.base_ticks = detail::now();
+      reg.base_ns    = detail::clock_ns();
+    }
+    detail::active.store(_on, std::memory_order_relaxed);
+  }
+auto name_thread(const std::string& _name) -> void
+  {
+    auto& r = this_thread_ring();
+    std::lock_guard<std::mutex> lock(rings().mutex);
+    r.name = _name;
+  }
+auto dump(std::ostream& _out) -> void
+  {
+    auto& reg = rings();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    // scale ticks to nanoseconds over everything since tracing was enabled
+    auto ticks = detail::now() - reg.base_ticks;
+    auto ns    = detail::clock_ns() - reg.base_ns;
+    auto scale = ticks > 0? double(ns) / double(ticks) : 1.0;
+    auto to_ns = [&](uint64_t _t)
+      {
+        return double(reg.base_ns) + double(int64_t(_t - reg.base_ticks)) * scale;
+      };
+    _out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    auto first = true;
+    auto separator = [&]
+      {
+        if(!first)
+        {
+          _out << ",\n";
+        }
+        first = false;
+      };
+    for(const auto& r : reg.rings)
+    {
+      if(!r->name.empty())
+      {
+        separator();
+        _out << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << r->tid << ",\"args\":{\"name\":";
+        write_escaped(_out, r->name);
+        _out << "}}";
+      }
+      auto written = r->written.load(std::memory_order_acquire);
+      auto first   = std::max(r->cleared.load(std::memory_order_acquire), written - std::min<uint64_t>(written, ring_capacity));
+      for(auto i = first; i < written; ++i)
+      {
+        const auto& e = r->events[i % ring_capacity];
+        separator();
+        _out << "{\"ph\":\"X\",\"pid\":1,\"tid\":" << r->tid << ",\"name\":";
+        write_escaped(_out, e.name);
+        _out << ",\"cat\":";
+        write_escaped(_out, e.category);
+        _out << ",\"ts\":";
+        write_micros(_out, to_ns(e.begin));
+        _out << ",\"dur\":";
+        write_micros(_out, double(e.end - e.begin) * scale);
+        _out << '}';
+      }
+    }
+    _out << "]}\n";
+  }
+auto dump(const std::string& _filename) -> void
+  {
+    std::ofstream out(_filename);
+    if(!out)
+    {
+      throw std::runtime_error("could not open trace file \"" + _filename + "\"");
+    }
+    dump(out);
+  }
+auto clear() -> void
+  {
+    auto& reg = rings();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for(auto& r : reg.rings)
+    {
+      r->cleared.store(r->written.load(std::memory_order_acquire), std::memory_order_release);
+    }
+  }
+} /* namespace kt::trace */